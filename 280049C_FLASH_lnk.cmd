@@ -64,6 +64,9 @@ PAGE 1 :
    RAMGS1      : origin = 0x00E000, length = 0x002000
    RAMGS2      : origin = 0x010000, length = 0x002000
    RAMGS3      : origin = 0x012000, length = 0x002000
+
+   CLA1_MSGRAMLOW  : origin = 0x001480, length = 0x000080
+   CLA1_MSGRAMHIGH : origin = 0x001500, length = 0x000080
 }
 
 
@@ -94,6 +97,28 @@ SECTIONS
                          RUN_END(_RamfuncsRunEnd),
                          PAGE = 0, ALIGN(4)
 
+   /* CLA: LS4 program, LS6 shared data, LS7 CLA-only data (see src_cla.c) */
+    Cla1Prog    : LOAD = FLASH_BANK0_SEC5,
+                  RUN = RAMLS4,
+                  LOAD_START(_Cla1ProgLoadStart),
+                  LOAD_SIZE(_Cla1ProgLoadSize),
+                  RUN_START(_Cla1ProgRunStart),
+                  PAGE = 0, ALIGN(4)
+
+    .const_cla  : LOAD = FLASH_BANK0_SEC5, PAGE = 0,
+                  RUN = RAMLS7, PAGE = 1,
+                  LOAD_START(_Cla1ConstLoadStart),
+                  LOAD_SIZE(_Cla1ConstLoadSize),
+                  RUN_START(_Cla1ConstRunStart),
+                  ALIGN(4)
+
+   CLADataLS6       : > RAMLS6,    PAGE = 1
+   .scratchpad      : > RAMLS7,    PAGE = 1
+   .bss_cla         : > RAMLS7,    PAGE = 1
+
+   Cla1ToCpuMsgRAM  : > CLA1_MSGRAMLOW,   PAGE = 1
+   CpuToCla1MsgRAM  : > CLA1_MSGRAMHIGH,  PAGE = 1
+
 }
 
 /*
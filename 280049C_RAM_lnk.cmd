@@ -27,6 +27,9 @@ PAGE 1 :
    RAMGS1      : origin = 0x00E000, length = 0x002000
    RAMGS2      : origin = 0x010000, length = 0x002000
    RAMGS3      : origin = 0x012000, length = 0x002000
+
+   CLA1_MSGRAMLOW  : origin = 0x001480, length = 0x000080
+   CLA1_MSGRAMHIGH : origin = 0x001500, length = 0x000080
 }
 
 
@@ -34,7 +37,7 @@ SECTIONS
 {
    codestart        : > BEGIN,     PAGE = 0
    .TI.ramfunc      : > RAMM0      PAGE = 0
-   .text            : >>RAMM0 | RAMLS0 | RAMLS1 | RAMLS2 | RAMLS3 | RAMLS4,   PAGE = 0
+   .text            : >>RAMM0 | RAMLS0 | RAMLS1 | RAMLS2 | RAMLS3,   PAGE = 0
    .cinit           : > RAMM0,     PAGE = 0
    .pinit           : > RAMM0,     PAGE = 0
    .switch          : > RAMM0,     PAGE = 0
@@ -47,6 +50,16 @@ SECTIONS
 
    ramgs0           : > RAMGS0,    PAGE = 1
    ramgs1           : > RAMGS1,    PAGE = 1
+
+   /* CLA: LS4 program, LS6 shared data, LS7 CLA-only data (see src_cla.c) */
+   Cla1Prog         : > RAMLS4,    PAGE = 0
+   CLADataLS6       : > RAMLS6,    PAGE = 1
+   .scratchpad      : > RAMLS7,    PAGE = 1
+   .bss_cla         : > RAMLS7,    PAGE = 1
+   .const_cla       : > RAMLS7,    PAGE = 1
+
+   Cla1ToCpuMsgRAM  : > CLA1_MSGRAMLOW,   PAGE = 1
+   CpuToCla1MsgRAM  : > CLA1_MSGRAMHIGH,  PAGE = 1
 }
 
 /*
@@ -25,16 +25,116 @@
 /** BATTERY CONSTANTS **/
 #define V_BATTERY_MAX_LIMIT     7.95f       // [V]
 #define V_BATTERY_CHG_LIMIT     8.2f        // [V]
-#define V_BATTERY_MIN_LIMIT     6.0f        // [V]
+#define V_BATTERY_MIN_LIMIT     6.0f        // [V] every output is cut off under this
+#define V_BATTERY_CUTOFF_HYST   0.3f        // [V] over V_BATTERY_MIN_LIMIT before the outputs restart
 #define I_BATTERY_MAX_LIMIT     3.00f       // [A]
 #define I_BATTERY_MIN_LIMIT     (0.05 * I_BATTERY_MAX_LIMIT)  // [A]
+#define V_BATTERY_PRECHARGE     6.0f        // [V] below this the battery charges at I_BATTERY_PRECHARGE
+#define I_BATTERY_PRECHARGE     (0.1f * I_BATTERY_MAX_LIMIT)  // [A]
+#define V_BATTERY_STAGE_HYST    0.2f        // [V] below a stage's threshold before going back
+#define V_BATTERY_CV_BAND       0.05f       // [V] under V_BATTERY_CHG_LIMIT that counts as in CV
+#define V_BATTERY_OVP           8.4f        // [V] charge fault
+#define I_BATTERY_OCP           (1.5f * I_BATTERY_MAX_LIMIT)  // [A] charge fault
+#define V_BATTERY_SENSE_MARGIN  0.02f       // [V/V] of the divider's full scale a battery reading stays under to charge
 
 /** TIMER CONFIG **/
-#define PID_TIMER               CPUTIMER1_BASE
-#define PID_TIMER_INT           INT_TIMER1
-
 #define MPPT_TIMER              CPUTIMER2_BASE
 #define MPPT_TIMER_INT          INT_TIMER2
+#define TRACE_TIMER             CPUTIMER1_BASE      // free-running, no interrupt
+#define TRACE_TIMER_CLK         SYSCTL_PERIPH_CLK_TIMER1
+#define PV_LOOP_TIMER           CPUTIMER0_BASE
+#define PV_LOOP_TIMER_INT       INT_TIMER0
+
+
+/** ADC SAMPLING **/
+/*
+ * The MPPT and battery V/I pairs are converted simultaneously, the current
+ * on ADCA and the voltage on ADCB with the same SOC number and trigger. Each
+ * pair is started by an MPPT converter's ePWM in the middle of its on-time,
+ * where the inductor current and input capacitor voltage equal their
+ * switching-period average. The pairs take turns: within every
+ * ADC_PAIR_PRESCALE switching periods each lands in its own period (the
+ * _ADC_EVENT'th), so they never queue behind each other. The output bucks
+ * have ADCC to themselves.
+ *
+ * For ripple correlation (src/mppt_rcc.c) each MPPT pair is also sampled at
+ * its converter's turn-on, the peak of the input capacitor ripple, every
+ * ADC_RIPPLE_PRESCALE switching periods. A conversion takes 0.58us at
+ * ADC_CLK_DIV_4_0, so the ripple is sampled in equivalent time, one point of
+ * the period again and again, not several times within one period. The
+ * trackers' SOCBs sample the battery, so the turn-on SOCs come from the
+ * SOCB of the output buck switching 90 degrees behind each tracker, at 3/4
+ * of its period, in periods the other pairs leave free.
+ */
+#define ADC_PAIR_PRESCALE       10U         // switching periods per pair sample
+#define ADC_RIPPLE_PRESCALE     5U          // switching periods per turn-on sample of each MPPT pair
+#define ADC_PAIR_I_ADC          ADCA_BASE
+#define ADC_PAIR_I_RESULT       ADCARESULT_BASE
+#define ADC_PAIR_V_ADC          ADCB_BASE
+#define ADC_PAIR_V_RESULT       ADCBRESULT_BASE
+#define BUCK_ADC                ADCC_BASE
+#define BUCK_ADC_RESULT         ADCCRESULT_BASE
+
+
+/** ADC DMA **/
+/*
+ * The DMA ring averages each MPPT and battery channel over every MPPT period
+ * (ADC_RING_BLOCK samples). The averages keep ADC_OVERSAMPLE_BITS bits below
+ * the LSB: with the ADC noise dithering the samples, the mean of 50 resolves
+ * about a seventh of an LSB, which a rounded 12-bit mean throws away.
+ */
+#ifndef ADC_OVERSAMPLE_BITS
+#define ADC_OVERSAMPLE_BITS     4U          // fraction bits of the ring averages, 0 rounds to the LSB, 4 at most for 16 bits
+#endif
+#define ADC_RING_DMA_I          DMA_CH1_BASE        // ADC_PAIR_I_ADC results
+#define ADC_RING_DMA_V          DMA_CH2_BASE        // ADC_PAIR_V_ADC results
+#define ADC_RING_DMA_INT        INT_DMA_CH1
+#define ADC_RING_DMA_I_TRIGGER  DMA_TRIGGER_ADCA1
+#define ADC_RING_DMA_V_TRIGGER  DMA_TRIGGER_ADCB1
+#define ADC_RING_ADC_INT        ADC_INT_NUMBER1     // EOC of the last pair in each group
+#define ADC_RIPPLE_DMA_I        DMA_CH3_BASE        // ADC_PAIR_I_ADC turn-on results
+#define ADC_RIPPLE_DMA_V        DMA_CH4_BASE        // ADC_PAIR_V_ADC turn-on results
+#define ADC_RIPPLE_DMA_INT      INT_DMA_CH3
+#define ADC_RIPPLE_DMA_I_TRIGGER    DMA_TRIGGER_ADCA2
+#define ADC_RIPPLE_DMA_V_TRIGGER    DMA_TRIGGER_ADCB2
+#define ADC_RIPPLE_ADC_INT      ADC_INT_NUMBER2     // EOC of the last turn-on pair in each group
+
+
+/** TRACE **/
+/*
+ * Define USE_TRACE to timestamp the control ISRs and main loop tasks and
+ * count their overruns, see include/trace.h. Without it the TRACE_ macros
+ * compile to nothing.
+ */
+//#define USE_TRACE
+#define TRACE_RING_SIZE         256U        // entries, a power of 2
+
+
+/** KERNEL BENCHMARK **/
+/*
+ * Define USE_KERNEL_BENCH to time the control kernels with the ERAD cycle
+ * counter at boot instead of running the converters, see include/bench.h
+ */
+//#define USE_KERNEL_BENCH
+#define KBENCH_ITERATIONS       1000U
+
+
+/** NUMERIC BACKEND **/
+/*
+ * Define USE_FIXED_POINT (here or in the build's predefined symbols) to run
+ * the ADC scaling, compensators and MPPT arithmetic in Q24 fixed-point,
+ * see include/fixed_point.h
+ */
+//#define USE_FIXED_POINT
+
+/*
+ * USE_CLA runs the output buck loops as CLA tasks started by the buck ADC
+ * EOCs, see src/cla_tasks.cla. The CLA has no 64-bit integer type, so
+ * fixed-point builds keep the loops in the C28x ADC interrupts.
+ */
+#ifndef USE_FIXED_POINT
+#define USE_CLA
+#endif
 
 
 /** CONTROL LOOP CONSTANTS **/
@@ -44,16 +144,137 @@
 
 #define FREQUENCY_TO_US(FREQ)   (US_PER_SECOND / FREQ)
 #define PID_US                  FREQUENCY_TO_US(PID_FREQUENCY)
-
-#define KP                      3.2f
-#define KI                      2.1f
-#define KD                      2.3f
-
+#define PID_PERIOD_S            (1.0f / PID_FREQUENCY)  // [s]
+
+/* Output buck voltage loops: error in [V], output in [% duty] */
+#define BUCK_KP                 20.0f
+#define BUCK_KI                 2.0e5f      // [%/(V*s)]
+#define BUCK_KD                 2.0e-3f     // [%*s/V]
+#define BUCK_KD_TF              4.0e-6f     // [s] derivative filter
+#define BUCK_DUTY_MIN           0.0f        // [%]
+#define BUCK_DUTY_MAX           90.0f       // [%]
+#define BUCK_SOFT_START_S       0.002f      // [s] reference ramp of a restarted output from 0V
+#define BUCK_SOFT_START_STEP(V) CTL((V) * PID_PERIOD_S / BUCK_SOFT_START_S)     // [V per sample]
+
+/* MPPT algorithm of each PV input, see MPPT_STRATEGIES in include/mppt.h */
+#define MPPT_1_STRATEGY         Mppt_Incremental_Conductance
+#define MPPT_2_STRATEGY         Mppt_Incremental_Conductance
 #define MPPT_1_DELTA_DC         0.1f
 #define MPPT_1_DELTA_DC_MAX     5.0f
 #define MPPT_2_DELTA_DC         2.5f
 #define MPPT_2_DELTA_DC_MAX     5.0f
 
+/* Charger stages and limit loops, see src/battery.c. Timers count MPPT ticks */
+#define CHARGE_TICKS(S)         ((uint32_t)((S) * (float)(US_PER_SECOND / TIMER_500US)))
+#define CHARGE_TICK_S           ((float)TIMER_500US / US_PER_SECOND)    // [s]
+#define CHARGE_I_KP             2.0f        // [% duty per A] current limit loop
+#define CHARGE_I_KI             4000.0f     // [% duty per A*s]
+#define CHARGE_V_KP             10.0f       // [% duty per V] voltage limit loop
+#define CHARGE_V_KI             20000.0f    // [% duty per V*s]
+#define CHARGE_I_BAND           0.5f        // [A] under the current limit the proportional term brakes in
+#define CHARGE_V_BAND           0.2f        // [V] under the voltage limit
+#define CHARGE_DEBOUNCE_S       0.05f       // [s] a stage change has to be asked for
+#define CHARGE_TERM_S           2.0f        // [s] under I_BATTERY_MIN_LIMIT in CV before the battery is full
+#define CHARGE_FAULT_S          0.01f       // [s] over V_BATTERY_OVP, I_BATTERY_OCP or V_BATT_SENSE_MAX before a fault
+#define CHARGE_FAULT_RETRY_S    10.0f       // [s]
+#define CHARGE_PRECHARGE_MAX_S  1800.0f     // [s] precharge that does not reach V_BATTERY_PRECHARGE faults
+#define CHARGE_MAX_S            14400.0f    // [s] CC and CV that do not finish fault
+#define CHARGE_IR_COMP_MAX      0.1f        // [V] most the charger takes off the battery voltage for its resistance
+
+/* State of charge estimate, see src/soc.c */
+#define SOC_CAPACITY_AH         2.0f        // [Ah] of the pack, charged to 8.30V
+#define SOC_R_INT               0.08f       // [Ohm] of the pack, between its open-circuit and terminal voltage
+#define SOC_REST_I              0.2f        // [A] under this either way the battery rests, C/10
+#define SOC_REST_FILTER         0.004f      // of the current's change each MPPT tick, 125ms
+#define SOC_REST_S              30.0f       // [s] at rest before the open-circuit voltage corrects the count
+#define SOC_OCV_SHIFT           12U         // at rest each MPPT tick takes 1/2^n of the count's error off
+
+/* Battery internal resistance and state of health, see src/battery_ir.c */
+#define IR_R_NEW                SOC_R_INT   // [Ohm] of a new pack, where the fit starts
+#define IR_R_EOL                (2.0f * IR_R_NEW)   // [Ohm] at the end of the pack's life
+#define IR_DI_MIN               0.05f       // [A] change in current from one MPPT tick to the next to fit
+#define IR_FORGET               0.999f      // weight of the fit so far at each update
+#define IR_P_INIT               1.0f        // [1/A^2] covariance to start from, and the most it grows to
+
+/* Discharge protection and load shedding of the output bucks, see src/power_manager.c */
+#define POWER_MANAGER_ENABLE    true
+#define POWER_SHED_SOC          0.10f       // state of charge under which the 5V output is shed
+#define POWER_SHED_SOC_HYST     0.05f       // over POWER_SHED_SOC before it is restored
+#define POWER_SHED_MARGIN       0.3f        // [V] over V_BATTERY_MIN_LIMIT under which the 5V output is shed
+#define POWER_V_HYST            0.1f        // [V] over that before it is restored
+#define POWER_PV_SURPLUS_I      0.1f        // [A] into the battery with the outputs on, the PV carries them
+#define POWER_SHED_DEBOUNCE_S   0.01f       // [s] a shed or cutoff has to be asked for
+#define POWER_RESTORE_S         1.0f        // [s] a restore has to be asked for
+
+/* Both PV inputs charge the battery, see src/mppt_dual.c */
+#define MPPT_DUAL_MODE          Mppt_Dual_Interleaved
+#define MPPT_DUAL_CC_GAIN       2.0f        // [% duty per A] step allowed by the battery current headroom
+#define MPPT_DUAL_CV_GAIN       10.0f       // [% duty per V] step allowed by the battery voltage headroom
+
+/* Fast start from an open-circuit voltage snapshot, see src/mppt_start.c */
+#define MPPT_1_FAST_START       true
+#define MPPT_2_FAST_START       true
+#define MPPT_START_K_VOC        0.8f        // V_mpp / V_oc of the panels
+#define MPPT_START_SETTLE       4U          // [MPPT steps] converter off before Voc is read
+#define MPPT_START_V_MARGIN     1.0f        // [V] Voc above the battery voltage to start
+#define MPPT_START_APPROACH_STEPS   20U     // [MPPT steps] CC/CV can hold the duty cycle back
+#define MPPT_START_I_DARK       0.02f       // [A] panel current of a dark panel
+#define MPPT_START_DARK_STEPS   200U        // [MPPT steps] dark before the next start
+
+/*
+ * Panel voltage loops, see src/pv_loop.c. The MPPT moves a panel voltage
+ * reference, PV_LOOP_V_PER_DUTY per % of the duty cycle step it asks for
+ */
+#define PV_LOOP_1_ENABLE        true
+#define PV_LOOP_2_ENABLE        true
+#define PV_LOOP_RATE            10U         // loop runs per MPPT tick
+#define PV_LOOP_PERIOD_US       (TIMER_500US / PV_LOOP_RATE)    // [us]
+#define PV_LOOP_PERIOD_S        ((float)PV_LOOP_PERIOD_US / US_PER_SECOND)  // [s]
+#define PV_LOOP_C_IN            47e-6f      // [F] converter input capacitance
+#define PV_LOOP_V_KP            0.09f       // [A/V] about 300Hz with PV_LOOP_C_IN
+#define PV_LOOP_I_TRIM          1.0f        // [A] most the outer loop asks for beyond the panel current
+#define PV_LOOP_I_KP            1.8f        // [%/A] about 1kHz at 17V
+#define PV_LOOP_I_KI            1700.0f     // [%/(A*s)]
+#define PV_LOOP_D_TRIM          20.0f       // [%] most the inner loop moves the duty cycle off V_battery / V_ref
+#define PV_LOOP_V_LEAD          2.0f        // [V] furthest the reference runs ahead of the panel
+#define PV_LOOP_V_PER_DUTY      0.4f        // [V per % duty] V_mpp / D of a panel into the battery
+
+/* Settling-aware step rate and steady-state hold, see src/mppt_pace.c */
+#define MPPT_1_PACE             true
+#define MPPT_2_PACE             true
+#define MPPT_PACE_SETTLE_DV     0.1f        // [V] panel voltage drift across an ADC block that counts as settled
+#define MPPT_PACE_SETTLE_MAX    4U          // [MPPT steps] longest wait before a step is judged anyway
+#define MPPT_PACE_WINDOW        8U          // [strategy steps] looked at for an oscillation about the MPP
+#define MPPT_PACE_REVERSALS     3U          // changes of direction in a window that, with no net travel, start a hold
+#define MPPT_PACE_HOLD_MIN      16U         // [MPPT steps] first hold, doubled while the tracker keeps returning
+#define MPPT_PACE_HOLD_MAX      512U        // [MPPT steps]
+#define MPPT_PACE_RESUME        0.02f       // change in power, as a fraction of the held power, that ends a hold
+#define MPPT_PACE_RESUME_MIN    0.05f       // [W] smallest change in power that ends a hold
+
+/* Global maximum power point scan, see src/mppt_scan.c. An interval of 0 turns it off */
+#define MPPT_1_SCAN_INTERVAL    5000U       // [MPPT steps] 5s interleaved, 1ms per step
+#define MPPT_2_SCAN_INTERVAL    5000U       // [MPPT steps]
+#define MPPT_SCAN_POINTS        16U         // duty cycles on the coarse P-V curve
+#define MPPT_SCAN_DUTY_MIN      30.0f       // [%] near the open-circuit voltage
+#define MPPT_SCAN_DUTY_MAX      90.0f       // [%] change_pwm_duty_cycle() limit
+#define MPPT_SCAN_SETTLE        2U          // [MPPT steps] at each point, the last one is measured
+#define MPPT_SCAN_SLEW          5.0f        // [% duty] largest change per MPPT step
+
+/* Perturb and observe, see src/mppt_po.c */
+#define MPPT_PO_I_MIN           0.05f       // [A] below this the panel is not loaded yet
+
+/* Incremental conductance, see src/mppt_ic.c */
+#define MPPT_IC_GAIN            1.0f        // [% duty per W/V] step = gain * |dP/dV|
+#define MPPT_IC_STEP_MIN        0.05f       // [% duty]
+#define MPPT_IC_DV_MIN          0.01f       // [V] smaller panel voltage changes count as none
+#define MPPT_IC_DI_MIN          0.02f       // [A] irradiance change when the voltage did not move
+#define MPPT_IC_I_MIN           0.05f       // [A] below this the panel is not loaded yet
+
+/* Ripple correlation, see src/mppt_rcc.c */
+#define MPPT_RCC_GAIN           0.1f        // [% duty per W/V] step = -gain * p~ / MPPT_RCC_V_RIPPLE
+#define MPPT_RCC_V_RIPPLE       0.005f      // [V] panel voltage ripple at turn-on, about the mean, at full sun
+#define MPPT_RCC_I_MIN          0.05f       // [A] below this the panel is not loaded yet
+
 
 /** VOLTAGE DIVIDER COMPONENTS **/
 #define VOLTAGE_DIVDER(VS, R1, R2)  ((VS * R2) / (R1 + R2))
@@ -63,7 +284,9 @@
 #define V_PV_SENSE_R2           1000U   // [Ohms]
 
 #define V_BATT_SENSE_R1         100000U // [Ohms]
-#define V_BATT_SENSE_R2         100000U // [Ohms]
+#ifndef V_BATT_SENSE_R2
+#define V_BATT_SENSE_R2         100000U // [Ohms] 6.6V full scale
+#endif
 
 #define BUCK_5V_OUTPUT_R1       5110U   // [Ohms]
 #define BUCK_5V_OUTPUT_R2       5110U   // [Ohms]
@@ -73,8 +296,10 @@
 
 
 /** REFERENCE VOLTAGES **/
-#define V_BUCK_5V_REF           VOLTAGE_DIVDER(5.00, BUCK_5V_OUTPUT_R1, BUCK_5V_OUTPUT_R2)
-#define V_BUCK_3V3_REF          VOLTAGE_DIVDER(3.30, BUCK_3V3_OUTPUT_R1, BUCK_3V3_OUTPUT_R2)
+#define V_BUCK_5V_OUT           5.00f   // [V]
+#define V_BUCK_3V3_OUT          3.30f   // [V]
+#define V_BUCK_5V_REF           VOLTAGE_DIVDER(V_BUCK_5V_OUT, BUCK_5V_OUTPUT_R1, BUCK_5V_OUTPUT_R2)
+#define V_BUCK_3V3_REF          VOLTAGE_DIVDER(V_BUCK_3V3_OUT, BUCK_3V3_OUTPUT_R1, BUCK_3V3_OUTPUT_R2)
 
 
 /** CURRENT SENSING COMPONENT **/
@@ -83,7 +308,9 @@
 #define I_SENSE_SENS            400U    // [mV/A]
 #define I_SENSE_MAX             5.0f    // [A]
 #define I_SENSE_MIN             0.0f    // [A]
-#define I_SENSED(V_IOUT)        (((V_IOUT - V_IOUT_Q) / I_SENSE_SENS))    // [A]
+#define I_SENSED(V_IOUT)        ((((V_IOUT) - V_IOUT_Q) * 1000.0f) / I_SENSE_SENS)    // [A]
+#define I_SENSE_ZERO_TOL        0.1f    // [A] largest zero-current error trimmed at boot
+#define I_SENSE_CAL_SAMPLES     16U     // conversions averaged per sensor by the boot trim
 
 
 /** PINS & IDs **/
@@ -94,21 +321,49 @@
 
 #define BUCK_5V_ID              0U
 #define BUCK_5V_PWM             EPWM8_BASE
+#define BUCK_5V_PWM_PHASE       270U    // [deg] turn-on after MPPT_1_PWM's
+#define BUCK_5V_ADC_TRIGGER     ADC_TRIGGER_EPWM8_SOCA
+#define BUCK_5V_ADC_SOC         ADC_SOC_NUMBER0     // on BUCK_ADC
+#define BUCK_5V_ADC_INT         INT_ADCC1
+#define BUCK_5V_CLA_TASK        CLA_TASK_1
+#define BUCK_5V_CLA_TRIGGER     CLA_TRIGGER_ADCC1
 #define BUCK_5V_HI_PWM          14U // 61 - PWM8A
 #define BUCK_5V_LI_PWM          15U // 63 - PWM8B
 
 #define BUCK_3V3_ID             1U
 #define BUCK_3V3_PWM            EPWM7_BASE
+#define BUCK_3V3_PWM_PHASE      90U     // [deg] turn-on after MPPT_1_PWM's
+#define BUCK_3V3_ADC_TRIGGER    ADC_TRIGGER_EPWM7_SOCA
+#define BUCK_3V3_ADC_SOC        ADC_SOC_NUMBER1     // on BUCK_ADC
+#define BUCK_3V3_ADC_INT        INT_ADCC2
+#define BUCK_3V3_CLA_TASK       CLA_TASK_2
+#define BUCK_3V3_CLA_TRIGGER    CLA_TRIGGER_ADCC2
 #define BUCK_3V3_HI_PWM         12 // 57 - PWM7A
 #define BUCK_3V3_LI_PWM         13 // 59 - PWM7B
 
 #define MPPT_ONE_ID             2U
 #define MPPT_1_PWM              EPWM1_BASE
+#define MPPT_1_PWM_PHASE        0U      // [deg] sync master, the others are shifted from it
+#define MPPT_1_ADC_SOC          ADC_SOC_NUMBER0     // mid on-time, EPWM1 SOCA
+#define MPPT_1_ADC_TRIGGER      ADC_TRIGGER_EPWM1_SOCA
+#define MPPT_1_ADC_EVENT        ADC_PAIR_PRESCALE   // last in the group, starts the DMA
+#define MPPT_1_RIPPLE_PWM       BUCK_3V3_PWM        // 90 deg behind, SOCB at MPPT_1_PWM's turn-on
+#define MPPT_1_RIPPLE_SOC       ADC_SOC_NUMBER4
+#define MPPT_1_RIPPLE_TRIGGER   ADC_TRIGGER_EPWM7_SOCB
+#define MPPT_1_RIPPLE_EVENT     1U
 #define MPPT_1_HI_PWM           0U // 49 - PWM1A
 #define MPPT_1_LI_PWM           1U // 51 - PWM1B
 
 #define MPPT_TWO_ID             3U
 #define MPPT_2_PWM              EPWM2_BASE
+#define MPPT_2_PWM_PHASE        180U    // [deg] turn-on after MPPT_1_PWM's
+#define MPPT_2_ADC_SOC          ADC_SOC_NUMBER1     // mid on-time, EPWM2 SOCA
+#define MPPT_2_ADC_TRIGGER      ADC_TRIGGER_EPWM2_SOCA
+#define MPPT_2_ADC_EVENT        7U
+#define MPPT_2_RIPPLE_PWM       BUCK_5V_PWM         // 90 deg behind, SOCB at MPPT_2_PWM's turn-on
+#define MPPT_2_RIPPLE_SOC       ADC_SOC_NUMBER5
+#define MPPT_2_RIPPLE_TRIGGER   ADC_TRIGGER_EPWM8_SOCB
+#define MPPT_2_RIPPLE_EVENT     3U                  // last in the group, starts the ripple DMA
 #define MPPT_2_HI_PWM           2U // 53 - PWM2A
 #define MPPT_2_LI_PWM           3U // 55 - PWM2B
 
@@ -117,6 +372,25 @@
  *      Also look at src/src_adc.c
  **/
 
+/*
+ * The battery current is the sum of the MPPT inductor currents. It is
+ * sampled twice per group, mid on-time of each tracker (the SOCB of EPWM1
+ * and EPWM2, at CMPC), and read as the average of the two. Each sample has
+ * its own tracker's inductor at its average and the other's half a period
+ * away, off its average by its ripple slope times the difference in duty
+ * cycle. Into the same battery through the same inductance both ripples
+ * fall at the same slope, so the two errors cancel whatever the duty
+ * cycles, as long as both converters switch.
+ */
+#define BATT_ADC_PWM            MPPT_1_PWM
+#define BATT_ADC_SOC            ADC_SOC_NUMBER2
+#define BATT_ADC_TRIGGER        ADC_TRIGGER_EPWM1_SOCB
+#define BATT_ADC_EVENT          2U
+#define BATT_2_ADC_PWM          MPPT_2_PWM
+#define BATT_2_ADC_SOC          ADC_SOC_NUMBER3
+#define BATT_2_ADC_TRIGGER      ADC_TRIGGER_EPWM2_SOCB
+#define BATT_2_ADC_EVENT        4U
+
 #define BATT_V_SENSE            40U         // 40 - ADC
 #define BATT_I_SENSE            42U         // 42 - ADC
 
@@ -8,6 +8,11 @@
 #ifndef INCLUDE_BATTERY_H_
 #define INCLUDE_BATTERY_H_
 
+#include <stdint.h>
+#include <stdbool.h>
+#include "battery_ir.h"
+#include "soc.h"
+
 typedef enum {
     Supply,
     Charge
@@ -19,16 +24,36 @@ typedef enum {
     Not_Charging
 } eChargeSource;
 
+/** Charging stages, see src/battery.c */
 typedef enum {
     Charging_Inactive,
+    Precharge,              // deeply discharged, at I_BATTERY_PRECHARGE
     Continuous_Current,
     Continuous_Voltage,
-    Battery_Full
+    Float_Charge,           // held at V_BATTERY_MAX_LIMIT after a full charge, the PV supplies the loads
+    Battery_Full,           // converters off
+    Charge_Fault,           // converters off until CHARGE_FAULT_RETRY_S after the fault cleared
+    Charge_Stage_Count
 } eBatteryChargeType;
 
 typedef struct {
     eBatteryChargeType  cc_cv;
     eChargeSource       source;
+    bool                pi;             // false caps the MPPT in proportion to the error, without the PI loops
+    bool                ir_comp;        // takes the resistance's drop off the battery voltage
+    float               v_comp;         // [V] taken off this tick
+    float               i_limit;        // [A] of the stage
+    float               v_limit;        // [V] of the stage
+    float               i_error;        // [A] i_limit less the current at the last tick
+    float               v_error;        // [V]
+    float               headroom;       // [% duty] most an MPPT step may raise a duty cycle by this tick
+    eBatteryChargeType  pending;        // stage a condition has been asking for
+    uint32_t            held;           // [MPPT ticks] it has been asking
+    uint32_t            ticks;          // [MPPT ticks] in the stage
+    uint32_t            charge_ticks;   // [MPPT ticks] in CC and CV since the charge began
+    uint32_t            stage_ticks[Charge_Stage_Count];    // [MPPT ticks] in each stage, ever
+    uint32_t            transitions;
+    uint32_t            faults;
 } Charger_t;
 
 typedef struct {
@@ -36,13 +61,21 @@ typedef struct {
     float               current;
     eBatteryState       state;
     Charger_t           charger;
+    Soc_t               soc;
+    BatteryIr_t         ir;
 } Battery_t;
 
+extern const char * const charge_stage_names[Charge_Stage_Count];
+
 void init_battery(Battery_t * battery);
 
+void init_charger(Charger_t * charger, bool pi);
+
 void update_battery(Battery_t * battery);
 
-eBatteryChargeType determine_cc_cv(Battery_t battery);
+void update_charger(Battery_t * battery);
+
+bool charger_regulates(const Charger_t * charger);
 
 void determine_battery_state(Battery_t * battery);
 
@@ -0,0 +1,29 @@
+/*
+ * battery_ir.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Battery internal resistance and state of health, see src/battery_ir.c
+ */
+
+#ifndef INCLUDE_BATTERY_IR_H_
+#define INCLUDE_BATTERY_IR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** Recursive least squares fit of the battery's ohmic resistance */
+typedef struct {
+    float r;                    // [Ohm] estimate
+    float p;                    // [1/A^2] covariance of the estimate
+    float v_last;               // [V] battery voltage at the last tick
+    float i_last;               // [A]
+    float soh;                  // 0.0 - 1.0, from r between IR_R_NEW and IR_R_EOL
+    uint32_t updates;           // ticks the current changed enough to fit
+    bool primed;                // v_last and i_last hold a tick
+} BatteryIr_t;
+
+void battery_ir_init(BatteryIr_t * ir, float r);
+void battery_ir_update(BatteryIr_t * ir, float v, float i);
+
+#endif /* INCLUDE_BATTERY_IR_H_ */
@@ -0,0 +1,73 @@
+/*
+ * bench.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Kernel benchmark mode. With USE_KERNEL_BENCH, main() runs
+ *  bench_run_suite() with interrupts still off and the ePWM pins not yet
+ *  muxed, then parks. Each kernel is timed KBENCH_ITERATIONS times. Every
+ *  run goes into bench_results: min/max/total and a histogram of
+ *  power-of-two bins. Read bench_results from the debugger or from the
+ *  simulator's output. mppt_calculate() is timed once per registered MPPT
+ *  strategy.
+ *
+ *  The tick source is the timing backend below: the ERAD cycle counter on
+ *  the target (src/bench_erad.c, exact CPU cycles), the host clock in the
+ *  simulator (sim/bench_host.c, ns, only good for ranking). The cost of an
+ *  empty measurement is taken off every run.
+ */
+
+#ifndef INCLUDE_BENCH_H_
+#define INCLUDE_BENCH_H_
+
+#include <stdint.h>
+#include "config.h"
+#include "mppt.h"
+
+/** Benchmarked kernels, X(id, name) */
+#define BENCH_KERNELS(X)                                        \
+    X(Bench_PID_Calculate,          "pid_calculate")            \
+    X(Bench_Compensator_2P2Z,       "compensator_2p2z")         \
+    X(Bench_MPPT_Update_Values,     "mppt_update_values")       \
+    X(Bench_Update_Conversions,     "update_mppt_conversions")  \
+    X(Bench_Change_Duty_Cycle,      "change_pwm_duty_cycle")    \
+    X(Bench_SOC_Update,             "soc_update")               \
+    X(Bench_Battery_IR_Update,      "battery_ir_update")        \
+    X(Bench_ADC_Ring_Correlate,     "adc_ring_correlate")
+
+#define BENCH_KERNEL_ID(id, name)   id,
+
+typedef enum {
+    BENCH_KERNELS(BENCH_KERNEL_ID)
+    Bench_Kernel_Count
+} eBenchKernel;
+
+#define BENCH_HIST_BINS         33U     // bin 0: 0 ticks, bin k: [2^(k-1), 2^k)
+
+typedef struct {
+    uint32_t    runs;
+    uint32_t    min;            // [ticks]
+    uint32_t    max;            // [ticks]
+    uint32_t    total_lo;       // [ticks] sum of all runs
+    uint32_t    total_hi;
+    uint32_t    hist[BENCH_HIST_BINS];
+} BenchResult_t;
+
+typedef struct {
+    uint32_t        tick_hz;    // backend ticks per second
+    uint32_t        overhead;   // [ticks] empty measurement, already taken off
+    uint32_t        done;       // set when the suite has finished
+    BenchResult_t   kernel[Bench_Kernel_Count];
+    BenchResult_t   mppt_strategy[Mppt_Strategy_Count];    // mppt_calculate()
+} BenchResults_t;
+
+extern BenchResults_t bench_results;
+
+void bench_run_suite(uint32_t iterations);
+
+/***    T I M I N G   B A C K E N D    ***/
+void bench_timer_init(void);
+uint32_t bench_timer_read(void);
+uint32_t bench_timer_hz(void);
+
+#endif /* INCLUDE_BENCH_H_ */
@@ -0,0 +1,44 @@
+/*
+ * cla_shared.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Data shared between the C28x and the CLA. Included by both compilers, so
+ *  everything here has to be float32 or integer types up to 32 bits; the
+ *  struct layouts are the same on both sides.
+ *
+ *  cla_buck_cntl is loaded by the CPU before the tasks are enabled and is
+ *  only written by the CLA afterwards. cla_buck_status is written by the CLA
+ *  once per sample and is read-only for the CPU. cla_buck_command is
+ *  written by the CPU and read by the CLA each sample.
+ */
+
+#ifndef INCLUDE_CLA_SHARED_H_
+#define INCLUDE_CLA_SHARED_H_
+
+#include <stdint.h>
+#include "config.h"
+#include "compensator.h"
+
+#define CLA_BUCK_COUNT      2U      // indexed by BUCK_5V_ID / BUCK_3V3_ID
+
+typedef struct {
+    float       volts;          // [V] last output voltage sample
+    float       duty;           // [%] duty cycle written to CMPA:CMPAHR
+    uint32_t    runs;           // samples processed
+    uint16_t    adc_result;
+} ClaBuckStatus_t;
+
+typedef struct {
+    uint32_t    enable;         // 0 holds the buck off, see set_buck_output()
+} ClaBuckCommand_t;
+
+extern Compensator_t cla_buck_cntl[CLA_BUCK_COUNT];
+extern ClaBuckCommand_t cla_buck_command[CLA_BUCK_COUNT];
+extern ClaBuckStatus_t cla_buck_status[CLA_BUCK_COUNT];
+
+/***    C L A   T A S K S    ***/
+__interrupt void Cla1Task1(void);
+__interrupt void Cla1Task2(void);
+
+#endif /* INCLUDE_CLA_SHARED_H_ */
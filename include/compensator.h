@@ -0,0 +1,133 @@
+/*
+ * compensator.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Discrete-time 2P2Z/3P3Z compensators:
+ *
+ *      U(z)    b0 + b1 z^-1 + b2 z^-2 + b3 z^-3
+ *      ---- =  --------------------------------
+ *      E(z)    1  - a1 z^-1 - a2 z^-2 - a3 z^-3
+ *
+ *  The denominator coefficients are stored negated and the filter is run in
+ *  transposed direct form II: the output needs one multiply-add on the new
+ *  error, and the history terms for the next sample are accumulated after
+ *  the output has been produced. Coefficients are computed once by the init
+ *  functions; the run functions are inline so they can be called from the
+ *  ADC interrupts without call overhead.
+ *
+ *  With USE_FIXED_POINT the error and output are Q24 (see fixed_point.h),
+ *  the coefficients Q15 and the partial sums Q39 in an int64_t, so only the
+ *  output is rounded.
+ */
+
+#ifndef INCLUDE_COMPENSATOR_H_
+#define INCLUDE_COMPENSATOR_H_
+
+#include <stdint.h>
+#include "fixed_point.h"
+
+#ifdef USE_FIXED_POINT
+typedef int32_t comp_coef_t;    // Q15
+typedef int64_t comp_acc_t;     // Q39
+
+#define COMP_COEF(x)        Q15(x)
+#define COMP_MAC(c, x)      ((comp_acc_t)(c) * (comp_acc_t)(x))
+#define COMP_OUT(acc)       ((ctl_t)((acc) >> Q15_SHIFT))
+#else
+typedef float comp_coef_t;
+typedef float comp_acc_t;
+
+#define COMP_COEF(x)        ((float)(x))
+#define COMP_MAC(c, x)      ((c) * (x))
+#define COMP_OUT(acc)       (acc)
+#endif
+
+typedef struct {
+    comp_coef_t b0;
+    comp_coef_t b1;
+    comp_coef_t b2;
+    comp_coef_t b3;
+    comp_coef_t a1;         // stored negated
+    comp_coef_t a2;         // stored negated
+    comp_coef_t a3;         // stored negated
+    comp_acc_t  s1;         // partial sums for the next samples
+    comp_acc_t  s2;
+    comp_acc_t  s3;
+    comp_acc_t  u_min;      // output limits, in accumulator format
+    comp_acc_t  u_max;
+    ctl_t       ref;
+}Compensator_t;
+
+void compensator_init_pid(Compensator_t * cntl, float Kp, float Ki, float Kd, float Tf,
+                          float Ts, float ref, float u_min, float u_max);
+void compensator_init_3p3z(Compensator_t * cntl, const float b[4], const float a[3],
+                           float ref, float u_min, float u_max);
+void compensator_reset(Compensator_t * cntl, ctl_t u);
+void compensator_set_ref(Compensator_t * cntl, ctl_t ref);
+
+/**
+ * @brief Runs one sample of a 2P2Z compensator
+ *
+ * @details The output is clamped to [u_min, u_max] and the clamped value is
+ *      what is fed back, so the integrator cannot wind up while saturated.
+ *
+ * @return Controller output, e.g. duty cycle in %
+ */
+static inline ctl_t compensator_run_2p2z(Compensator_t * cntl, ctl_t actual_value) {
+    ctl_t e = cntl->ref - actual_value;
+    comp_acc_t acc = COMP_MAC(cntl->b0, e) + cntl->s1;
+    ctl_t u;
+
+    acc = (acc > cntl->u_max) ? cntl->u_max : acc;
+    acc = (acc < cntl->u_min) ? cntl->u_min : acc;
+    u = COMP_OUT(acc);
+
+    cntl->s1 = COMP_MAC(cntl->b1, e) + COMP_MAC(cntl->a1, u) + cntl->s2;
+    cntl->s2 = COMP_MAC(cntl->b2, e) + COMP_MAC(cntl->a2, u);
+    return u;
+}
+
+/**
+ * @brief Runs one sample of a 3P3Z compensator
+ *
+ * @return Controller output, clamped to [u_min, u_max]
+ */
+static inline ctl_t compensator_run_3p3z(Compensator_t * cntl, ctl_t actual_value) {
+    ctl_t e = cntl->ref - actual_value;
+    comp_acc_t acc = COMP_MAC(cntl->b0, e) + cntl->s1;
+    ctl_t u;
+
+    acc = (acc > cntl->u_max) ? cntl->u_max : acc;
+    acc = (acc < cntl->u_min) ? cntl->u_min : acc;
+    u = COMP_OUT(acc);
+
+    cntl->s1 = COMP_MAC(cntl->b1, e) + COMP_MAC(cntl->a1, u) + cntl->s2;
+    cntl->s2 = COMP_MAC(cntl->b2, e) + COMP_MAC(cntl->a2, u) + cntl->s3;
+    cntl->s3 = COMP_MAC(cntl->b3, e) + COMP_MAC(cntl->a3, u);
+    return u;
+}
+
+/**
+ * @brief Holds a compensator at rest, its output at u_min and its reference at 0
+ *
+ * @details compensator_reset() to u_min, inline for the buck loops while
+ *      their output is shed. The next compensator_ramp_ref() starts from 0.
+ */
+static inline void compensator_hold(Compensator_t * cntl) {
+    ctl_t u = COMP_OUT(cntl->u_min);
+
+    cntl->s3 = COMP_MAC(cntl->a3, u);
+    cntl->s2 = COMP_MAC(cntl->a2, u) + cntl->s3;
+    cntl->s1 = COMP_MAC(cntl->a1, u) + cntl->s2;
+    cntl->ref = 0;
+}
+
+/**
+ * @brief Moves the reference towards target by at most step, once per sample
+ */
+static inline void compensator_ramp_ref(Compensator_t * cntl, ctl_t target, ctl_t step) {
+    cntl->ref = ((target - cntl->ref) > step) ? (cntl->ref + step) : target;
+}
+
+#endif /* INCLUDE_COMPENSATOR_H_ */
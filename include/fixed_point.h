@@ -0,0 +1,88 @@
+/*
+ * fixed_point.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Numeric type for the measurement and control path, selected at build
+ *  time the same way IQmath's MATH_TYPE switch works.
+ *
+ *  USE_FIXED_POINT defined:
+ *      ctl_t is a signed Q24 in an int32_t, range [-128, 128) with a
+ *      resolution of 6e-8. Compensator coefficients are Q15 in an int32_t
+ *      and products are accumulated in an int64_t (Q39).
+ *
+ *  USE_FIXED_POINT not defined:
+ *      ctl_t is a float and the macros below are plain float arithmetic.
+ */
+
+#ifndef INCLUDE_FIXED_POINT_H_
+#define INCLUDE_FIXED_POINT_H_
+
+#include <stdint.h>
+#include "config.h"
+
+#define Q24_SHIFT           24
+#define Q24_ONE             16777216.0
+#define Q15_SHIFT           15
+#define Q15_ONE             32768.0
+
+/** Compile-time conversions, round to nearest */
+#define Q24(x)              ((int32_t)(((x) * Q24_ONE) + (((x) >= 0) ? 0.5 : -0.5)))
+#define Q15(x)              ((int32_t)(((x) * Q15_ONE) + (((x) >= 0) ? 0.5 : -0.5)))
+
+#ifndef __TMS320C28XX_CLA__
+/**
+ * @brief Q24 x Q24 multiply, truncated like _IQ24mpy()
+ *
+ * @details Not available to the CLA, which has no 64-bit integer type.
+ */
+static inline int32_t q24_mpy(int32_t a, int32_t b) {
+    return (int32_t)(((int64_t)a * (int64_t)b) >> Q24_SHIFT);
+}
+
+/**
+ * @brief Q24 / Q24 divide, saturated like _IQ24div()
+ *
+ * @details b must not be 0. Slow on the C28x (64-bit division in the RTS
+ *      library), keep it out of the fast loops.
+ */
+static inline int32_t q24_div(int32_t a, int32_t b) {
+    int64_t q = ((int64_t)a * (int64_t)(1L << Q24_SHIFT)) / (int64_t)b;
+    return (q > INT32_MAX) ? INT32_MAX : ((q < INT32_MIN) ? INT32_MIN : (int32_t)q);
+}
+#endif
+
+static inline float q24_to_f(int32_t a) {
+    return (float)a * (float)(1.0 / Q24_ONE);
+}
+
+static inline int32_t q24_from_f(float x) {
+    return Q24(x);
+}
+
+
+#ifdef USE_FIXED_POINT
+
+typedef int32_t ctl_t;          // Q24
+
+#define CTL(x)              Q24(x)
+#define CTL_MPY(a, b)       q24_mpy((a), (b))
+#define CTL_DIV(a, b)       q24_div((a), (b))
+#define CTL_TO_F(a)         q24_to_f(a)
+#define CTL_FROM_F(x)       q24_from_f(x)
+#define CTL_TO_Q24(a)       (a)
+
+#else
+
+typedef float ctl_t;
+
+#define CTL(x)              ((float)(x))
+#define CTL_MPY(a, b)       ((a) * (b))
+#define CTL_DIV(a, b)       ((a) / (b))
+#define CTL_TO_F(a)         (a)
+#define CTL_FROM_F(x)       (x)
+#define CTL_TO_Q24(a)       q24_from_f(a)
+
+#endif /* USE_FIXED_POINT */
+
+#endif /* INCLUDE_FIXED_POINT_H_ */
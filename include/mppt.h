@@ -10,29 +10,189 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "fixed_point.h"
 
 #define PV_HYSTERISIS       3.00    // [V]
 
+/** Registered MPPT algorithms, X(id, strategy) */
+#define MPPT_STRATEGIES(X)                                      \
+    X(Mppt_Perturb_Observe,         mppt_perturb_observe)       \
+    X(Mppt_Incremental_Conductance, mppt_inc_cond)            \
+    X(Mppt_Ripple_Correlation,      mppt_ripple_corr)
+
+#define MPPT_STRATEGY_ID(id, strategy)  id,
+
+typedef enum {
+    MPPT_STRATEGIES(MPPT_STRATEGY_ID)
+    Mppt_Strategy_Count
+} eMpptStrategy;
+
+/** Incremental conductance state */
+typedef struct {
+    float step;         // change in duty cycle returned last time
+} MpptIncCond_t;
+
+/**
+ * @brief Gains of the gradient strategies, per instance
+ *
+ * @details Set to the config.h values by mppt_init() and kept across the
+ *      strategies' init(), so they can be tuned at runtime like delta_d.
+ */
+typedef struct {
+    float ic;           // [% duty per W/V] MPPT_IC_GAIN
+    float rcc;          // [% duty per W/V] MPPT_RCC_GAIN
+} MpptGains_t;
+
+/** Ripple correlation state */
+typedef struct {
+    ctl_t p_ripple;     // [W] panel power ripple at turn-on across the last block
+    uint32_t blocks;    // blocks correlated with the panel loaded
+} MpptRcc_t;
+
+typedef enum {
+    Mppt_Scan_Idle,
+    Mppt_Scan_Approach,     // slewing to the first point
+    Mppt_Scan_Sweep,
+    Mppt_Scan_Return        // slewing to the best point
+} eMpptScanState;
+
+typedef enum {
+    Mppt_Start_Done,        // the strategy or a scan is tracking
+    Mppt_Start_Open,        // converter off until the panel settles at Voc
+    Mppt_Start_Wait,        // converter off, Voc too low to charge the battery
+    Mppt_Start_Approach     // moving to the operating point
+} eMpptStartState;
+
+/** Fast start from an open-circuit voltage snapshot, see src/mppt_start.c */
+typedef struct {
+    uint32_t pwm_base;
+    bool enabled;
+    eMpptStartState state;
+    uint32_t settle;        // MPPT steps the converter has been off
+    uint32_t dark;          // MPPT steps the panel current has been below MPPT_START_I_DARK
+    ctl_t voc;              // [V] last snapshot
+    float duty;             // [%] operating point of the last snapshot
+    uint32_t steps;         // MPPT steps spent approaching it
+    uint32_t starts;        // completed starts
+} MpptStart_t;
+
+typedef enum {
+    Mppt_Pace_Track,        // the strategy steps once the panel has settled
+    Mppt_Pace_Hold          // oscillating about the MPP, steps stopped
+} eMpptPaceState;
+
+/** Settling-aware step rate with a steady-state hold, see src/mppt_pace.c */
+typedef struct {
+    bool enabled;
+    eMpptPaceState state;
+    uint32_t seen;          // mppt->measurements at the last call
+    ctl_t v_ref;            // [V] measurements the pending step is judged against
+    ctl_t i_ref;            // [A]
+    ctl_t p_ref;            // [W]
+    uint32_t wait;          // MPPT steps waited for the panel voltage to settle
+    float last_step;        // [%] last change the strategy made
+    uint32_t window;        // strategy steps in the current window
+    uint32_t reversals;     // changes of direction in the window
+    float travel;           // [%] net change in duty cycle over the window
+    float step_max;         // [%] largest change in the window
+    ctl_t p_window;         // [W] when the window began
+    ctl_t p_hold;           // [W] when the hold began
+    uint32_t hold;          // [MPPT steps] left in the hold
+    uint32_t interval;      // [MPPT steps] length of the next hold
+    uint32_t steps;         // steps the strategy took
+    uint32_t waits;         // MPPT steps spent waiting to settle
+    uint32_t timeouts;      // steps judged at MPPT_PACE_SETTLE_MAX without settling
+    uint32_t holds;
+    uint32_t resumes;       // holds ended early by a change in power
+    uint32_t held;          // MPPT steps spent holding
+} MpptPace_t;
+
+/** Periodic global maximum power point scan, see src/mppt_scan.c */
+typedef struct {
+    ctl_t power[MPPT_SCAN_POINTS];  // [W] coarse P-V curve, point n at mppt_scan_duty(n)
+    uint32_t pwm_base;
+    uint32_t interval;      // [MPPT steps] between scans, 0 for none
+    uint32_t countdown;     // [MPPT steps] until the next scan
+    eMpptScanState state;
+    uint32_t point;         // points measured in this scan
+    uint32_t settle;        // MPPT steps spent at the current point
+    uint32_t steps;         // MPPT steps since the last point was measured
+    bool descending;        // sweeping from MPPT_SCAN_DUTY_MAX down
+    float target;           // [%] duty cycle being moved to
+    float start_duty;       // [%] where the tracker was when the scan began
+    ctl_t start_power;      // [W]
+    uint32_t scans;         // completed scans
+    uint32_t jumps;         // scans that moved the tracker to another peak
+    uint32_t aborts;        // scans that could not reach a point
+} MpptScan_t;
+
+typedef struct MPPT MPPT_t;
+
+/**
+ * @brief One MPPT algorithm
+ *
+ * @details init() resets the algorithm's state when it is selected, update()
+ *      takes the new measurements, step() returns the change in duty cycle.
+ *      A paced algorithm steps when mppt_pace() lets it, the others on every
+ *      call. The DMA ring only fits the V/I pairs of an input whose algorithm
+ *      reads get_mppt_ripple_*(), ripple set.
+ */
 typedef struct {
-    float v_result;     // [V]
-    float v_old;        // [V]
-    float i_result;     // [mA]
-    float i_old;        // [mA]
-    float power;        // [mW]
-    float power_old;    // [mW]
-    float delta_v;      // [V]
-    float delta_i;      // [mA]
-    float delta_p;      // [mW]
+    const char * name;
+    bool paced;
+    bool ripple;
+    void (*init)(MPPT_t * mppt);
+    void (*update)(MPPT_t * mppt);
+    float (*step)(MPPT_t * mppt);
+} MpptStrategy_t;
+
+struct MPPT {
+    ctl_t v_result;     // [V]
+    ctl_t v_old;        // [V]
+    ctl_t i_result;     // [A]
+    ctl_t i_old;        // [A]
+    ctl_t power;        // [W]
+    ctl_t power_old;    // [W]
+    ctl_t delta_v;      // [V]
+    ctl_t delta_i;      // [A]
+    ctl_t delta_p;      // [W]
+    uint32_t measurements;  // mppt_measure() calls
     float delta_d;      // change in duty cycle
     float delta_max;    // change in duty cycle to be used with CC/CV
+    MpptGains_t gains;
     uint32_t mppt_base; // MPPT instance identifier
-    bool suspended;     // for when PV voltage is too low
-    float suspended_v;  // [V] when PV was suspended
-}MPPT_t;
+    eMpptStrategy strategy_id;
+    const MpptStrategy_t * strategy;
+    union {
+        MpptIncCond_t inc_cond;
+        MpptRcc_t rcc;
+    } state;            // belongs to the selected strategy
+    MpptStart_t start;
+    MpptPace_t pace;
+    MpptScan_t scan;
+};
+
+#define MPPT_STRATEGY_EXTERN(id, strategy)  extern const MpptStrategy_t strategy;
+MPPT_STRATEGIES(MPPT_STRATEGY_EXTERN)
 
+extern const MpptStrategy_t * const mppt_strategies[Mppt_Strategy_Count];
 
-void mppt_init(MPPT_t * mppt, uint32_t mppt_base, float delta_d, float delta_max);
+void mppt_init(MPPT_t * mppt, uint32_t mppt_base, eMpptStrategy strategy, float delta_d, float delta_max);
+void mppt_set_strategy(MPPT_t * mppt, eMpptStrategy strategy);
 void mppt_update_values(MPPT_t * mppt);
 float mppt_calculate(MPPT_t * mppt);
+void mppt_measure(MPPT_t * mppt);
+bool mppt_overridden(const MPPT_t * mppt);
+
+void mppt_start_init(MPPT_t * mppt, uint32_t pwm_base, bool enabled);
+bool mppt_start(MPPT_t * mppt, float * delta);
+
+void mppt_pace_init(MPPT_t * mppt, bool enabled);
+bool mppt_pace(MPPT_t * mppt, float * delta);
+float mppt_pace_stepped(MPPT_t * mppt, float step);
+
+void mppt_scan_init(MPPT_t * mppt, uint32_t pwm_base, uint32_t interval);
+bool mppt_scan(MPPT_t * mppt, float * delta);
+float mppt_scan_duty(uint32_t point);
 
 #endif /* INCLUDE_MPPT_H_ */
@@ -0,0 +1,42 @@
+/*
+ * mppt_dual.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef INCLUDE_MPPT_DUAL_H_
+#define INCLUDE_MPPT_DUAL_H_
+
+#include <stdint.h>
+#include "battery.h"
+#include "mppt.h"
+#include "pv_loop.h"
+
+#define MPPT_DUAL_INPUTS        2U
+
+typedef enum {
+    Mppt_Dual_Independent,      // both trackers step every MPPT tick
+    Mppt_Dual_Interleaved,      // one tracker steps per MPPT tick, see src/mppt_dual.c
+    Mppt_Dual_Mode_Count
+} eMpptDualMode;
+
+/** Both PV inputs, charging the same battery */
+typedef struct {
+    MPPT_t * mppt[MPPT_DUAL_INPUTS];
+    uint32_t pwm_base[MPPT_DUAL_INPUTS];
+    PvLoop_t * loop[MPPT_DUAL_INPUTS];  // panel voltage loop of each input, NULL for none
+    eMpptDualMode mode;
+    uint32_t turn;                      // input whose duty cycle changes this tick
+    float pending[MPPT_DUAL_INPUTS];    // [% duty] step waiting for the input's turn
+    uint32_t limit_steps;               // steps the charger's headroom cut
+} MpptDual_t;
+
+extern const char * const mppt_dual_mode_names[Mppt_Dual_Mode_Count];
+
+void mppt_dual_init(MpptDual_t * dual, MPPT_t * one, uint32_t pwm_one,
+                    MPPT_t * two, uint32_t pwm_two, eMpptDualMode mode);
+void mppt_dual_set_mode(MpptDual_t * dual, eMpptDualMode mode);
+void mppt_dual_set_loops(MpptDual_t * dual, PvLoop_t * one, PvLoop_t * two);
+void mppt_dual_step(MpptDual_t * dual, const Battery_t * battery);
+
+#endif /* INCLUDE_MPPT_DUAL_H_ */
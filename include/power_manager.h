@@ -0,0 +1,39 @@
+/*
+ * power_manager.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Discharge protection and load shedding of the output bucks, see
+ *  src/power_manager.c
+ */
+
+#ifndef INCLUDE_POWER_MANAGER_H_
+#define INCLUDE_POWER_MANAGER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "battery.h"
+
+/** How many outputs are shed, in power_shed_order */
+typedef enum {
+    Power_All_On,
+    Power_Shed,             // the lowest priority output is off
+    Power_Cutoff,           // every output is off, under V_BATTERY_MIN_LIMIT
+    Power_Level_Count
+} ePowerLevel;
+
+typedef struct {
+    bool            enabled;        // false leaves every output on
+    ePowerLevel     level;
+    ePowerLevel     pending;        // level a condition has been asking for
+    uint32_t        held;           // [MPPT ticks] it has been asking
+    uint32_t        level_ticks[Power_Level_Count];     // [MPPT ticks] at each level, ever
+    uint32_t        transitions;
+} PowerManager_t;
+
+extern const char * const power_level_names[Power_Level_Count];
+
+void init_power_manager(PowerManager_t * power, bool enabled);
+void update_power_manager(PowerManager_t * power, const Battery_t * battery);
+
+#endif /* INCLUDE_POWER_MANAGER_H_ */
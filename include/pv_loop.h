@@ -0,0 +1,43 @@
+/*
+ * pv_loop.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Panel voltage loops of the PV converters, see src/pv_loop.c
+ */
+
+#ifndef INCLUDE_PV_LOOP_H_
+#define INCLUDE_PV_LOOP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "compensator.h"
+#include "fixed_point.h"
+
+/** Panel voltage reference tracked by an average-current inner loop */
+typedef struct {
+    uint32_t mppt_id;           // MPPT_ONE_ID or MPPT_TWO_ID, selects the V/I pair
+    uint32_t pwm_base;
+    bool enabled;
+    volatile bool engaged;      // the loop writes the duty cycle, not the MPPT
+    Compensator_t v_cntl;       // panel voltage -> converter input current [A]
+    Compensator_t i_cntl;       // converter input current -> duty cycle trim [%]
+    ctl_t v_ref;                // [V]
+    ctl_t duty_ff;              // [%] duty cycle a lossless buck runs at v_ref
+    ctl_t v_last;               // [V] panel voltage at the last run
+    ctl_t i_in;                 // [A] converter input current at the last run
+    uint32_t runs;
+    uint32_t engages;           // times the loop took over from the MPPT's duty cycle
+} PvLoop_t;
+
+void pv_loop_init(PvLoop_t * loop, uint32_t mppt_id, uint32_t pwm_base, bool enabled);
+void init_pv_loops(PvLoop_t * one, PvLoop_t * two);
+void pv_loop_engage(PvLoop_t * loop, ctl_t v_ref);
+void pv_loop_release(PvLoop_t * loop);
+void pv_loop_move_ref(PvLoop_t * loop, float dv);
+void pv_loop_run(PvLoop_t * loop);
+
+/***    I N T E R R U P T S    ***/
+__interrupt void pv_loop_irq(void);
+
+#endif /* INCLUDE_PV_LOOP_H_ */
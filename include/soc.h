@@ -0,0 +1,33 @@
+/*
+ * soc.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Battery state of charge estimate, see src/soc.c
+ */
+
+#ifndef INCLUDE_SOC_H_
+#define INCLUDE_SOC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixed_point.h"
+
+/** Coulomb count, corrected from the open-circuit voltage at rest */
+typedef struct {
+    int64_t charge;             // [Q24 A * MPPT ticks] in the battery
+    int64_t capacity;           // [Q24 A * MPPT ticks]
+    float fraction;             // 0.0 - 1.0, charge over capacity
+    ctl_t i_avg;                // [A] filtered with SOC_REST_FILTER, for the rest
+    uint32_t rest_ticks;        // [MPPT ticks] under SOC_REST_I in a row
+    uint32_t corrections;       // [MPPT ticks] the open-circuit voltage corrected the count
+    bool seeded;                // the count started from the open-circuit voltage
+} Soc_t;
+
+void soc_init(Soc_t * soc, float capacity_ah);
+void soc_update(Soc_t * soc, ctl_t v, ctl_t i);
+void soc_set_full(Soc_t * soc);
+float soc_ocv_fraction(ctl_t v, ctl_t i);
+float soc_energy(const Soc_t * soc);
+
+#endif /* INCLUDE_SOC_H_ */
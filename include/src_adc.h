@@ -10,6 +10,8 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "compensator.h"
+#include "fixed_point.h"
 
 #define MPPT_ADC_EVT_COUNT  6
 #define MPPT_ONE_V_ADC_EVT  5
@@ -28,23 +30,67 @@
 #define MPPT_SHUNT_R        0.1f    // 100mOhms
 #define BATTERY_IN_SHUNT_R  0.1f    // 100mOhms
 
+/** Per-LSB scaling for adc_scale(), constant expressions */
+#define ADC_V_PER_LSB                   (VREFHI_V / ADC_MAX_VALUE_F)
+#define ADC_VOLTAGE_SCALE(R1, R2)       CTL(VOLTAGE_UNDIVIDER(ADC_V_PER_LSB, R1, R2))
+#define ADC_CURRENT_SCALE               CTL(I_SENSED(ADC_V_PER_LSB) - I_SENSED(0.0f))
+#define ADC_CURRENT_OFFSET              CTL(I_SENSED(0.0f))
+#define ADC_RING_V_PER_LSB              (ADC_V_PER_LSB / (float)(1U << ADC_OVERSAMPLE_BITS))
+
+/** Battery readings past V_BATT_SENSE_MAX may be clipped by the divider */
+#define V_BATT_SENSE_FULL_SCALE         VOLTAGE_UNDIVIDER(VREFHI_V, V_BATT_SENSE_R1, V_BATT_SENSE_R2)   // [V]
+#define V_BATT_SENSE_MAX                ((1.0f - V_BATTERY_SENSE_MARGIN) * V_BATT_SENSE_FULL_SCALE)     // [V]
+
 void init_adc();
+void init_buck_control(Compensator_t * five_volt_cntl, Compensator_t * three_volt_cntl);
+void adc_calibrate_current_offsets(void);
+void set_buck_output(uint32_t buck_id, bool on);
+void set_mppt_ripple(uint32_t mppt_base, bool on);
 
 /***    G E T S    ***/
 float get_buck_v(uint32_t buck_base);
 float get_mppt_v(uint32_t mppt_base);
 float get_mppt_i(uint32_t mppt_base);
+ctl_t get_mppt_v_ctl(uint32_t mppt_base);
+ctl_t get_mppt_i_ctl(uint32_t mppt_base);
+ctl_t get_mppt_v_drift_ctl(uint32_t mppt_base);
+ctl_t get_mppt_v_sample_ctl(uint32_t mppt_base);
+ctl_t get_mppt_i_sample_ctl(uint32_t mppt_base);
+ctl_t get_mppt_ripple_i_ctl(uint32_t mppt_base);
+ctl_t get_mppt_ripple_v_ctl(uint32_t mppt_base);
 float get_battery_v(void);
 float get_battery_i(void);
+ctl_t get_battery_v_ctl(void);
+ctl_t get_battery_i_ctl(void);
 bool is_mppt_adc_done(void);
 
 /***    C O N V E R S I O N S   ***/
 uint32_t adc_convert_to_mv(uint32_t adc_result);
 float adc_convert_to_v(uint32_t adc_result);
-void update_output_buck_conversions(void);
 void update_mppt_conversions(void);
 void update_battery_conversions(void);
 
+/**
+ * @brief Scales a raw ADC result by a per-LSB gain and adds an offset
+ */
+static inline ctl_t adc_scale(uint16_t adc_result, ctl_t gain, ctl_t offset) {
+    return ((ctl_t)adc_result * gain) + offset;
+}
+
+/**
+ * @brief adc_scale() of a DMA ring average, in 1/2^ADC_OVERSAMPLE_BITS LSB
+ *
+ * @details The gain stays per LSB: in Q24 a gain per ring count would lose
+ *      a quarter of an LSB at full scale, so the product is shifted instead.
+ */
+static inline ctl_t adc_scale_ring(uint16_t ring_result, ctl_t gain, ctl_t offset) {
+#ifdef USE_FIXED_POINT
+    return (ctl_t)(((int64_t)ring_result * gain) >> ADC_OVERSAMPLE_BITS) + offset;
+#else
+    return ((ctl_t)ring_result * (gain * (1.0f / (float)(1U << ADC_OVERSAMPLE_BITS)))) + offset;
+#endif
+}
+
 /***    G E T S    ***/
 float get_buck_v(uint32_t buck_base);
 float get_mppt_v(uint32_t mppt_base);
@@ -55,10 +101,10 @@ float get_battery_i(void);
 /***    I N T E R R U P T S    ***/
 
 /*
- * ADCA1 - INT1.1           ADCB1 - INT1.2
- * ADCA2 - INT10.2          ADCB2 - INT10.6
- * ADCA3 - INT10.3          ADCB3 - INT10.7
- * ADCA4 - INT10.4          ADCB4 - INT10.8
+ * ADCA1 - INT1.1           ADCB1 - INT1.2          ADCC1 - INT1.3
+ * ADCA2 - INT10.2          ADCB2 - INT10.6         ADCC2 - INT10.10
+ * ADCA3 - INT10.3          ADCB3 - INT10.7         ADCC3 - INT10.11
+ * ADCA4 - INT10.4          ADCB4 - INT10.8         ADCC4 - INT10.12
  */
 __interrupt void adc_buck_5V_irq(void);
 __interrupt void adc_buck_3V3_irq(void);
@@ -0,0 +1,16 @@
+/*
+ * src_cla.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef INCLUDE_SRC_CLA_H_
+#define INCLUDE_SRC_CLA_H_
+
+#include "compensator.h"
+
+/***    I N I T S    ***/
+void init_cla(void);
+void init_cla_buck_control(const Compensator_t * five_volt_cntl, const Compensator_t * three_volt_cntl);
+
+#endif /* INCLUDE_SRC_CLA_H_ */
@@ -0,0 +1,84 @@
+/*
+ * src_dma.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  ADC result harvesting by DMA. The MPPT and battery V/I pairs (SOCs
+ *  ADC_RING_FIRST_SOC on) are sampled once each per ADC_PAIR_PRESCALE
+ *  switching periods, the battery's twice; the EOC of the last pair in the group triggers
+ *  ADC_RING_DMA_I and ADC_RING_DMA_V, which copy the group's results from
+ *  ADC_PAIR_I_ADC and ADC_PAIR_V_ADC into one ring per channel in GS RAM.
+ *  Each ring is split into two blocks of ADC_RING_BLOCK samples that the
+ *  DMA fills alternately. A block's average keeps ADC_OVERSAMPLE_BITS
+ *  fraction bits, so the results are 12 + ADC_OVERSAMPLE_BITS bits wide.
+ *
+ *  The MPPT pairs' turn-on samples (SOCs ADC_RIPPLE_FIRST_SOC on) have a
+ *  ring of their own, filled the same way by ADC_RIPPLE_DMA_I and
+ *  ADC_RIPPLE_DMA_V in blocks of ADC_RIPPLE_BLOCK that cover the same
+ *  switching periods as the pairs' blocks. Less the pair's block mean they
+ *  are the switching ripple at its peak, adc_ring_ripple(), for the MPPT
+ *  pairs adc_ring_set_ripple() switched on.
+ */
+
+#ifndef INCLUDE_SRC_DMA_H_
+#define INCLUDE_SRC_DMA_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "src_epwm.h"
+
+#define ADC_RING_FIRST_SOC      ADC_SOC_NUMBER0
+#define ADC_RING_CHANNELS       4U      // per ADC: MPPT 1, MPPT 2, battery twice
+#define ADC_RING_MPPT_CHANNELS  2U      // the first ones, the only pairs correlated
+#define ADC_RING_ADCS           2U      // ADC_PAIR_I_ADC, ADC_PAIR_V_ADC
+#define ADC_RING_BLOCK          ((TIMER_500US * (SWITCHING_FREQUENCY / US_PER_SECOND)) / ADC_PAIR_PRESCALE)    // samples per channel per MPPT period
+#define ADC_RING_DEPTH          (2U * ADC_RING_BLOCK)
+#define ADC_RING_HALF           (ADC_RING_BLOCK / 2U)   // samples per channel at each end of a block for adc_ring_drift()
+#define ADC_RING_COUNTS_PER_LSB (1U << ADC_OVERSAMPLE_BITS)    // ring result counts per ADC LSB
+
+#define ADC_RIPPLE_FIRST_SOC    MPPT_1_RIPPLE_SOC
+#define ADC_RIPPLE_CHANNELS     2U      // per ADC: MPPT 1, MPPT 2 at turn-on
+#define ADC_RIPPLE_BLOCK        ((TIMER_500US * (SWITCHING_FREQUENCY / US_PER_SECOND)) / ADC_RIPPLE_PRESCALE)  // samples per channel per MPPT period
+#define ADC_RIPPLE_DEPTH        (2U * ADC_RIPPLE_BLOCK)
+
+/**
+ * @brief Switching ripple of a V/I pair at turn-on across a block
+ *
+ * @details With v~ and i~ the turn-on samples less the pair's block means,
+ *      the sums of v~ and i~ over the block, in ring result counts. The
+ *      block mean is the high-pass filter; summing samples all taken at the
+ *      same point of the period is the multiply-accumulate against the
+ *      switching, whose reference is 1 there. The ADC noise averages out of
+ *      the sums instead of adding up in a sum of squares.
+ */
+typedef struct {
+    int32_t     v;
+    int32_t     i;
+} AdcRingRipple_t;
+
+typedef struct {
+    uint32_t    blocks;         // blocks completed by the DMA
+    uint32_t    overruns;       // blocks overwritten before they were read
+    uint32_t    ripple_blocks;  // turn-on blocks completed by the DMA
+    uint32_t    ripple_misses;  // pair blocks without their turn-on block
+} AdcRingStats_t;
+
+/***    I N I T S    ***/
+void init_adc_dma(void);
+void adc_ring_set_ripple(ADC_SOCNumber soc, bool enabled);
+
+/***    G E T S    ***/
+void adc_ring_update(void);
+uint16_t adc_ring_result(uint32_t result_base, ADC_SOCNumber soc);
+int16_t adc_ring_drift(uint32_t result_base, ADC_SOCNumber soc);
+const AdcRingRipple_t * adc_ring_ripple(ADC_SOCNumber soc);
+void adc_ring_correlate(AdcRingRipple_t * ripple, const volatile uint16_t * v_samples,
+                        const volatile uint16_t * i_samples, uint16_t v_mean, uint16_t i_mean);
+const AdcRingStats_t * get_adc_ring_stats(void);
+
+/***    I N T E R R U P T S    ***/
+__interrupt void dma_adc_ring_irq(void);
+__interrupt void dma_adc_ripple_irq(void);
+
+#endif /* INCLUDE_SRC_DMA_H_ */
@@ -9,18 +9,53 @@
 #define INCLUDE_SRC_EPWM_H_
 
 #include <stdint.h>
+#include <stdbool.h>
+#include "driverlib.h"
 
 
 #define     SWITCHING_FREQUENCY     1000000     // [Hz]
 #define     CLOCK_FREQUENCY         100000000   // [Hz]
 #define     PERIOD                  (CLOCK_FREQUENCY / SWITCHING_FREQUENCY)
 
+/** TBCLKs from a sync pulse to the phase load, added to every TBPHS */
+#define     EPWM_SYNC_DELAY         2U
+
+/**
+ * One converter's ePWM module and pins, applied by init_epwms(). The
+ * duty cycle arithmetic in change_pwm_duty_cycle() and the CLA assumes
+ * SWITCHING_FREQUENCY, and a phase only holds between modules that switch
+ * at the same frequency.
+ */
+typedef struct {
+    uint32_t        base;
+    SysCtl_PeripheralPCLOCKCR clock;
+    uint32_t        pin_hi;             // GPIO number, high-side gate
+    uint32_t        pin_lo;
+    uint32_t        pin_hi_config;      // pin_map.h GPIO_x_EPWMyA
+    uint32_t        pin_lo_config;
+    uint32_t        frequency;          // [Hz] switching
+    uint16_t        phase;              // [deg] turn-on after the sync master's
+    bool            sync_master;        // starts the chain, its phase is 0
+    EPWM_SyncOutPulseMode sync_out;     // passes the chain on, or not
+    uint16_t        dead_band_rising;   // [half TBCLK]
+    uint16_t        dead_band_falling;  // [half TBCLK]
+    uint16_t        hr_mep_step;        // HRPWM MEP scale factor
+    uint16_t        hr_period;          // TBPRDHR
+} EpwmConfig_t;
+
+/** ADC sample points within the switching period */
+typedef enum {
+    Sample_Mid_On_Time,         // CMPC
+    Sample_Mid_Off_Time         // CMPD
+} eEpwmSamplePoint;
+
 
 /***    I N I T S    ***/
-void initEPWMGPIO(void);
-void initEPWM1(void);
-void initEPWM3(void);
-void initEPWM(uint32_t epwm_base);
+void init_epwms(void);
+void init_epwm_adc_trigger(uint32_t epwm_base, uint32_t frequency);
+void init_epwm_sample_trigger(uint32_t epwm_base, EPWM_ADCStartOfConversionType soc_type,
+                              eEpwmSamplePoint point, uint16_t prescale, uint16_t event);
+void init_epwm_turn_on_trigger(uint32_t epwm_base, uint16_t lag, uint16_t prescale, uint16_t event);
 
 /***    D U T Y   C Y C L E    ***/
 void change_pwm_duty_cycle(uint32_t epwm_base, float dc);
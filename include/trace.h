@@ -0,0 +1,160 @@
+/*
+ * trace.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Execution-time trace of the control ISRs and the main loop. TRACE_START()
+ *  and TRACE_END() timestamp a task from the free-running TRACE_TIMER into
+ *  the ring in trace_buffer and keep its min/max/total execution time;
+ *  TRACE_OVERRUN() counts a task that became due again before it finished.
+ *
+ *  Times are wall time in SYSCLK cycles, so a task that was preempted
+ *  includes the interrupts that ran in the meantime. trace_buffer is a
+ *  single symbol in RAMGS1: save it from the debugger (raw binary or .dat)
+ *  and decode it on the host with sim/trace_decode.
+ *
+ *  Without USE_TRACE the macros compile to nothing and trace_buffer does not
+ *  exist. The layout below is all 32-bit words so the C28x and the host
+ *  decoder agree on it.
+ */
+
+#ifndef INCLUDE_TRACE_H_
+#define INCLUDE_TRACE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+#define TRACE_MAGIC             0x54524345UL    // "TRCE"
+#define TRACE_VERSION           2U
+
+/** Traced tasks, X(id, name) */
+#define TRACE_TASKS(X)                                  \
+    X(Trace_Buck_5V,        "buck5v_isr")               \
+    X(Trace_Buck_3V3,       "buck3v3_isr")              \
+    X(Trace_MPPT_Timer,     "mppt_timer_isr")           \
+    X(Trace_ADC_Ring,       "adc_ring_isr")             \
+    X(Trace_ADC_Ripple,     "adc_ripple_isr")           \
+    X(Trace_PV_Loop,        "pv_loop_isr")              \
+    X(Trace_Main_Loop,      "main_loop")                \
+    X(Trace_Conversions,    "conversions")              \
+    X(Trace_MPPT,           "mppt")                     \
+    X(Trace_Battery,        "battery")
+
+#define TRACE_TASK_ID(id, name)     id,
+
+typedef enum {
+    TRACE_TASKS(TRACE_TASK_ID)
+    Trace_Task_Count
+} eTraceTask;
+
+typedef enum {
+    Trace_Start,
+    Trace_End,
+    Trace_Overrun
+} eTraceEvent;
+
+/** Ring entry, event is the task in the low half and the eTraceEvent in the high half */
+#define TRACE_EVENT(task, event)    ((uint32_t)(task) | ((uint32_t)(event) << 16))
+#define TRACE_EVENT_TASK(e)         ((e) & 0xFFFFU)
+#define TRACE_EVENT_TYPE(e)         ((e) >> 16)
+
+typedef struct {
+    uint32_t    timestamp;      // [cycles]
+    uint32_t    event;
+} TraceEntry_t;
+
+typedef struct {
+    uint32_t    count;          // completed runs
+    uint32_t    overruns;
+    uint32_t    min;            // [cycles]
+    uint32_t    max;            // [cycles]
+    uint32_t    total_lo;       // [cycles] sum of all runs
+    uint32_t    total_hi;
+    uint32_t    start;          // timestamp of the run in progress
+    uint32_t    reserved;
+} TraceStats_t;
+
+typedef struct {
+    uint32_t        magic;
+    uint32_t        version;
+    uint32_t        sysclk_hz;
+    uint32_t        task_count;
+    uint32_t        ring_size;
+    uint32_t        written;    // entries ever written, the next goes to written % ring_size
+    TraceStats_t    stats[Trace_Task_Count];
+    TraceEntry_t    ring[TRACE_RING_SIZE];
+} TraceBuffer_t;
+
+
+#ifdef USE_TRACE
+
+extern TraceBuffer_t trace_buffer;
+
+void trace_init(void);
+
+/**
+ * @brief Current TRACE_TIMER count as an up-counting timestamp [cycles]
+ */
+static inline uint32_t trace_now(void) {
+    return ~CPUTimer_getTimerCount(TRACE_TIMER);
+}
+
+/**
+ * @brief Appends one entry to the ring
+ *
+ * @details Interrupts are held off so a task in the main loop and an ISR
+ *      never claim the same slot.
+ */
+static inline void trace_record(uint32_t timestamp, uint32_t event) {
+    bool was_disabled = Interrupt_disableGlobal();
+    TraceEntry_t * entry = &trace_buffer.ring[trace_buffer.written & (TRACE_RING_SIZE - 1U)];
+
+    entry->timestamp = timestamp;
+    entry->event = event;
+    trace_buffer.written++;
+    if(!was_disabled) {
+        Interrupt_enableGlobal();
+    }
+}
+
+static inline void trace_start(eTraceTask task) {
+    uint32_t now = trace_now();
+
+    trace_buffer.stats[task].start = now;
+    trace_record(now, TRACE_EVENT(task, Trace_Start));
+}
+
+static inline void trace_end(eTraceTask task) {
+    uint32_t now = trace_now();
+    TraceStats_t * stats = &trace_buffer.stats[task];
+    uint32_t cycles = now - stats->start;
+
+    trace_record(now, TRACE_EVENT(task, Trace_End));
+    stats->count++;
+    stats->min = (cycles < stats->min) ? cycles : stats->min;
+    stats->max = (cycles > stats->max) ? cycles : stats->max;
+    stats->total_lo += cycles;
+    stats->total_hi += (stats->total_lo < cycles) ? 1U : 0U;
+}
+
+static inline void trace_overrun(eTraceTask task) {
+    trace_buffer.stats[task].overruns++;
+    trace_record(trace_now(), TRACE_EVENT(task, Trace_Overrun));
+}
+
+#define TRACE_INIT()            trace_init()
+#define TRACE_START(task)       trace_start(task)
+#define TRACE_END(task)         trace_end(task)
+#define TRACE_OVERRUN(task)     trace_overrun(task)
+
+#else
+
+#define TRACE_INIT()            ((void)0)
+#define TRACE_START(task)       ((void)0)
+#define TRACE_END(task)         ((void)0)
+#define TRACE_OVERRUN(task)     ((void)0)
+
+#endif /* USE_TRACE */
+
+#endif /* INCLUDE_TRACE_H_ */
@@ -15,13 +15,20 @@
 #include "device.h"
 #include "battery.h"
 #include "src_adc.h"
+#include "src_cla.h"
+#include "src_dma.h"
 #include "src_epwm.h"
 #include "src_gpio.h"
 #include "src_timers.h"
+#include "trace.h"
+#include "bench.h"
 
 /** Controls */
-#include "pid.h"
+#include "compensator.h"
 #include "mppt.h"
+#include "mppt_dual.h"
+#include "power_manager.h"
+#include "pv_loop.h"
 
 /** Test Selection **/
 /*      NORMAL_OPERATION
@@ -39,14 +46,18 @@ Battery_t battery = {
          .voltage = 0.0,
          .current = 0.0,
          .state = Supply,
-         .charger = Charging_Inactive
+         .charger = { .cc_cv = Charging_Inactive }
 };
 
 
-PID_t five_volt_buck_pid;
-PID_t three_volt_buck_pid;
+Compensator_t five_volt_buck_cntl;
+Compensator_t three_volt_buck_cntl;
 MPPT_t mppt_one;
 MPPT_t mppt_two;
+MpptDual_t mppt_dual;
+PvLoop_t pv_loop_one;
+PvLoop_t pv_loop_two;
+PowerManager_t power_manager;
 
 
 void main(void) {
@@ -54,16 +65,32 @@ void main(void) {
     Device_init();
     Device_initGPIO();
 
-    // PID
-    PID_init(&five_volt_buck_pid, KP, KI, KD, V_BUCK_5V_REF, PID_US);
-    PID_init(&three_volt_buck_pid, KP, KI, KD, V_BUCK_3V3_REF, PID_US);
+    // Buck compensators, regulate the measured output voltage
+    compensator_init_pid(&five_volt_buck_cntl, BUCK_KP, BUCK_KI, BUCK_KD, BUCK_KD_TF,
+                         PID_PERIOD_S, V_BUCK_5V_OUT, BUCK_DUTY_MIN, BUCK_DUTY_MAX);
+    compensator_init_pid(&three_volt_buck_cntl, BUCK_KP, BUCK_KI, BUCK_KD, BUCK_KD_TF,
+                         PID_PERIOD_S, V_BUCK_3V3_OUT, BUCK_DUTY_MIN, BUCK_DUTY_MAX);
 
     // MPPT
-    mppt_init(&mppt_one, MPPT_ONE_ID, MPPT_1_DELTA_DC, MPPT_1_DELTA_DC_MAX);
-    mppt_init(&mppt_two, MPPT_TWO_ID, MPPT_2_DELTA_DC, MPPT_2_DELTA_DC_MAX);
-
-    // Battery
+    mppt_init(&mppt_one, MPPT_ONE_ID, MPPT_1_STRATEGY, MPPT_1_DELTA_DC, MPPT_1_DELTA_DC_MAX);
+    mppt_init(&mppt_two, MPPT_TWO_ID, MPPT_2_STRATEGY, MPPT_2_DELTA_DC, MPPT_2_DELTA_DC_MAX);
+    mppt_scan_init(&mppt_one, MPPT_1_PWM, MPPT_1_SCAN_INTERVAL);
+    mppt_scan_init(&mppt_two, MPPT_2_PWM, MPPT_2_SCAN_INTERVAL);
+    mppt_start_init(&mppt_one, MPPT_1_PWM, MPPT_1_FAST_START);
+    mppt_start_init(&mppt_two, MPPT_2_PWM, MPPT_2_FAST_START);
+    mppt_pace_init(&mppt_one, MPPT_1_PACE);
+    mppt_pace_init(&mppt_two, MPPT_2_PACE);
+    mppt_dual_init(&mppt_dual, &mppt_one, MPPT_1_PWM, &mppt_two, MPPT_2_PWM, MPPT_DUAL_MODE);
+
+    // Panel voltage loops, the trackers move their references
+    pv_loop_init(&pv_loop_one, MPPT_ONE_ID, MPPT_1_PWM, PV_LOOP_1_ENABLE);
+    pv_loop_init(&pv_loop_two, MPPT_TWO_ID, MPPT_2_PWM, PV_LOOP_2_ENABLE);
+    mppt_dual_set_loops(&mppt_dual, &pv_loop_one, &pv_loop_two);
+    init_pv_loops(&pv_loop_one, &pv_loop_two);
+
+    // Battery, and the outputs it supplies
     init_battery(&battery);
+    init_power_manager(&power_manager, POWER_MANAGER_ENABLE);
 
     // Initialize PIE and clear PIE registers. Disables CPU interrupts.
     Interrupt_initModule();
@@ -72,27 +99,71 @@ void main(void) {
     Interrupt_initVectorTable();
 
     // Configure peripherals
+    TRACE_INIT();
     init_led5();
     init_adc();
+    adc_calibrate_current_offsets();     // converters are still off
+    init_adc_dma();
+
+#ifdef USE_KERNEL_BENCH
+    // ePWM pins are still GPIOs, so the duty cycle writes switch nothing
+    bench_run_suite(KBENCH_ITERATIONS);
+    for(;;) {
+        IDLE;
+    }
+#endif
+
+    // Converters phase-interleaved from the MPPT 1 sync master
+    init_epwms();
 
-    initEPWMGPIO();
-    initEPWM(BUCK_5V_PWM);
-    initEPWM(BUCK_3V3_PWM);
-    initEPWM(MPPT_1_PWM);
-    initEPWM(MPPT_2_PWM);
+    // Buck loops run from the ADC EOC of ePWM-triggered samples
+#ifdef USE_CLA
+    init_cla();
+    init_cla_buck_control(&five_volt_buck_cntl, &three_volt_buck_cntl);
+#else
+    init_buck_control(&five_volt_buck_cntl, &three_volt_buck_cntl);
+#endif
+    init_epwm_adc_trigger(BUCK_5V_PWM, PID_FREQUENCY);
+    init_epwm_adc_trigger(BUCK_3V3_PWM, PID_FREQUENCY);
+
+    // MPPT and Battery pairs sample mid on-time, and the MPPT pairs at turn-on,
+    // each in its own switching period; the time-base clocks are stopped so the
+    // event counters start together
+    SysCtl_disablePeripheral(SYSCTL_PERIPH_CLK_TBCLKSYNC);
+    init_epwm_sample_trigger(MPPT_1_PWM, EPWM_SOC_A, Sample_Mid_On_Time, ADC_PAIR_PRESCALE, MPPT_1_ADC_EVENT);
+    init_epwm_sample_trigger(MPPT_2_PWM, EPWM_SOC_A, Sample_Mid_On_Time, ADC_PAIR_PRESCALE, MPPT_2_ADC_EVENT);
+    init_epwm_sample_trigger(BATT_ADC_PWM, EPWM_SOC_B, Sample_Mid_On_Time, ADC_PAIR_PRESCALE, BATT_ADC_EVENT);
+    init_epwm_sample_trigger(BATT_2_ADC_PWM, EPWM_SOC_B, Sample_Mid_On_Time, ADC_PAIR_PRESCALE, BATT_2_ADC_EVENT);
+    init_epwm_turn_on_trigger(MPPT_1_RIPPLE_PWM, BUCK_3V3_PWM_PHASE - MPPT_1_PWM_PHASE,
+                              ADC_RIPPLE_PRESCALE, MPPT_1_RIPPLE_EVENT);
+    init_epwm_turn_on_trigger(MPPT_2_RIPPLE_PWM, BUCK_5V_PWM_PHASE - MPPT_2_PWM_PHASE,
+                              ADC_RIPPLE_PRESCALE, MPPT_2_RIPPLE_EVENT);
+    SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_TBCLKSYNC);
 
-    init_timer(PID_TIMER, PID_US);
     init_timer(MPPT_TIMER, TIMER_500US);
+    init_timer(PV_LOOP_TIMER, PV_LOOP_PERIOD_US);
 
-    Interrupt_register(PID_TIMER_INT, &PID_Timer_ISR);
+#ifndef USE_CLA
+    Interrupt_register(BUCK_5V_ADC_INT, &adc_buck_5V_irq);
+    Interrupt_register(BUCK_3V3_ADC_INT, &adc_buck_3V3_irq);
+#endif
     Interrupt_register(MPPT_TIMER_INT, &MPPT_Timer_ISR);
+    Interrupt_register(PV_LOOP_TIMER_INT, &pv_loop_irq);
+    Interrupt_register(ADC_RING_DMA_INT, &dma_adc_ring_irq);
+    Interrupt_register(ADC_RIPPLE_DMA_INT, &dma_adc_ripple_irq);
 
     // Enable interrupts
-    Interrupt_enable(PID_TIMER_INT);
+#ifndef USE_CLA
+    Interrupt_enable(BUCK_5V_ADC_INT);
+    Interrupt_enable(BUCK_3V3_ADC_INT);
+#endif
     Interrupt_enable(MPPT_TIMER_INT);
+    Interrupt_enable(PV_LOOP_TIMER_INT);
+    Interrupt_enable(ADC_RING_DMA_INT);
+    Interrupt_enable(ADC_RIPPLE_DMA_INT);
 
-    CPUTimer_startTimer(PID_TIMER);
     CPUTimer_startTimer(MPPT_TIMER);
+    CPUTimer_startTimer(PV_LOOP_TIMER);
 
     // Enable Global Interrupt (INTM) and realtime interrupt (DBGM)
     EINT;
@@ -109,86 +180,41 @@ void main(void) {
     SysCtl_disableWatchdog();
 #endif
 
-    float mppt_one_pwm_delta = 0.0;
-    float mppt_two_pwm_delta = 0.0;
-
     // Loop Forever
     for(;;) {
         /*
-         * When enabled, the watchdog makes sure both control loops
-         *   run at least every 1.3ms otherwise the device will restart
+         * When enabled, the watchdog makes sure the MPPT loop
+         *   runs at least every 1.3ms otherwise the device will restart
          */
 //        SysCtl_serviceWatchdog();
 
-        /** PID **/
-        if(get_pid_active() == true) {
-            // get adc conversions
-            update_output_buck_conversions();
-
-            change_pwm_duty_cycle(BUCK_5V_PWM, PID_calculate(&five_volt_buck_pid, get_buck_v(BUCK_5V_ID)));
-            change_pwm_duty_cycle(BUCK_3V3_PWM, PID_calculate(&three_volt_buck_pid, get_buck_v(BUCK_3V3_ID)));
-            set_pid_active(false);
-        }
-
         /** MPPT **/
         if(get_mppt_active() == true)
         {
-            // wait for all MPPT and Battery ADC conversions to be done
+            TRACE_START(Trace_Main_Loop);
+
+            // average the MPPT and Battery samples the DMA collected since the last update
+            TRACE_START(Trace_Conversions);
             update_mppt_conversions();
             update_battery_conversions();
+            TRACE_END(Trace_Conversions);
 
-            // update values
-            mppt_update_values(&mppt_one);
-            mppt_update_values(&mppt_two);
+            TRACE_START(Trace_Battery);
             update_battery(&battery);
+            update_power_manager(&power_manager, &battery);
+            TRACE_END(Trace_Battery);
+
+            // track both PV inputs and apply CC/CV to their sum
+            TRACE_START(Trace_MPPT);
+            mppt_dual_step(&mppt_dual, &battery);
+            TRACE_END(Trace_MPPT);
 
-            // update duty cycles
-            mppt_one_pwm_delta = mppt_calculate(&mppt_one);
-            mppt_two_pwm_delta = mppt_calculate(&mppt_two);
-
-            // Apply CC/CV
-            if(battery.charger.cc_cv == Continuous_Current)
-            {
-                if(battery.current > I_BATTERY_MAX_LIMIT)
-                {
-                    // over-current, lower duty cycles
-                    mppt_one_pwm_delta -= mppt_one.delta_d * 5;
-                    mppt_two_pwm_delta -= mppt_two.delta_d * 5;
-                }
-                else
-                {
-                    // use original values, likely increases
-                }
-
-                change_pwm_duty_cycle(MPPT_1_PWM, (get_duty_cycle(MPPT_1_PWM) + mppt_one_pwm_delta));
-                change_pwm_duty_cycle(MPPT_2_PWM, (get_duty_cycle(MPPT_2_PWM) + mppt_two_pwm_delta));
-            }
-            else if(battery.charger.cc_cv == Continuous_Voltage)
-            {
-                if(battery.voltage > V_BATTERY_CHG_LIMIT)
-                {
-                    // over-voltage, lower duty cycles
-                    mppt_one_pwm_delta -= mppt_one.delta_d * 5;
-                    mppt_two_pwm_delta -= mppt_two.delta_d * 5;
-                }
-                else
-                {
-                    // use original values, likely increases
-                }
-
-                change_pwm_duty_cycle(MPPT_1_PWM, (get_duty_cycle(MPPT_1_PWM) + mppt_one_pwm_delta));
-                change_pwm_duty_cycle(MPPT_2_PWM, (get_duty_cycle(MPPT_2_PWM) + mppt_two_pwm_delta));
-            }
-            else if(battery.charger.cc_cv == Battery_Full)
-            {
-                change_pwm_duty_cycle(MPPT_1_PWM, 0);
-                change_pwm_duty_cycle(MPPT_2_PWM, 0);
-            }
             set_mppt_active(false);
+            TRACE_END(Trace_Main_Loop);
         }
-        else if ((get_pid_active() == false) && (get_mppt_active() == false))
+        else
         {
-            // go to low-power mode until a timer interrupt wakes up CPU
+            // go to low-power mode until a timer or ADC interrupt wakes up CPU
             IDLE;
         }
     }
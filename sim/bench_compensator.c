@@ -0,0 +1,153 @@
+/*
+ * bench_compensator.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Host microbenchmark: PID_calculate() against the precomputed 2P2Z and
+ *  3P3Z compensators. Also checks that a compensator built from the same
+ *  gains produces the same output sequence as PID_calculate(), so the
+ *  timing comparison is like-for-like.
+ *
+ *  Each call's input depends on the previous call's output, as it does in
+ *  the closed loop, so the timings are sample-to-output latency rather than
+ *  pipelined throughput. Host timings only rank the implementations; cycle
+ *  counts on the C28x have to be measured on the target.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "config.h"
+#include "pid.h"
+#include "compensator.h"
+
+#define BENCH_SAMPLES           4096U       // power of two, see sample mask
+#define BENCH_ITERATIONS        20000000UL
+#define BENCH_MATCH_TOLERANCE   1e-3f       // relative
+#define BENCH_PLANT_GAIN        1e-6f       // [V/%] closes the loop, see bench_pid()
+
+static float samples[BENCH_SAMPLES];
+static volatile float sink;
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((double)ts.tv_sec * 1e9) + (double)ts.tv_nsec;
+}
+
+static void report(const char * key, double value, const char * unit) {
+    printf("%-32s %14.6f %s\n", key, value, unit);
+}
+
+/**
+ * @brief Output voltage samples around the 5V setpoint, a few LSB of noise
+ */
+static void fill_samples(void) {
+    uint32_t n;
+
+    srand(1);
+    for(n = 0; n < BENCH_SAMPLES; n++) {
+        samples[n] = V_BUCK_5V_OUT + (0.01f * (((float)rand() / (float)RAND_MAX) - 0.5f));
+    }
+}
+
+/**
+ * @brief Runs PID_calculate() and a 2P2Z with the same gains side by side
+ *
+ * @return Largest relative difference between the two outputs
+ */
+static float check_equivalence(void) {
+    PID_t pid;
+    Compensator_t cntl;
+    float worst = 0.0f;
+    uint32_t n;
+
+    // PID_t integrates over whole microseconds with no output limit
+    PID_init(&pid, 3.2f, 2.1f, 2.3f, V_BUCK_5V_OUT, PID_US);
+    compensator_init_pid(&cntl, 3.2f, 2.1f, 2.3f, 0.0f, (float)PID_US,
+                         V_BUCK_5V_OUT, -1e30f, 1e30f);
+    compensator_reset(&cntl, 0.0f);
+
+    for(n = 0; n < BENCH_SAMPLES; n++) {
+        float a = PID_calculate(&pid, samples[n]);
+        float b = compensator_run_2p2z(&cntl, samples[n]);
+        float diff = fabsf(a - b) / fmaxf(fabsf(a), 1.0f);
+
+        worst = (diff > worst) ? diff : worst;
+    }
+    return worst;
+}
+
+/**
+ * @brief Times PID_calculate() with the output fed back into the next input
+ */
+static double bench_pid(void) {
+    PID_t pid;
+    unsigned long n;
+    double start;
+    float u = 0.0f;
+
+    PID_init(&pid, 3.2f, 2.1f, 2.3f, V_BUCK_5V_OUT, PID_US);
+    start = now_ns();
+    for(n = 0; n < BENCH_ITERATIONS; n++) {
+        u = PID_calculate(&pid, samples[n & (BENCH_SAMPLES - 1)] + (BENCH_PLANT_GAIN * u));
+    }
+    sink = u;
+    return (now_ns() - start) / (double)BENCH_ITERATIONS;
+}
+
+static double bench_2p2z(void) {
+    Compensator_t cntl;
+    unsigned long n;
+    double start;
+    float u = 0.0f;
+
+    compensator_init_pid(&cntl, BUCK_KP, BUCK_KI, BUCK_KD, BUCK_KD_TF, PID_PERIOD_S,
+                         V_BUCK_5V_OUT, BUCK_DUTY_MIN, BUCK_DUTY_MAX);
+    start = now_ns();
+    for(n = 0; n < BENCH_ITERATIONS; n++) {
+        u = compensator_run_2p2z(&cntl, samples[n & (BENCH_SAMPLES - 1)] + (BENCH_PLANT_GAIN * u));
+    }
+    sink = u;
+    return (now_ns() - start) / (double)BENCH_ITERATIONS;
+}
+
+static double bench_3p3z(void) {
+    // type III shape: integrator plus real poles at z = 0.3 and z = 0.2
+    const float b[4] = { 2.0f, -1.2f, -1.9f, 1.2f };
+    const float a[3] = { -1.5f, 0.56f, -0.06f };
+    Compensator_t cntl;
+    unsigned long n;
+    double start;
+    float u = 0.0f;
+
+    compensator_init_3p3z(&cntl, b, a, V_BUCK_5V_OUT, BUCK_DUTY_MIN, BUCK_DUTY_MAX);
+    start = now_ns();
+    for(n = 0; n < BENCH_ITERATIONS; n++) {
+        u = compensator_run_3p3z(&cntl, samples[n & (BENCH_SAMPLES - 1)] + (BENCH_PLANT_GAIN * u));
+    }
+    sink = u;
+    return (now_ns() - start) / (double)BENCH_ITERATIONS;
+}
+
+int main(void) {
+    float mismatch;
+    double pid_ns;
+    double cntl_ns;
+
+    fill_samples();
+
+    mismatch = check_equivalence();
+    report("bench.pid_2p2z_mismatch", (double)mismatch, "");
+
+    pid_ns = bench_pid();
+    cntl_ns = bench_2p2z();
+    report("bench.pid_calculate", pid_ns, "ns/call");
+    report("bench.compensator_2p2z", cntl_ns, "ns/call");
+    report("bench.compensator_3p3z", bench_3p3z(), "ns/call");
+    report("bench.speedup_2p2z", pid_ns / cntl_ns, "x");
+
+    return (mismatch > BENCH_MATCH_TOLERANCE) ? 1 : 0;
+}
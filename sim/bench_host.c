@@ -0,0 +1,32 @@
+/*
+ * bench_host.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Host timing backend for src/bench.c in place of the ERAD counter in
+ *  src/bench_erad.c. Ticks are host nanoseconds: the simulator advances
+ *  SYSCLK only on waits, so its own clock would read 0 for every kernel.
+ *  Host numbers rank the kernels; C28x cycles come from the target.
+ */
+
+#include <time.h>
+
+#include "bench.h"
+
+#ifdef USE_KERNEL_BENCH
+
+void bench_timer_init(void) {
+}
+
+uint32_t bench_timer_read(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec);
+}
+
+uint32_t bench_timer_hz(void) {
+    return 1000000000UL;
+}
+
+#endif /* USE_KERNEL_BENCH */
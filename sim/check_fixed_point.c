@@ -0,0 +1,423 @@
+/*
+ * check_fixed_point.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Host check of the USE_FIXED_POINT backend, built with -DUSE_FIXED_POINT.
+ *
+ *  - ADC scaling: every code of every channel against the float formulas,
+ *    error reported in ADC LSBs.
+ *  - Compensator: the Q24/Q15 2P2Z must match, bit for bit, a direct form I
+ *    reference model that accumulates in 128 bits, so any int64 overflow or
+ *    rounding difference in the transposed form shows up. The deviation
+ *    from a double-precision model of the same controller is reported.
+ *  - q24_mpy (MPPT power) against a 128-bit reference.
+ *  - q24_div (incremental conductance dP/dV) against a 128-bit reference,
+ *    saturation included.
+ *  - ns per call of the fixed and float hot paths, closed loop as in
+ *    bench_compensator.c.
+ *
+ *  Prints "key value unit" lines, exits non-zero if a bit-exact check fails.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "config.h"
+#include "compensator.h"
+#include "src_adc.h"
+#include "src_dma.h"
+
+#ifndef USE_FIXED_POINT
+#error "build with -DUSE_FIXED_POINT (make check-fixed)"
+#endif
+
+#define CHECK_SAMPLES           200000U
+#define CHECK_ITERATIONS        20000000UL
+#define CHECK_PLANT_GAIN        1e-6f       // [V/%] closes the loop for timing
+
+typedef __int128 acc128_t;
+
+typedef struct {
+    int32_t b[3];
+    int32_t a[2];           // negated, as stored
+    int32_t e[2];           // e[n-1], e[n-2]
+    int32_t u[2];           // u[n-1], u[n-2]
+    acc128_t u_min;
+    acc128_t u_max;
+    int32_t ref;
+} RefQ2p2z_t;
+
+typedef struct {
+    double b[3];
+    double a[2];
+    double e[2];
+    double u[2];
+    double u_min;
+    double u_max;
+    double ref;
+} RefF2p2z_t;
+
+static float samples[CHECK_SAMPLES];
+static volatile float sink_f;
+static volatile int32_t sink_q;
+static uint32_t rng = 1;
+
+
+static void report(const char * key, double value, const char * unit) {
+    printf("%-32s %14.6f %s\n", key, value, unit);
+}
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((double)ts.tv_sec * 1e9) + (double)ts.tv_nsec;
+}
+
+static float uniform(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return (float)rng / 4294967296.0f;
+}
+
+/**
+ * @brief Output voltage: noise around the setpoint, plus steps far enough
+ *      out to saturate the compensator in both directions
+ */
+static void fill_samples(void) {
+    uint32_t n;
+
+    for(n = 0; n < CHECK_SAMPLES; n++) {
+        float v = V_BUCK_5V_OUT + (0.02f * (uniform() - 0.5f));
+
+        switch((n / 5000U) % 4U) {
+        case(1): v -= 2.0f; break;
+        case(3): v += 1.0f; break;
+        default: break;
+        }
+        samples[n] = v;
+    }
+}
+
+
+/**********************************************************
+ *                  A D C   S C A L I N G
+ **********************************************************/
+
+/**
+ * @brief Worst error of a channel's scaling over every code, in ADC LSB
+ *
+ * @param counts Codes per ADC LSB: 1 for raw results, ADC_RING_COUNTS_PER_LSB
+ *      for the DMA ring averages
+ */
+static double check_adc_channel(const char * name, ctl_t gain, ctl_t offset, uint32_t counts,
+                                double ref_per_lsb, double ref_offset) {
+    double worst = 0.0;
+    char key[64];
+    uint32_t code;
+
+    for(code = 0; code <= (ADC_MAX_VALUE * counts); code++) {
+        ctl_t q = (counts == 1U) ? adc_scale((uint16_t)code, gain, offset)
+                                 : adc_scale_ring((uint16_t)code, gain, offset);
+        double fixed = (double)q24_to_f(q);
+        double ref = (((double)code / (double)counts) * ref_per_lsb) + ref_offset;
+        double err = fabs(fixed - ref) / ref_per_lsb;
+
+        worst = (err > worst) ? err : worst;
+    }
+    snprintf(key, sizeof(key), "adc.%s.max_err", name);
+    report(key, worst, "LSB");
+    return worst;
+}
+
+static void check_adc(void) {
+    const double v_lsb = (double)VREFHI_V / (double)ADC_MAX_VALUE_F;
+    const double i_lsb = (v_lsb * 1000.0) / (double)I_SENSE_SENS;
+
+    check_adc_channel("pv_v", ADC_VOLTAGE_SCALE(V_PV_SENSE_R1, V_PV_SENSE_R2), 0, ADC_RING_COUNTS_PER_LSB,
+                      v_lsb * (V_PV_SENSE_R1 + V_PV_SENSE_R2) / V_PV_SENSE_R2, 0.0);
+    check_adc_channel("buck5v_v", ADC_VOLTAGE_SCALE(BUCK_5V_OUTPUT_R1, BUCK_5V_OUTPUT_R2), 0, 1U,
+                      v_lsb * (BUCK_5V_OUTPUT_R1 + BUCK_5V_OUTPUT_R2) / BUCK_5V_OUTPUT_R2, 0.0);
+    check_adc_channel("buck3v3_v", ADC_VOLTAGE_SCALE(BUCK_3V3_OUTPUT_R1, BUCK_3V3_OUTPUT_R2), 0, 1U,
+                      v_lsb * (BUCK_3V3_OUTPUT_R1 + BUCK_3V3_OUTPUT_R2) / BUCK_3V3_OUTPUT_R2, 0.0);
+    check_adc_channel("battery_v", ADC_VOLTAGE_SCALE(V_BATT_SENSE_R1, V_BATT_SENSE_R2), 0, ADC_RING_COUNTS_PER_LSB,
+                      v_lsb * (V_BATT_SENSE_R1 + V_BATT_SENSE_R2) / V_BATT_SENSE_R2, 0.0);
+    check_adc_channel("current", ADC_CURRENT_SCALE, ADC_CURRENT_OFFSET, ADC_RING_COUNTS_PER_LSB,
+                      i_lsb, -((double)V_IOUT_Q * 1000.0) / (double)I_SENSE_SENS);
+}
+
+
+/**********************************************************
+ *                  C O M P E N S A T O R
+ **********************************************************/
+
+static void ref_q_init(RefQ2p2z_t * ref, const Compensator_t * cntl) {
+    ref->b[0] = cntl->b0;
+    ref->b[1] = cntl->b1;
+    ref->b[2] = cntl->b2;
+    ref->a[0] = cntl->a1;
+    ref->a[1] = cntl->a2;
+    ref->e[0] = 0;
+    ref->e[1] = 0;
+    ref->u[0] = (int32_t)(cntl->u_min >> Q15_SHIFT);
+    ref->u[1] = ref->u[0];
+    ref->u_min = cntl->u_min;
+    ref->u_max = cntl->u_max;
+    ref->ref = cntl->ref;
+}
+
+/**
+ * @brief Direct form I, exact 128-bit sum, one truncating shift
+ */
+static int32_t ref_q_run(RefQ2p2z_t * ref, int32_t y) {
+    int32_t e = ref->ref - y;
+    acc128_t acc = ((acc128_t)ref->b[0] * e) + ((acc128_t)ref->b[1] * ref->e[0])
+                 + ((acc128_t)ref->b[2] * ref->e[1])
+                 + ((acc128_t)ref->a[0] * ref->u[0]) + ((acc128_t)ref->a[1] * ref->u[1]);
+    int32_t u;
+
+    acc = (acc > ref->u_max) ? ref->u_max : acc;
+    acc = (acc < ref->u_min) ? ref->u_min : acc;
+    u = (int32_t)(acc >> Q15_SHIFT);
+
+    ref->e[1] = ref->e[0];
+    ref->e[0] = e;
+    ref->u[1] = ref->u[0];
+    ref->u[0] = u;
+    return u;
+}
+
+/**
+ * @brief Same controller as compensator_init_pid() in double precision
+ */
+static void ref_f_init(RefF2p2z_t * ref, double Kp, double Ki, double Kd, double Tf, double Ts,
+                       double r, double u_min, double u_max) {
+    double alpha = Tf / (Tf + Ts);
+    double ki = Ki * Ts;
+    double kd = Kd / (Tf + Ts);
+
+    ref->b[0] = Kp + ki + kd;
+    ref->b[1] = -(Kp * (1.0 + alpha)) - (ki * alpha) - (2.0 * kd);
+    ref->b[2] = (Kp * alpha) + kd;
+    ref->a[0] = 1.0 + alpha;
+    ref->a[1] = -alpha;
+    ref->e[0] = 0.0;
+    ref->e[1] = 0.0;
+    ref->u[0] = u_min;
+    ref->u[1] = u_min;
+    ref->u_min = u_min;
+    ref->u_max = u_max;
+    ref->ref = r;
+}
+
+static double ref_f_run(RefF2p2z_t * ref, double y) {
+    double e = ref->ref - y;
+    double u = (ref->b[0] * e) + (ref->b[1] * ref->e[0]) + (ref->b[2] * ref->e[1])
+             + (ref->a[0] * ref->u[0]) + (ref->a[1] * ref->u[1]);
+
+    u = (u > ref->u_max) ? ref->u_max : u;
+    u = (u < ref->u_min) ? ref->u_min : u;
+
+    ref->e[1] = ref->e[0];
+    ref->e[0] = e;
+    ref->u[1] = ref->u[0];
+    ref->u[0] = u;
+    return u;
+}
+
+/**
+ * @brief Coefficients as the float backend computes them
+ */
+static void float_init_2p2z(float * s, float * c) {
+    float alpha = BUCK_KD_TF / (BUCK_KD_TF + PID_PERIOD_S);
+    float ki = BUCK_KI * PID_PERIOD_S;
+    float kd = BUCK_KD / (BUCK_KD_TF + PID_PERIOD_S);
+
+    c[0] = BUCK_KP + ki + kd;
+    c[1] = -(BUCK_KP * (1.0f + alpha)) - (ki * alpha) - (2.0f * kd);
+    c[2] = (BUCK_KP * alpha) + kd;
+    c[3] = 1.0f + alpha;
+    c[4] = -alpha;
+    s[0] = (c[3] * BUCK_DUTY_MIN) + (c[4] * BUCK_DUTY_MIN);
+    s[1] = c[4] * BUCK_DUTY_MIN;
+}
+
+/**
+ * @brief The float backend's compensator_run_2p2z()
+ */
+static inline float float_run_2p2z(float * s, const float * c, float r, float y) {
+    float e = r - y;
+    float u = (c[0] * e) + s[0];
+
+    u = (u > BUCK_DUTY_MAX) ? BUCK_DUTY_MAX : u;
+    u = (u < BUCK_DUTY_MIN) ? BUCK_DUTY_MIN : u;
+
+    s[0] = (c[1] * e) + (c[3] * u) + s[1];
+    s[1] = (c[2] * e) + (c[4] * u);
+    return u;
+}
+
+static uint32_t check_compensator(void) {
+    Compensator_t cntl;
+    RefQ2p2z_t ref_q;
+    RefF2p2z_t ref_f;
+    float coef[5];
+    float state[2];
+    uint32_t mismatches = 0;
+    uint32_t saturated = 0;
+    double worst = 0.0;
+    double sum_sq = 0.0;
+    double worst_f = 0.0;
+    double sum_sq_f = 0.0;
+    uint32_t n;
+
+    compensator_init_pid(&cntl, BUCK_KP, BUCK_KI, BUCK_KD, BUCK_KD_TF, PID_PERIOD_S,
+                         V_BUCK_5V_OUT, BUCK_DUTY_MIN, BUCK_DUTY_MAX);
+    ref_q_init(&ref_q, &cntl);
+    ref_f_init(&ref_f, BUCK_KP, BUCK_KI, BUCK_KD, BUCK_KD_TF, 1.0 / PID_FREQUENCY,
+               V_BUCK_5V_OUT, BUCK_DUTY_MIN, BUCK_DUTY_MAX);
+    float_init_2p2z(state, coef);
+
+    for(n = 0; n < CHECK_SAMPLES; n++) {
+        int32_t y = q24_from_f(samples[n]);
+        int32_t u = compensator_run_2p2z(&cntl, y);
+        double ref = ref_f_run(&ref_f, (double)q24_to_f(y));
+        double err = fabs((double)q24_to_f(u) - ref);
+        double err_f = fabs((double)float_run_2p2z(state, coef, V_BUCK_5V_OUT, q24_to_f(y)) - ref);
+
+        mismatches += (u != ref_q_run(&ref_q, y)) ? 1U : 0U;
+        saturated += ((u == (int32_t)(cntl.u_min >> Q15_SHIFT)) || (u == (int32_t)(cntl.u_max >> Q15_SHIFT))) ? 1U : 0U;
+        worst = (err > worst) ? err : worst;
+        sum_sq += err * err;
+        worst_f = (err_f > worst_f) ? err_f : worst_f;
+        sum_sq_f += err_f * err_f;
+    }
+
+    report("comp.samples", (double)CHECK_SAMPLES, "");
+    report("comp.saturated", (double)saturated, "");
+    report("comp.bit_mismatches", (double)mismatches, "");
+    report("comp.max_err_vs_double", worst, "%duty");
+    report("comp.rms_err_vs_double", sqrt(sum_sq / (double)CHECK_SAMPLES), "%duty");
+    report("comp.float.max_err_vs_double", worst_f, "%duty");
+    report("comp.float.rms_err_vs_double", sqrt(sum_sq_f / (double)CHECK_SAMPLES), "%duty");
+    return mismatches;
+}
+
+
+/**********************************************************
+ *                  M U L T I P L Y
+ **********************************************************/
+
+static uint32_t check_mpy(void) {
+    uint32_t mismatches = 0;
+    double worst = 0.0;
+    uint32_t n;
+
+    for(n = 0; n < CHECK_SAMPLES; n++) {
+        // PV voltage up to 22V, current up to 1.5A
+        int32_t v = q24_from_f(22.0f * uniform());
+        int32_t i = q24_from_f((1.5f * uniform()) - 0.1f);
+        int32_t p = q24_mpy(v, i);
+        acc128_t ref = ((acc128_t)v * i) >> Q24_SHIFT;
+        double err = fabs((double)q24_to_f(p) - ((double)q24_to_f(v) * (double)q24_to_f(i)));
+
+        mismatches += (p != (int32_t)ref) ? 1U : 0U;
+        worst = (err > worst) ? err : worst;
+    }
+    report("mpy.bit_mismatches", (double)mismatches, "");
+    report("mpy.max_err_vs_double", worst, "W");
+    return mismatches;
+}
+
+static uint32_t check_div(void) {
+    uint32_t mismatches = 0;
+    uint32_t saturated = 0;
+    uint32_t n;
+
+    for(n = 0; n < CHECK_SAMPLES; n++) {
+        // I*dV + V*dI over a panel voltage change down to a few mV
+        int32_t a = q24_from_f(4.0f * (uniform() - 0.5f));
+        int32_t b = q24_from_f(0.2f * (uniform() - 0.5f));
+        acc128_t ref;
+        int32_t q;
+
+        if(b == 0) {
+            continue;
+        }
+        q = q24_div(a, b);
+        ref = ((acc128_t)a << Q24_SHIFT) / b;
+        if((ref > INT32_MAX) || (ref < INT32_MIN)) {
+            ref = (ref > 0) ? INT32_MAX : INT32_MIN;
+            saturated++;
+        }
+        mismatches += (q != (int32_t)ref) ? 1U : 0U;
+    }
+    report("div.bit_mismatches", (double)mismatches, "");
+    report("div.saturated", (double)saturated, "");
+    return mismatches;
+}
+
+
+/**********************************************************
+ *                  T I M I N G
+ **********************************************************/
+
+static void bench(void) {
+    Compensator_t cntl;
+    float coef[5];
+    float state[2];
+    unsigned long n;
+    double start;
+    double fixed_ns;
+    double float_ns;
+    float u_f = 0.0f;
+    int32_t u_q = 0;
+
+    compensator_init_pid(&cntl, BUCK_KP, BUCK_KI, BUCK_KD, BUCK_KD_TF, PID_PERIOD_S,
+                         V_BUCK_5V_OUT, BUCK_DUTY_MIN, BUCK_DUTY_MAX);
+    float_init_2p2z(state, coef);
+
+    start = now_ns();
+    for(n = 0; n < CHECK_ITERATIONS; n++) {
+        uint16_t code = (uint16_t)(1550U + (n & 0x1FU) + (u_q >> 28));
+        u_q = compensator_run_2p2z(&cntl, adc_scale(code, ADC_VOLTAGE_SCALE(BUCK_5V_OUTPUT_R1, BUCK_5V_OUTPUT_R2), 0));
+    }
+    fixed_ns = (now_ns() - start) / (double)CHECK_ITERATIONS;
+    sink_q = u_q;
+
+    start = now_ns();
+    for(n = 0; n < CHECK_ITERATIONS; n++) {
+        uint16_t code = (uint16_t)(1550U + (n & 0x1FU));
+        float v = VOLTAGE_UNDIVIDER(adc_convert_to_v(code), BUCK_5V_OUTPUT_R1, BUCK_5V_OUTPUT_R2);
+        u_f = float_run_2p2z(state, coef, V_BUCK_5V_OUT, v + (CHECK_PLANT_GAIN * u_f));
+    }
+    float_ns = (now_ns() - start) / (double)CHECK_ITERATIONS;
+    sink_f = u_f;
+
+    report("time.fixed.scale_2p2z", fixed_ns, "ns/call");
+    report("time.float.scale_2p2z", float_ns, "ns/call");
+}
+
+/**
+ * @brief Float ADC conversion, as src_adc.c does it without USE_FIXED_POINT
+ */
+float adc_convert_to_v(uint32_t adc_result) {
+    return (((float)adc_result * VREF_MV_F) / ADC_MAX_VALUE_F);
+}
+
+int main(void) {
+    uint32_t failures = 0;
+
+    fill_samples();
+
+    check_adc();
+    failures += check_compensator();
+    failures += check_mpy();
+    failures += check_div();
+    bench();
+
+    return (failures != 0) ? 1 : 0;
+}
@@ -0,0 +1,28 @@
+/*
+ * device.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Host stand-in for device/device.h (LaunchPad F280049C).
+ */
+
+#ifndef SIM_DEVICE_H_
+#define SIM_DEVICE_H_
+
+#include <stdint.h>
+#include "driverlib.h"
+
+#define DEVICE_GPIO_PIN_LED1        31U     // GPIO number for LD2
+#define DEVICE_GPIO_PIN_LED2        34U     // GPIO number for LD3
+
+#define DEVICE_OSCSRC_FREQ          20000000U
+#define DEVICE_SYSCLK_FREQ          ((DEVICE_OSCSRC_FREQ * 10 * 1) / 2)
+
+#define DEVICE_DELAY_US(x)          sim_delay_us(x)
+
+#define Device_init()               ((void)0)
+#define Device_initGPIO()           ((void)0)
+
+void sim_delay_us(uint32_t us);
+
+#endif /* SIM_DEVICE_H_ */
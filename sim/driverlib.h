@@ -0,0 +1,462 @@
+/*
+ * driverlib.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Host stand-in for device/driverlib.h. The simulator puts this directory
+ *  ahead of device/ on the include path so the firmware sources build
+ *  unchanged with gcc. Calls that only configure hardware expand to
+ *  nothing; calls that move data (ADC results, compare values, timers,
+ *  interrupts) are implemented in sim_hal.c against the plant model.
+ */
+
+#ifndef SIM_DRIVERLIB_H_
+#define SIM_DRIVERLIB_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "inc/hw_memmap.h"
+#include "inc/hw_ints.h"
+#include "inc/hw_adc.h"
+#include "pin_map.h"
+
+/***    C 2 8 x   I N T R I N S I C S    ***/
+#define EALLOW
+#define EDIS
+#define EINT                    sim_enable_interrupts()
+#define DINT                    sim_disable_interrupts()
+#define ERTM
+#define IDLE                    sim_idle()
+
+void sim_enable_interrupts(void);
+void sim_disable_interrupts(void);
+void sim_idle(void);
+
+
+/**********************************************************
+ *                          A D C
+ **********************************************************/
+
+typedef enum {
+    ADC_TRIGGER_SW_ONLY     = 0,
+    ADC_TRIGGER_CPU1_TINT0  = 1,
+    ADC_TRIGGER_CPU1_TINT1  = 2,
+    ADC_TRIGGER_CPU1_TINT2  = 3,
+    ADC_TRIGGER_GPIO        = 4,
+    ADC_TRIGGER_EPWM1_SOCA  = 5,
+    ADC_TRIGGER_EPWM1_SOCB  = 6,
+    ADC_TRIGGER_EPWM2_SOCA  = 7,
+    ADC_TRIGGER_EPWM2_SOCB  = 8,
+    ADC_TRIGGER_EPWM3_SOCA  = 9,
+    ADC_TRIGGER_EPWM3_SOCB  = 10,
+    ADC_TRIGGER_EPWM4_SOCA  = 11,
+    ADC_TRIGGER_EPWM4_SOCB  = 12,
+    ADC_TRIGGER_EPWM5_SOCA  = 13,
+    ADC_TRIGGER_EPWM5_SOCB  = 14,
+    ADC_TRIGGER_EPWM6_SOCA  = 15,
+    ADC_TRIGGER_EPWM6_SOCB  = 16,
+    ADC_TRIGGER_EPWM7_SOCA  = 17,
+    ADC_TRIGGER_EPWM7_SOCB  = 18,
+    ADC_TRIGGER_EPWM8_SOCA  = 19,
+    ADC_TRIGGER_EPWM8_SOCB  = 20
+} ADC_Trigger;
+
+typedef enum {
+    ADC_CH_ADCIN0,
+    ADC_CH_ADCIN1,
+    ADC_CH_ADCIN2,
+    ADC_CH_ADCIN3,
+    ADC_CH_ADCIN4,
+    ADC_CH_ADCIN5,
+    ADC_CH_ADCIN6,
+    ADC_CH_ADCIN7,
+    ADC_CH_ADCIN8,
+    ADC_CH_ADCIN9,
+    ADC_CH_ADCIN10,
+    ADC_CH_ADCIN11,
+    ADC_CH_ADCIN12,
+    ADC_CH_ADCIN13,
+    ADC_CH_ADCIN14,
+    ADC_CH_ADCIN15
+} ADC_Channel;
+
+typedef enum {
+    ADC_SOC_NUMBER0,
+    ADC_SOC_NUMBER1,
+    ADC_SOC_NUMBER2,
+    ADC_SOC_NUMBER3,
+    ADC_SOC_NUMBER4,
+    ADC_SOC_NUMBER5,
+    ADC_SOC_NUMBER6,
+    ADC_SOC_NUMBER7,
+    ADC_SOC_NUMBER8,
+    ADC_SOC_NUMBER9,
+    ADC_SOC_NUMBER10,
+    ADC_SOC_NUMBER11,
+    ADC_SOC_NUMBER12,
+    ADC_SOC_NUMBER13,
+    ADC_SOC_NUMBER14,
+    ADC_SOC_NUMBER15
+} ADC_SOCNumber;
+
+typedef enum {
+    ADC_INT_NUMBER1,
+    ADC_INT_NUMBER2,
+    ADC_INT_NUMBER3,
+    ADC_INT_NUMBER4
+} ADC_IntNumber;
+
+typedef enum {
+    ADC_PRI_ALL_ROUND_ROBIN,
+    ADC_PRI_SOC0_HIPRI,
+    ADC_PRI_THRU_SOC1_HIPRI,
+    ADC_PRI_THRU_SOC2_HIPRI,
+    ADC_PRI_THRU_SOC3_HIPRI,
+    ADC_PRI_THRU_SOC4_HIPRI,
+    ADC_PRI_THRU_SOC5_HIPRI,
+    ADC_PRI_THRU_SOC6_HIPRI,
+    ADC_PRI_THRU_SOC7_HIPRI,
+    ADC_PRI_THRU_SOC8_HIPRI,
+    ADC_PRI_THRU_SOC9_HIPRI,
+    ADC_PRI_THRU_SOC10_HIPRI,
+    ADC_PRI_THRU_SOC11_HIPRI,
+    ADC_PRI_THRU_SOC12_HIPRI,
+    ADC_PRI_THRU_SOC13_HIPRI,
+    ADC_PRI_THRU_SOC14_HIPRI,
+    ADC_PRI_ALL_HIPRI
+} ADC_PriorityMode;
+
+#define ADC_setVREF(base, mode, ref)                    ((void)0)
+#define ADC_setPrescaler(base, clkPrescale)             ((void)0)
+#define ADC_setInterruptPulseMode(base, pulseMode)      ((void)0)
+#define ADC_enableConverter(base)                       ((void)0)
+
+void ADC_setupSOC(uint32_t base, ADC_SOCNumber socNumber, ADC_Trigger trigger,
+                  ADC_Channel channel, uint32_t sampleWindow);
+void ADC_forceSOC(uint32_t base, ADC_SOCNumber socNumber);
+bool ADC_isBusy(uint32_t base);
+uint16_t ADC_readResult(uint32_t resultBase, ADC_SOCNumber socNumber);
+void ADC_setInterruptSource(uint32_t base, ADC_IntNumber adcIntNum, ADC_SOCNumber socNumber);
+void ADC_enableInterrupt(uint32_t base, ADC_IntNumber adcIntNum);
+void ADC_disableInterrupt(uint32_t base, ADC_IntNumber adcIntNum);
+void ADC_clearInterruptStatus(uint32_t base, ADC_IntNumber adcIntNum);
+void ADC_enableContinuousMode(uint32_t base, ADC_IntNumber adcIntNum);
+void ADC_disableContinuousMode(uint32_t base, ADC_IntNumber adcIntNum);
+void ADC_setSOCPriority(uint32_t base, ADC_PriorityMode priMode);
+
+
+/**********************************************************
+ *                     E P W M / H R P W M
+ **********************************************************/
+
+typedef enum {
+    EPWM_COUNTER_COMPARE_A = 0,
+    EPWM_COUNTER_COMPARE_B = 2,
+    EPWM_COUNTER_COMPARE_C = 5,
+    EPWM_COUNTER_COMPARE_D = 7
+} EPWM_CounterCompareModule;
+
+typedef enum {
+    HRPWM_COUNTER_COMPARE_A = 0,
+    HRPWM_COUNTER_COMPARE_B = 4
+} HRPWM_CounterCompareModule;
+
+typedef enum {
+    EPWM_SOC_A = 0,
+    EPWM_SOC_B = 1
+} EPWM_ADCStartOfConversionType;
+
+typedef enum {
+    EPWM_SOC_DCxEVT1 = 0,
+    EPWM_SOC_TBCTR_ZERO = 1,
+    EPWM_SOC_TBCTR_PERIOD = 2,
+    EPWM_SOC_TBCTR_ZERO_OR_PERIOD = 3,
+    EPWM_SOC_TBCTR_U_CMPA = 4,
+    EPWM_SOC_TBCTR_U_CMPC = 8,
+    EPWM_SOC_TBCTR_D_CMPA = 5,
+    EPWM_SOC_TBCTR_D_CMPC = 10,
+    EPWM_SOC_TBCTR_U_CMPB = 6,
+    EPWM_SOC_TBCTR_U_CMPD = 12,
+    EPWM_SOC_TBCTR_D_CMPB = 7,
+    EPWM_SOC_TBCTR_D_CMPD = 14
+} EPWM_ADCStartOfConversionSource;
+
+typedef enum {
+    HRPWM_OUTPUT_ON_B_NORMAL = 0,
+    HRPWM_OUTPUT_ON_B_INV_A  = 1
+} HRPWM_ChannelBOutput;
+
+typedef enum {
+    EPWM_SYNC_OUT_PULSE_ON_SOFTWARE = 0,
+    EPWM_SYNC_OUT_PULSE_ON_EPWMxSYNCIN = 0,
+    EPWM_SYNC_OUT_PULSE_ON_COUNTER_ZERO = 1,
+    EPWM_SYNC_OUT_PULSE_ON_COUNTER_COMPARE_B = 2,
+    EPWM_SYNC_OUT_PULSE_DISABLED = 4,
+    EPWM_SYNC_OUT_PULSE_ON_COUNTER_COMPARE_C = 5,
+    EPWM_SYNC_OUT_PULSE_ON_COUNTER_COMPARE_D = 6
+} EPWM_SyncOutPulseMode;
+
+#define EPWM_setActionQualifierContSWForceShadowMode(base, mode)        ((void)0)
+#define EPWM_setTimeBaseCounterMode(base, counterMode)                  ((void)0)
+#define EPWM_setClockPrescaler(base, prescaler, highSpeedPrescaler)     ((void)0)
+#define EPWM_setEmulationMode(base, emulationMode)                      ((void)0)
+#define EPWM_setCounterCompareShadowLoadMode(base, compModule, loadMode) ((void)0)
+#define EPWM_setActionQualifierAction(base, epwmOutput, output, event)  ((void)0)
+#define EPWM_setDeadBandCounterClock(base, clockMode)                   ((void)0)
+#define EPWM_setRisingEdgeDeadBandDelayInput(base, input)               ((void)0)
+#define EPWM_setDeadBandOutputSwapMode(base, output, enableSwapMode)    ((void)0)
+#define EPWM_setDeadBandDelayMode(base, delayMode, enableDelayMode)     ((void)0)
+#define EPWM_setDeadBandDelayPolarity(base, delayMode, polarity)        ((void)0)
+#define EPWM_setRisingEdgeDelayCount(base, redCount)                    ((void)0)
+#define EPWM_setFallingEdgeDelayCount(base, fedCount)                   ((void)0)
+#define EPWM_setTimeBaseCounter(base, count)                            ((void)0)
+#define EPWM_setCountModeAfterSync(base, mode)                          ((void)0)
+
+#define HRPWM_setMEPEdgeSelect(base, channel, mepEdgeMode)              ((void)0)
+#define HRPWM_setMEPControlMode(base, channel, mepCtrlMode)             ((void)0)
+#define HRPWM_setCounterCompareShadowLoadEvent(base, channel, loadEvent) ((void)0)
+#define HRPWM_disableAutoConversion(base)                               ((void)0)
+#define HRPWM_disablePeriodControl(base)                                ((void)0)
+#define HRPWM_setDeadbandMEPEdgeSelect(base, mepDBEdge)                 ((void)0)
+#define HRPWM_setRisingEdgeDelayLoadMode(base, loadEvent)               ((void)0)
+#define HRPWM_setFallingEdgeDelayLoadMode(base, loadEvent)              ((void)0)
+#define HRPWM_setMEPStep(base, mepCount)                                ((void)0)
+#define HRPWM_setTimeBasePeriod(base, periodCount)                      ((void)0)
+
+void EPWM_setTimeBasePeriod(uint32_t base, uint16_t periodCount);
+void EPWM_setPhaseShift(uint32_t base, uint16_t phaseCount);
+void EPWM_enablePhaseShiftLoad(uint32_t base);
+void EPWM_disablePhaseShiftLoad(uint32_t base);
+void EPWM_setSyncOutPulseMode(uint32_t base, EPWM_SyncOutPulseMode mode);
+void EPWM_setCounterCompareValue(uint32_t base, EPWM_CounterCompareModule compModule,
+                                 uint16_t compCount);
+void HRPWM_setCounterCompareValue(uint32_t base, HRPWM_CounterCompareModule compModule,
+                                  uint32_t compCount);
+void HRPWM_setChannelBOutputPath(uint32_t base, HRPWM_ChannelBOutput outputOnB);
+
+void EPWM_enableADCTrigger(uint32_t base, EPWM_ADCStartOfConversionType adcSOCType);
+void EPWM_disableADCTrigger(uint32_t base, EPWM_ADCStartOfConversionType adcSOCType);
+void EPWM_setADCTriggerSource(uint32_t base, EPWM_ADCStartOfConversionType adcSOCType,
+                              EPWM_ADCStartOfConversionSource socSource);
+void EPWM_setADCTriggerEventPrescale(uint32_t base, EPWM_ADCStartOfConversionType adcSOCType,
+                                     uint16_t preScaleCount);
+void EPWM_setADCTriggerEventCountInitValue(uint32_t base, EPWM_ADCStartOfConversionType adcSOCType,
+                                           uint16_t eventCount);
+void EPWM_forceADCTriggerEventCountInit(uint32_t base, EPWM_ADCStartOfConversionType adcSOCType);
+#define EPWM_enableADCTriggerEventCountInit(base, adcSOCType)           ((void)0)
+
+
+/**********************************************************
+ *                  C P U   T I M E R S
+ **********************************************************/
+
+#define CPUTimer_setEmulationMode(base, mode)                           ((void)0)
+#define CPUTimer_selectClockSource(base, source, prescaler)             ((void)0)
+
+void CPUTimer_setPeriod(uint32_t base, uint32_t periodCount);
+void CPUTimer_setPreScaler(uint32_t base, uint16_t prescaler);
+void CPUTimer_stopTimer(uint32_t base);
+void CPUTimer_startTimer(uint32_t base);
+void CPUTimer_reloadTimerCounter(uint32_t base);
+void CPUTimer_enableInterrupt(uint32_t base);
+uint32_t CPUTimer_getTimerCount(uint32_t base);
+
+
+/**********************************************************
+ *                  I N T E R R U P T S
+ **********************************************************/
+
+#define INTERRUPT_ACK_GROUP1    0x1U
+#define INTERRUPT_ACK_GROUP7    0x40U
+#define INTERRUPT_ACK_GROUP10   0x200U
+
+#define Interrupt_initModule()                                          ((void)0)
+#define Interrupt_initVectorTable()                                     ((void)0)
+
+void Interrupt_register(uint32_t interruptNumber, void (*handler)(void));
+void Interrupt_enable(uint32_t interruptNumber);
+void Interrupt_disable(uint32_t interruptNumber);
+void Interrupt_clearACKGroup(uint16_t group);
+bool Interrupt_enableGlobal(void);     // return true if interrupts were disabled
+bool Interrupt_disableGlobal(void);
+
+
+/**********************************************************
+ *                          D M A
+ **********************************************************/
+
+typedef enum {
+    DMA_TRIGGER_SOFTWARE    = 0,
+    DMA_TRIGGER_ADCA1       = 1,
+    DMA_TRIGGER_ADCA2       = 2,
+    DMA_TRIGGER_ADCA3       = 3,
+    DMA_TRIGGER_ADCA4       = 4,
+    DMA_TRIGGER_ADCAEVT     = 5,
+    DMA_TRIGGER_ADCB1       = 6,
+    DMA_TRIGGER_ADCB2       = 7,
+    DMA_TRIGGER_ADCB3       = 8,
+    DMA_TRIGGER_ADCB4       = 9,
+    DMA_TRIGGER_ADCBEVT     = 10,
+    DMA_TRIGGER_ADCC1       = 11,
+    DMA_TRIGGER_ADCC2       = 12,
+    DMA_TRIGGER_ADCC3       = 13,
+    DMA_TRIGGER_ADCC4       = 14
+} DMA_Trigger;
+
+typedef enum {
+    DMA_INT_AT_BEGINNING,
+    DMA_INT_AT_END
+} DMA_InterruptMode;
+
+typedef enum {
+    DMA_EMULATION_STOP,
+    DMA_EMULATION_FREE_RUN
+} DMA_EmulationMode;
+
+#define DMA_CFG_ONESHOT_DISABLE     0x0U
+#define DMA_CFG_ONESHOT_ENABLE      0x1U
+#define DMA_CFG_CONTINUOUS_DISABLE  0x0U
+#define DMA_CFG_CONTINUOUS_ENABLE   0x2U
+#define DMA_CFG_SIZE_16BIT          0x0U
+#define DMA_CFG_SIZE_32BIT          0x4U
+
+#define DMA_initController()                                            ((void)0)
+#define DMA_setEmulationMode(mode)                                      ((void)0)
+
+void DMA_configAddresses(uint32_t base, const void * destAddr, const void * srcAddr);
+void DMA_configBurst(uint32_t base, uint16_t size, int16_t srcStep, int16_t destStep);
+void DMA_configTransfer(uint32_t base, uint32_t transferSize, int16_t srcStep, int16_t destStep);
+void DMA_configMode(uint32_t base, DMA_Trigger trigger, uint32_t config);
+void DMA_setInterruptMode(uint32_t base, DMA_InterruptMode mode);
+void DMA_enableInterrupt(uint32_t base);
+void DMA_disableInterrupt(uint32_t base);
+void DMA_enableTrigger(uint32_t base);
+void DMA_disableTrigger(uint32_t base);
+void DMA_startChannel(uint32_t base);
+void DMA_stopChannel(uint32_t base);
+
+
+/**********************************************************
+ *                      C L A / M E M C F G
+ **********************************************************/
+
+typedef enum {
+    CLA_MVECT_1,
+    CLA_MVECT_2,
+    CLA_MVECT_3,
+    CLA_MVECT_4,
+    CLA_MVECT_5,
+    CLA_MVECT_6,
+    CLA_MVECT_7,
+    CLA_MVECT_8
+} CLA_MVECTNumber;
+
+typedef enum {
+    CLA_TASK_1,
+    CLA_TASK_2,
+    CLA_TASK_3,
+    CLA_TASK_4,
+    CLA_TASK_5,
+    CLA_TASK_6,
+    CLA_TASK_7,
+    CLA_TASK_8
+} CLA_TaskNumber;
+
+typedef enum {
+    CLA_TRIGGER_SOFTWARE    = 0,
+    CLA_TRIGGER_ADCA1       = 1,
+    CLA_TRIGGER_ADCA2       = 2,
+    CLA_TRIGGER_ADCA3       = 3,
+    CLA_TRIGGER_ADCA4       = 4,
+    CLA_TRIGGER_ADCAEVT     = 5,
+    CLA_TRIGGER_ADCB1       = 6,
+    CLA_TRIGGER_ADCB2       = 7,
+    CLA_TRIGGER_ADCB3       = 8,
+    CLA_TRIGGER_ADCB4       = 9,
+    CLA_TRIGGER_ADCBEVT     = 10,
+    CLA_TRIGGER_ADCC1       = 11,
+    CLA_TRIGGER_ADCC2       = 12,
+    CLA_TRIGGER_ADCC3       = 13,
+    CLA_TRIGGER_ADCC4       = 14
+} CLA_Trigger;
+
+#define CLA_TASKFLAG_1          0x01U
+#define CLA_TASKFLAG_2          0x02U
+#define CLA_TASKFLAG_3          0x04U
+#define CLA_TASKFLAG_4          0x08U
+#define CLA_TASKFLAG_5          0x10U
+#define CLA_TASKFLAG_6          0x20U
+#define CLA_TASKFLAG_7          0x40U
+#define CLA_TASKFLAG_8          0x80U
+#define CLA_TASKFLAG_ALL        0xFFU
+
+#define MEMCFG_SECT_LS4             0x01000010U
+#define MEMCFG_SECT_LS5             0x01000020U
+#define MEMCFG_SECT_LS6             0x01000040U
+#define MEMCFG_SECT_LS7             0x01000080U
+#define MEMCFG_SECT_MSGX_ALL        0x03000006U
+
+#define MemCfg_setLSRAMMasterSel(ramSection, masterSel)                 ((void)0)
+#define MemCfg_setCLAMemType(ramSections, claMemType)                   ((void)0)
+#define MemCfg_initSections(ramSections)                                ((void)0)
+#define MemCfg_getInitStatus(ramSections)                               (true)
+#define CLA_enableIACK(base)                                            ((void)0)
+
+/*
+ * The C28x takes a 16-bit CLA program address; the simulator looks up
+ * Cla1Task<n> for CLA_MVECT_<n> instead, see sim_hal.c.
+ */
+#define CLA_mapTaskVector(base, claIntVect, claTaskAddr)                sim_cla_map_task(claIntVect)
+
+void sim_cla_map_task(CLA_MVECTNumber claIntVect);
+void CLA_setTriggerSource(CLA_TaskNumber taskNumber, CLA_Trigger trigger);
+void CLA_enableTasks(uint32_t base, uint16_t taskFlags);
+void CLA_disableTasks(uint32_t base, uint16_t taskFlags);
+
+
+/**********************************************************
+ *                  S Y S C T L / G P I O
+ **********************************************************/
+
+typedef enum {
+    SYSCTL_PERIPH_CLK_EPWM1 = 0x0002,
+    SYSCTL_PERIPH_CLK_EPWM2 = 0x0102,
+    SYSCTL_PERIPH_CLK_EPWM3 = 0x0202,
+    SYSCTL_PERIPH_CLK_EPWM4 = 0x0302,
+    SYSCTL_PERIPH_CLK_EPWM5 = 0x0402,
+    SYSCTL_PERIPH_CLK_EPWM6 = 0x0502,
+    SYSCTL_PERIPH_CLK_EPWM7 = 0x0602,
+    SYSCTL_PERIPH_CLK_EPWM8 = 0x0702
+} SysCtl_PeripheralPCLOCKCR;
+
+typedef enum {
+    SYSCTL_SYNC_IN_EPWM4 = 0,
+    SYSCTL_SYNC_IN_EPWM7 = 3
+} SysCtl_SyncInput;
+
+typedef enum {
+    SYSCTL_SYNC_IN_SRC_EPWM1SYNCOUT = 0,
+    SYSCTL_SYNC_IN_SRC_EPWM4SYNCOUT = 1,
+    SYSCTL_SYNC_IN_SRC_EPWM7SYNCOUT = 2,
+    SYSCTL_SYNC_IN_SRC_EXTSYNCIN1 = 5
+} SysCtl_SyncInputSource;
+
+#define SysCtl_enablePeripheral(peripheral)                             ((void)0)
+#define SysCtl_disablePeripheral(peripheral)                            ((void)0)
+#define SysCtl_setWatchdogMode(mode)                                    ((void)0)
+#define SysCtl_setWatchdogPredivider(predivider)                        ((void)0)
+#define SysCtl_setWatchdogPrescaler(prescaler)                          ((void)0)
+#define SysCtl_serviceWatchdog()                                        ((void)0)
+#define SysCtl_enableWatchdog()                                         ((void)0)
+#define SysCtl_disableWatchdog()                                        ((void)0)
+
+void SysCtl_setSyncInputConfig(SysCtl_SyncInput syncInput, SysCtl_SyncInputSource syncSrc);
+
+#define GPIO_setPadConfig(pin, pinType)                                 ((void)0)
+#define GPIO_setPinConfig(pinConfig)                                    ((void)0)
+#define GPIO_setDirectionMode(pin, pinIO)                               ((void)0)
+#define GPIO_writePin(pin, outVal)                                      ((void)0)
+#define GPIO_togglePin(pin)                                             ((void)0)
+
+#endif /* SIM_DRIVERLIB_H_ */
@@ -0,0 +1,499 @@
+/*
+ * plant.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  All converters are modelled with state-space averaging over one switching
+ *  period, so the duty cycle is the only input. The inductor currents are
+ *  clamped at zero, matching the diode-emulation behaviour of
+ *  change_pwm_duty_cycle() at 0% and keeping the battery from back-feeding
+ *  the panels.
+ *
+ *  plant_sense_ripple() adds back the switching ripple the ADC would see on
+ *  top of the averaged nets, from the averaged state and the position in the
+ *  switching period. Only the PV bucks' ripple is represented: their
+ *  inductor current triangles and input capacitor voltage, the panel
+ *  current that follows that voltage along the I-V curve, and the battery
+ *  current and voltage they cause. The output bucks' input current pulses
+ *  are assumed to be absorbed by their own input capacitors, and their
+ *  output ripple is below an LSB.
+ *
+ *  A panel follows the single-diode equation with series and shunt
+ *  resistance,
+ *      I = Iph - i0 * (exp((V + I*Rs) / vt) - 1) - (V + I*Rs) / Rsh
+ *  which is implicit in I. It is solved by Newton's method: from the panel
+ *  current of the previous integration step one iteration is enough, since
+ *  the voltage hardly moves in 100ns, and a cold solve starts from the
+ *  Rs = 0 current, which is never below the answer, so it converges from
+ *  one side in a few.
+ *
+ *  A panel is PV_SUBSTRINGS series substrings of cells, each with a bypass
+ *  diode. plant_set_shading() lowers the irradiance on one of them, which
+ *  gives the P-V curve a second maximum.
+ */
+
+#include <math.h>
+
+#include "config.h"
+#include "plant.h"
+
+/** POWER STAGE COMPONENTS **/
+#define PV_ISC                  1.25f       // [A]
+#define PV_VOC                  21.6f       // [V]
+#define PV_CELLS                36.0f
+#define PV_IDEALITY             1.3f
+#define PV_THERMAL_V            0.0257f     // [V] at 25C
+#define PV_R_SERIES             0.4f        // [Ohms] cell contacts and interconnects
+#define PV_R_SHUNT              250.0f      // [Ohms] leakage across the cells
+#define PV_SUBSTRINGS           3U          // cells in series between bypass diodes
+#define PV_BYPASS_VF            0.4f        // [V] substring bypass diode
+#define PV_BUCK_L               22e-6f      // [H]
+#define PV_BUCK_C_IN            47e-6f      // [F]
+#define PV_BUCK_R_L             0.03f       // [Ohms] inductor + switch
+
+#define OUT_BUCK_L              10e-6f      // [H]
+#define OUT_BUCK_C              47e-6f      // [F]
+#define OUT_BUCK_R_L            0.02f       // [Ohms]
+#define BUCK_5V_R_LOAD          10.0f       // [Ohms] 500mA
+#define BUCK_3V3_R_LOAD         6.6f        // [Ohms] 500mA
+
+#define BATTERY_CELLS           2.0f
+#define BATTERY_CAPACITY_AH     2.0f
+#define BATTERY_R_INT           0.08f       // [Ohms]
+#define BATTERY_SOC_INIT        0.5f
+
+#define ADC_PIN_MAX_V           3.3f
+#define PLANT_PV_MPP_GRID       256U        // coarse points before the golden-section search
+#define PLANT_PV_NEWTON         4U          // iterations of a cold single-diode solve
+#define PLANT_PV_SLOPE_DV       0.05f       // [V] either side of the panel voltage for a shaded curve's slope
+
+/* Li-ion cell open-circuit voltage, 10% SOC steps */
+static const float cell_ocv[11] = {
+    3.00f, 3.45f, 3.55f, 3.62f, 3.68f, 3.74f, 3.81f, 3.89f, 3.96f, 4.05f, 4.15f
+};
+
+
+static void plant_pv_init(PlantPV_t * pv) {
+    pv->isc = PV_ISC;
+    pv->voc = PV_VOC;
+    pv->vt = PV_CELLS * PV_IDEALITY * PV_THERMAL_V;
+    pv->rs = PV_R_SERIES;
+    pv->rsh = PV_R_SHUNT;
+    // short circuit loses Isc*Rs/Rsh to the shunt, open circuit Voc/Rsh
+    pv->iph = PV_ISC * (1.0f + (PV_R_SERIES / PV_R_SHUNT));
+    pv->i0 = (pv->iph - (PV_VOC / PV_R_SHUNT)) / (expf(PV_VOC / pv->vt) - 1.0f);
+    pv->c_in = PV_BUCK_C_IN;
+    pv->l = PV_BUCK_L;
+    pv->i_l = 0.0f;
+    pv->irradiance = 1.0f;
+    pv->shading = 1.0f;
+    pv->v = PV_VOC;
+    pv->i_pv = 0.0f;
+}
+
+static void plant_buck_init(PlantBuck_t * buck, float r_load, float v_nominal) {
+    buck->l = OUT_BUCK_L;
+    buck->c = OUT_BUCK_C;
+    buck->r_load = r_load;
+    buck->v_nominal = v_nominal;
+    buck->v = 0.0f;
+    buck->i_l = 0.0f;
+}
+
+void plant_init(Plant_t * plant) {
+    plant_pv_init(&plant->pv[PLANT_PV1]);
+    plant_pv_init(&plant->pv[PLANT_PV2]);
+
+    plant_buck_init(&plant->buck[0], BUCK_5V_R_LOAD, 5.0f);
+    plant_buck_init(&plant->buck[1], BUCK_3V3_R_LOAD, 3.3f);
+
+    plant->battery.capacity = BATTERY_CAPACITY_AH * 3600.0f;
+    plant->battery.soc = BATTERY_SOC_INIT;
+    plant->battery.r_int = BATTERY_R_INT;
+    plant->battery.i = 0.0f;
+    plant->battery.v = plant_battery_ocv(BATTERY_SOC_INIT);
+}
+
+/**
+ * @brief Diode voltage of one substring carrying the string current
+ *
+ * @details Solves iph - i = i0 * (exp(vd/vt_sub) - 1) + vd/rsh_sub, starting
+ *      from the voltage without the shunt, which is never below the answer.
+ *      Once the current is more than the substring makes its bypass diode
+ *      conducts.
+ */
+static float plant_pv_substring_v(const PlantPV_t * pv, float iph, float i) {
+    const float vt_sub = pv->vt / (float)PV_SUBSTRINGS;
+    const float rsh_sub = pv->rsh / (float)PV_SUBSTRINGS;
+    float vd;
+    uint32_t n;
+
+    if(i >= iph) {
+        return -PV_BYPASS_VF;
+    }
+    vd = vt_sub * logf(((iph - i) / pv->i0) + 1.0f);
+    for(n = 0; n < PLANT_PV_NEWTON; n++) {
+        float e = pv->i0 * expf(vd / vt_sub);
+        vd -= ((e - pv->i0) + (vd / rsh_sub) - (iph - i)) / ((e / vt_sub) + (1.0f / rsh_sub));
+    }
+    return vd;
+}
+
+/**
+ * @brief Tabulates the I-V curve of a panel with one substring shaded
+ *
+ * @details With the string current as the unknown the substrings are
+ *      independent, and the series resistance drops I*Rs across all of them.
+ */
+static void plant_pv_tabulate(PlantPV_t * pv) {
+    const float iph_sun = pv->iph * pv->irradiance;
+    const float iph_shade = iph_sun * pv->shading;
+    uint32_t n;
+
+    for(n = 0; n < PLANT_PV_CURVE_POINTS; n++) {
+        float i = (iph_sun * (float)n) / (float)PLANT_PV_CURVE_POINTS;
+        float v = (float)(PV_SUBSTRINGS - 1U) * plant_pv_substring_v(pv, iph_sun, i);
+
+        v += plant_pv_substring_v(pv, iph_shade, i) - (i * pv->rs);
+        pv->curve_v[n] = v;
+        pv->curve_i[n] = i;
+    }
+}
+
+void plant_set_irradiance(Plant_t * plant, uint32_t pv, float irradiance) {
+    if(irradiance < 0.0f) {
+        irradiance = 0.0f;
+    }
+    plant->pv[pv].irradiance = irradiance;
+    if(plant->pv[pv].shading < 1.0f) {
+        plant_pv_tabulate(&plant->pv[pv]);
+    }
+}
+
+/**
+ * @param shading Irradiance on one substring as a fraction of the other's,
+ *      1.0 for none
+ */
+void plant_set_shading(Plant_t * plant, uint32_t pv, float shading) {
+    shading = (shading < 0.0f) ? 0.0f : shading;
+    plant->pv[pv].shading = (shading > 1.0f) ? 1.0f : shading;
+    if(plant->pv[pv].shading < 1.0f) {
+        plant_pv_tabulate(&plant->pv[pv]);
+    }
+}
+
+/**
+ * @param soc State of charge, 0.0 - 1.0
+ *
+ * @param capacity_ah Capacity [Ah], negative keeps it
+ *
+ * @param r_int Internal resistance [Ohm], negative keeps it
+ */
+void plant_set_battery(Plant_t * plant, float soc, float capacity_ah, float r_int) {
+    soc = (soc < 0.0f) ? 0.0f : soc;
+    plant->battery.soc = (soc > 1.0f) ? 1.0f : soc;
+    if(capacity_ah > 0.0f) {
+        plant->battery.capacity = capacity_ah * 3600.0f;
+    }
+    if(r_int >= 0.0f) {
+        plant->battery.r_int = r_int;
+    }
+    plant->battery.i = 0.0f;
+    plant->battery.v = plant_battery_ocv((float)plant->battery.soc);
+}
+
+/**
+ * @brief Newton iterations of the single-diode equation for the current
+ *
+ * @param i Starting current [A]
+ */
+static float plant_pv_newton(const PlantPV_t * pv, float v, float i, uint32_t iterations) {
+    const float iph = pv->iph * pv->irradiance;
+    uint32_t n;
+
+    for(n = 0; n < iterations; n++) {
+        float vd = v + (i * pv->rs);
+        float e = pv->i0 * expf(vd / pv->vt);
+        float f = iph - (e - pv->i0) - (vd / pv->rsh) - i;
+
+        i += f / (1.0f + (pv->rs * ((e / pv->vt) + (1.0f / pv->rsh))));
+    }
+    return i;
+}
+
+/**
+ * @brief Panel current from the single-diode equation
+ *
+ * @details The panel cannot sink current (bypass/blocking diode). A shaded
+ *      panel interpolates its tabulated curve.
+ */
+float plant_pv_current(const PlantPV_t * pv, float v) {
+    if(pv->shading < 1.0f) {
+        uint32_t lo = 0;
+        uint32_t hi = PLANT_PV_CURVE_POINTS - 1U;
+
+        if(v >= pv->curve_v[0]) {
+            return 0.0f;
+        }
+        if(v <= pv->curve_v[hi]) {
+            return pv->curve_i[hi];
+        }
+        // curve_v falls with the index
+        while((hi - lo) > 1U) {
+            uint32_t mid = (lo + hi) / 2U;
+            if(pv->curve_v[mid] > v) {
+                lo = mid;
+            }
+            else {
+                hi = mid;
+            }
+        }
+        return pv->curve_i[lo] + (((pv->curve_i[hi] - pv->curve_i[lo]) * (pv->curve_v[lo] - v))
+                                  / (pv->curve_v[lo] - pv->curve_v[hi]));
+    }
+
+    float i = (pv->iph * pv->irradiance) - (pv->i0 * (expf(v / pv->vt) - 1.0f)) - (v / pv->rsh);
+    i = plant_pv_newton(pv, v, i, PLANT_PV_NEWTON);
+    return (i > 0.0f) ? i : 0.0f;
+}
+
+/**
+ * @brief Finds the global maximum power point
+ *
+ * @details A grid search picks the highest of the local maxima, then a
+ *      golden-section search refines it between the neighbouring points.
+ *
+ * @return Maximum available power [W], v_mpp receives the voltage if not NULL
+ */
+float plant_pv_mpp(const PlantPV_t * pv, float * v_mpp) {
+    const float ratio = 0.6180340f;
+    const float grid = (pv->voc * 1.1f) / (float)PLANT_PV_MPP_GRID;
+    float p_best = -1.0f;
+    uint32_t best = 0;
+    uint32_t i;
+
+    for(i = 0; i <= PLANT_PV_MPP_GRID; i++) {
+        float v = grid * (float)i;
+        float p = v * plant_pv_current(pv, v);
+        if(p > p_best) {
+            p_best = p;
+            best = i;
+        }
+    }
+
+    float lo = (best > 0) ? (grid * (float)(best - 1U)) : 0.0f;
+    float hi = grid * (float)(best + 1U);
+    float a = hi - (ratio * (hi - lo));
+    float b = lo + (ratio * (hi - lo));
+
+    for(i = 0; i < 48; i++) {
+        if((a * plant_pv_current(pv, a)) > (b * plant_pv_current(pv, b))) {
+            hi = b;
+        }
+        else {
+            lo = a;
+        }
+        a = hi - (ratio * (hi - lo));
+        b = lo + (ratio * (hi - lo));
+    }
+
+    float v = 0.5f * (lo + hi);
+    if(v_mpp != 0) {
+        *v_mpp = v;
+    }
+    return v * plant_pv_current(pv, v);
+}
+
+float plant_battery_ocv(float soc) {
+    if(soc <= 0.0f) {
+        return BATTERY_CELLS * cell_ocv[0];
+    }
+    if(soc >= 1.0f) {
+        return BATTERY_CELLS * cell_ocv[10];
+    }
+    float x = soc * 10.0f;
+    uint32_t n = (uint32_t)x;
+    float frac = x - (float)n;
+    return BATTERY_CELLS * (cell_ocv[n] + (frac * (cell_ocv[n + 1] - cell_ocv[n])));
+}
+
+/**
+ * @brief Advances the averaged model by dt seconds
+ *
+ * @param duty Duty cycle of each converter, 0.0 - 1.0
+ */
+void plant_step(Plant_t * plant, const float duty[PLANT_CONVERTER_COUNT], float dt) {
+    PlantBattery_t * battery = &plant->battery;
+    float i_battery = 0.0f;
+    uint32_t n;
+
+    // PV bucks charge the battery
+    for(n = 0; n < 2; n++) {
+        PlantPV_t * pv = &plant->pv[n];
+        float d = duty[PLANT_PV1 + n];
+
+        if(pv->shading < 1.0f) {
+            pv->i_pv = plant_pv_current(pv, pv->v);
+        }
+        else {
+            // from the last step's current, the voltage has barely moved
+            pv->i_pv = plant_pv_newton(pv, pv->v, pv->i_pv, 1U);
+            pv->i_pv = (pv->i_pv > 0.0f) ? pv->i_pv : 0.0f;
+        }
+        pv->i_l += dt * ((d * pv->v) - battery->v - (pv->i_l * PV_BUCK_R_L)) / pv->l;
+        if(pv->i_l < 0.0f) {
+            pv->i_l = 0.0f;
+        }
+        pv->v += dt * (pv->i_pv - (d * pv->i_l)) / pv->c_in;
+        if(pv->v < 0.0f) {
+            pv->v = 0.0f;
+        }
+        i_battery += pv->i_l;
+    }
+
+    // output bucks discharge it
+    for(n = 0; n < 2; n++) {
+        PlantBuck_t * buck = &plant->buck[n];
+        float d = duty[PLANT_BUCK_5V + n];
+
+        buck->i_l += dt * ((d * battery->v) - buck->v - (buck->i_l * OUT_BUCK_R_L)) / buck->l;
+        if(buck->i_l < 0.0f) {
+            buck->i_l = 0.0f;
+        }
+        buck->v += dt * (buck->i_l - (buck->v / buck->r_load)) / buck->c;
+        i_battery -= d * buck->i_l;
+    }
+
+    battery->i = i_battery;
+    battery->soc += (double)(i_battery * dt) / (double)battery->capacity;
+    battery->v = plant_battery_ocv((float)battery->soc) + (battery->r_int * i_battery);
+}
+
+
+/**
+ * @brief Voltage presented to the ADC pin for a sensed net
+ */
+float plant_sense(const Plant_t * plant, ePlantSignal signal) {
+    float v;
+
+    switch(signal) {
+    case(Plant_PV1_V):      v = VOLTAGE_DIVDER(plant->pv[PLANT_PV1].v, V_PV_SENSE_R1, V_PV_SENSE_R2); break;
+    case(Plant_PV2_V):      v = VOLTAGE_DIVDER(plant->pv[PLANT_PV2].v, V_PV_SENSE_R1, V_PV_SENSE_R2); break;
+    case(Plant_PV1_I):      v = V_IOUT_Q + (plant->pv[PLANT_PV1].i_pv * I_SENSE_SENS / 1000.0f); break;
+    case(Plant_PV2_I):      v = V_IOUT_Q + (plant->pv[PLANT_PV2].i_pv * I_SENSE_SENS / 1000.0f); break;
+    case(Plant_Buck_5V_V):  v = VOLTAGE_DIVDER(plant->buck[0].v, BUCK_5V_OUTPUT_R1, BUCK_5V_OUTPUT_R2); break;
+    case(Plant_Buck_3V3_V): v = VOLTAGE_DIVDER(plant->buck[1].v, BUCK_3V3_OUTPUT_R1, BUCK_3V3_OUTPUT_R2); break;
+    case(Plant_Battery_V):  v = VOLTAGE_DIVDER(plant->battery.v, V_BATT_SENSE_R1, V_BATT_SENSE_R2); break;
+    case(Plant_Battery_I):  v = V_IOUT_Q + (plant->battery.i * I_SENSE_SENS / 1000.0f); break;
+    default:                v = 0.0f; break;
+    }
+
+    if(v < 0.0f) {
+        v = 0.0f;
+    }
+    else if(v > ADC_PIN_MAX_V) {
+        v = ADC_PIN_MAX_V;
+    }
+    return v;
+}
+
+
+/**
+ * @brief Buck inductor current ripple shape, -0.5 at turn-on, +0.5 at turn-off
+ *
+ * @details Crosses zero, the switching-period average, at mid on-time and
+ *      mid off-time.
+ */
+static float ripple_shape(float d, float phase) {
+    if((d <= 0.0f) || (d >= 1.0f)) {
+        return 0.0f;
+    }
+    if(phase < d) {
+        return (phase / d) - 0.5f;
+    }
+    return 0.5f - ((phase - d) / (1.0f - d));
+}
+
+/* Peak-to-peak inductor current ripple of a PV buck [A] */
+static float pv_ripple_pp(const Plant_t * plant, uint32_t n, float d, float period) {
+    const PlantPV_t * pv = &plant->pv[n];
+    float di = (pv->v - plant->battery.v) * d * period / pv->l;
+    return ((pv->i_l > 0.0f) && (di > 0.0f)) ? di : 0.0f;
+}
+
+/* Ripple of the PV input capacitor voltage [V], it discharges during on-time */
+static float pv_v_ripple(const Plant_t * plant, uint32_t n, float d, float phase, float period) {
+    const PlantPV_t * pv = &plant->pv[n];
+    float dv = (pv->i_l - pv->i_pv) * d * period / pv->c_in;
+    return (dv > 0.0f) ? (-dv * ripple_shape(d, phase)) : 0.0f;
+}
+
+/*
+ * Slope of a panel's I-V curve where it works [A/V]. The derivative of the
+ * single-diode equation, or a difference across the shaded curve.
+ */
+static float pv_di_dv(const PlantPV_t * pv) {
+    float g;
+
+    if(pv->i_pv <= 0.0f) {
+        return 0.0f;
+    }
+    if(pv->shading < 1.0f) {
+        return (plant_pv_current(pv, pv->v + PLANT_PV_SLOPE_DV) - plant_pv_current(pv, pv->v - PLANT_PV_SLOPE_DV))
+               / (2.0f * PLANT_PV_SLOPE_DV);
+    }
+    g = (pv->i0 * expf((pv->v + (pv->i_pv * pv->rs)) / pv->vt) / pv->vt) + (1.0f / pv->rsh);
+    return -g / (1.0f + (pv->rs * g));
+}
+
+/* Ripple of the panel current [A], along the I-V curve with the voltage's */
+static float pv_i_ripple(const Plant_t * plant, uint32_t n, float d, float phase, float period) {
+    return pv_di_dv(&plant->pv[n]) * pv_v_ripple(plant, n, d, phase, period);
+}
+
+/* Ripple of the battery current [A], the sum of the PV inductor currents */
+static float battery_i_ripple(const Plant_t * plant, const float duty[PLANT_CONVERTER_COUNT],
+                              const float phase[PLANT_CONVERTER_COUNT], float period) {
+    float i = 0.0f;
+    uint32_t n;
+
+    for(n = 0; n < 2; n++) {
+        float d = duty[PLANT_PV1 + n];
+        i += pv_ripple_pp(plant, n, d, period) * ripple_shape(d, phase[PLANT_PV1 + n]);
+    }
+    return i;
+}
+
+/**
+ * @brief Switching ripple at the ADC pin of a sensed net, on top of
+ *      plant_sense()
+ *
+ * @param duty Duty cycle of each converter, 0.0 - 1.0
+ * @param phase Position of each converter in its switching period, 0.0 at
+ *      turn-on (counter zero) - 1.0
+ * @param period Switching period [s]
+ *
+ * @return [V] at the pin
+ */
+float plant_sense_ripple(const Plant_t * plant, ePlantSignal signal, const float duty[PLANT_CONVERTER_COUNT],
+                         const float phase[PLANT_CONVERTER_COUNT], float period) {
+    switch(signal) {
+    case(Plant_PV1_V):
+        return VOLTAGE_DIVDER(pv_v_ripple(plant, 0, duty[PLANT_PV1], phase[PLANT_PV1], period),
+                              V_PV_SENSE_R1, V_PV_SENSE_R2);
+    case(Plant_PV2_V):
+        return VOLTAGE_DIVDER(pv_v_ripple(plant, 1, duty[PLANT_PV2], phase[PLANT_PV2], period),
+                              V_PV_SENSE_R1, V_PV_SENSE_R2);
+    case(Plant_PV1_I):
+        return pv_i_ripple(plant, 0, duty[PLANT_PV1], phase[PLANT_PV1], period) * I_SENSE_SENS / 1000.0f;
+    case(Plant_PV2_I):
+        return pv_i_ripple(plant, 1, duty[PLANT_PV2], phase[PLANT_PV2], period) * I_SENSE_SENS / 1000.0f;
+    case(Plant_Battery_V):
+        return VOLTAGE_DIVDER(plant->battery.r_int * battery_i_ripple(plant, duty, phase, period),
+                              V_BATT_SENSE_R1, V_BATT_SENSE_R2);
+    case(Plant_Battery_I):
+        return battery_i_ripple(plant, duty, phase, period) * I_SENSE_SENS / 1000.0f;
+    default:
+        return 0.0f;
+    }
+}
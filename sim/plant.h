@@ -0,0 +1,94 @@
+/*
+ * plant.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Averaged (switching-cycle mean) model of the power stage: two PV panels
+ *  each feeding the battery through a buck, the 2S battery, and the 5V and
+ *  3.3V output bucks running from the battery.
+ */
+
+#ifndef SIM_PLANT_H_
+#define SIM_PLANT_H_
+
+#include <stdint.h>
+
+/** Converter indices used for duty cycle inputs */
+#define PLANT_PV1               0U
+#define PLANT_PV2               1U
+#define PLANT_BUCK_5V           2U
+#define PLANT_BUCK_3V3          3U
+#define PLANT_CONVERTER_COUNT   4U
+
+/** Analog nets that reach an ADC pin */
+typedef enum {
+    Plant_No_Signal,
+    Plant_PV1_V,
+    Plant_PV1_I,
+    Plant_PV2_V,
+    Plant_PV2_I,
+    Plant_Buck_5V_V,
+    Plant_Buck_3V3_V,
+    Plant_Battery_V,
+    Plant_Battery_I,
+    Plant_Signal_Count
+} ePlantSignal;
+
+#define PLANT_PV_CURVE_POINTS   1024U
+
+typedef struct {
+    float isc;          // [A] short-circuit current at full irradiance
+    float voc;          // [V] open-circuit voltage at full irradiance
+    float vt;           // [V] cells * ideality * thermal voltage
+    float i0;           // [A] diode saturation current
+    float iph;          // [A] photocurrent at full irradiance
+    float rs;           // [Ohms] series resistance
+    float rsh;          // [Ohms] shunt resistance
+    float irradiance;   // 0.0 - 1.0 of full sun
+    float shading;      // irradiance on half of the cells, fraction of irradiance
+    float c_in;         // [F] converter input capacitance
+    float l;            // [H]
+    float v;            // [V] panel (input capacitor) voltage
+    float i_l;          // [A] inductor current
+    float i_pv;         // [A] panel current
+    float curve_v[PLANT_PV_CURVE_POINTS];   // [V] I-V curve when shaded, falling
+    float curve_i[PLANT_PV_CURVE_POINTS];   // [A]
+} PlantPV_t;
+
+typedef struct {
+    float l;            // [H]
+    float c;            // [F]
+    float r_load;       // [Ohms]
+    float v_nominal;    // [V]
+    float v;            // [V] output voltage
+    float i_l;          // [A] inductor current
+} PlantBuck_t;
+
+typedef struct {
+    float capacity;     // [A*s]
+    double soc;         // 0.0 - 1.0, a float step would round away a plant step's charge
+    float r_int;        // [Ohms]
+    float v;            // [V] terminal voltage
+    float i;            // [A] into the battery, charging is positive
+} PlantBattery_t;
+
+typedef struct {
+    PlantPV_t       pv[2];
+    PlantBuck_t     buck[2];
+    PlantBattery_t  battery;
+} Plant_t;
+
+void plant_init(Plant_t * plant);
+void plant_set_irradiance(Plant_t * plant, uint32_t pv, float irradiance);
+void plant_set_shading(Plant_t * plant, uint32_t pv, float shading);
+void plant_set_battery(Plant_t * plant, float soc, float capacity_ah, float r_int);
+void plant_step(Plant_t * plant, const float duty[PLANT_CONVERTER_COUNT], float dt);
+
+float plant_sense(const Plant_t * plant, ePlantSignal signal);
+float plant_sense_ripple(const Plant_t * plant, ePlantSignal signal, const float duty[PLANT_CONVERTER_COUNT],
+                         const float phase[PLANT_CONVERTER_COUNT], float period);
+float plant_battery_ocv(float soc);
+float plant_pv_current(const PlantPV_t * pv, float v);
+float plant_pv_mpp(const PlantPV_t * pv, float * v_mpp);
+
+#endif /* SIM_PLANT_H_ */
@@ -0,0 +1,143 @@
+/*
+ * profile.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Irradiance profiles after the EN 50530 MPPT tests. The standard's
+ *  dynamic test ramps between 10% and 50% and between 30% and 100% of
+ *  1000 W/m^2 at set slopes, with dwells in between, and scores the energy
+ *  harvested against the energy available over the whole sequence. Its
+ *  slowest ramps take minutes, which the simulator would take an hour to
+ *  run, so the slopes here are SIM_PROFILE_SPEEDUP times the standard's and
+ *  the dwells are short. The MPPT tick is not sped up, so a tracker sees a
+ *  harsher profile than the standard's and the dynamic efficiencies are
+ *  lower bounds.
+ *
+ *  The static profile holds a few irradiance levels, the steps profile jumps
+ *  between them, and the shading profile drops one substring of the panel
+ *  into shade and sweeps it out again.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "profile.h"
+
+#define SIM_PROFILE_SPEEDUP     100.0f
+#define SIM_PROFILE_DWELL       100.0f      // [ms] between ramps
+
+/* [ms] to ramp by dg of full sun at the standard's slope in W/m^2/s */
+#define RAMP_MS(dg, slope)      (((dg) * 1000.0f * 1000.0f) / ((slope) * SIM_PROFILE_SPEEDUP))
+
+#define DWELL(g)                { SIM_PROFILE_DWELL, (g), 1.0f }
+#define RAMP(g0, g1, slope)     { RAMP_MS((g1) - (g0), (slope)), (g1), 1.0f }, DWELL(g1), \
+                                { RAMP_MS((g1) - (g0), (slope)), (g0), 1.0f }, DWELL(g0)
+
+static const SimProfileSegment_t profile_static[] = {
+    { 250.0f, 0.1f, 1.0f },
+    { 0.0f, 0.3f, 1.0f }, { 250.0f, 0.3f, 1.0f },
+    { 0.0f, 0.6f, 1.0f }, { 250.0f, 0.6f, 1.0f },
+    { 0.0f, 1.0f, 1.0f }, { 250.0f, 1.0f, 1.0f },
+};
+
+/* 10% - 50% at 20 and 50 W/m^2/s */
+static const SimProfileSegment_t profile_low_medium[] = {
+    DWELL(0.1f),
+    RAMP(0.1f, 0.5f, 20.0f),
+    RAMP(0.1f, 0.5f, 50.0f),
+};
+
+/* 30% - 100% at 30 and 100 W/m^2/s */
+static const SimProfileSegment_t profile_medium_high[] = {
+    DWELL(0.3f),
+    RAMP(0.3f, 1.0f, 30.0f),
+    RAMP(0.3f, 1.0f, 100.0f),
+};
+
+static const SimProfileSegment_t profile_steps[] = {
+    { 200.0f, 0.3f, 1.0f },
+    { 0.0f, 1.0f, 1.0f }, { 200.0f, 1.0f, 1.0f },
+    { 0.0f, 0.3f, 1.0f }, { 200.0f, 0.3f, 1.0f },
+    { 0.0f, 0.6f, 1.0f }, { 200.0f, 0.6f, 1.0f },
+};
+
+/* one substring shaded to 30% moves the global peak to the lower voltage */
+static const SimProfileSegment_t profile_shading[] = {
+    { 200.0f, 0.8f, 1.0f },
+    { 0.0f, 0.8f, 0.3f }, { 600.0f, 0.8f, 0.3f },
+    { 200.0f, 0.8f, 1.0f }, { 200.0f, 0.8f, 1.0f },
+};
+
+#define PROFILE(name, description, table) \
+    { name, description, table[0].irradiance, table[0].shading, sizeof(table) / sizeof(table[0]), table }
+
+const SimProfile_t sim_profiles[] = {
+    PROFILE("static",       "10%, 30%, 60% and 100% sun held 250ms each",   profile_static),
+    PROFILE("en50530-lm",   "10% - 50% ramps at 20 and 50 W/m^2/s x100",    profile_low_medium),
+    PROFILE("en50530-mh",   "30% - 100% ramps at 30 and 100 W/m^2/s x100",  profile_medium_high),
+    PROFILE("steps",        "steps between 30%, 100% and 60% sun",          profile_steps),
+    PROFILE("shading",      "a substring shaded to 30% at 80% sun",         profile_shading),
+};
+
+const uint32_t sim_profile_count = sizeof(sim_profiles) / sizeof(sim_profiles[0]);
+
+
+const SimProfile_t * sim_profile_find(const char * name) {
+    uint32_t n;
+
+    for(n = 0; n < sim_profile_count; n++) {
+        if(strcmp(sim_profiles[n].name, name) == 0) {
+            return &sim_profiles[n];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @return Length of the profile [s]
+ */
+double sim_profile_duration(const SimProfile_t * profile) {
+    double ms = 0.0;
+    uint32_t n;
+
+    for(n = 0; n < profile->segments; n++) {
+        ms += (double)profile->segment[n].ms;
+    }
+    return ms / 1000.0;
+}
+
+/**
+ * @brief Irradiance and shading t seconds into the profile
+ *
+ * @details Past the end the last segment's values hold.
+ */
+void sim_profile_at(const SimProfile_t * profile, double t, SimProfilePoint_t * point) {
+    float irradiance = profile->irradiance;
+    float shading = profile->shading;
+    double start = 0.0;
+    uint32_t n;
+
+    for(n = 0; n < profile->segments; n++) {
+        const SimProfileSegment_t * segment = &profile->segment[n];
+        double end = start + ((double)segment->ms / 1000.0);
+
+        if(t < end) {
+            float f = (float)((t - start) / (end - start));
+
+            point->irradiance = irradiance + (f * (segment->irradiance - irradiance));
+            point->shading = shading + (f * (segment->shading - shading));
+            point->segment = n;
+            point->dwell = (segment->irradiance == irradiance) && (segment->shading == shading);
+            point->since = t - start;
+            return;
+        }
+        irradiance = segment->irradiance;
+        shading = segment->shading;
+        start = end;
+    }
+    point->irradiance = irradiance;
+    point->shading = shading;
+    point->segment = profile->segments;
+    point->dwell = true;
+    point->since = t - start;
+}
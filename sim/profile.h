@@ -0,0 +1,47 @@
+/*
+ * profile.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Irradiance and shading profiles for the MPPT benchmark: piecewise linear
+ *  ramps, steps and dwells on the panel under test.
+ */
+
+#ifndef SIM_PROFILE_H_
+#define SIM_PROFILE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** One piece of a profile, linear from where the previous one ended */
+typedef struct {
+    float ms;           // [ms] length, 0 for a step
+    float irradiance;   // at the end, 0.0 - 1.0 of full sun
+    float shading;      // at the end, see plant_set_shading()
+} SimProfileSegment_t;
+
+typedef struct {
+    const char * name;
+    const char * description;
+    float irradiance;   // at the start
+    float shading;
+    uint32_t segments;
+    const SimProfileSegment_t * segment;
+} SimProfile_t;
+
+typedef struct {
+    float irradiance;
+    float shading;
+    uint32_t segment;   // segments passed, == segments after the end
+    bool dwell;         // in a segment that holds the irradiance and shading
+    double since;       // [s] into the segment
+} SimProfilePoint_t;
+
+extern const SimProfile_t sim_profiles[];
+extern const uint32_t sim_profile_count;
+
+const SimProfile_t * sim_profile_find(const char * name);
+double sim_profile_duration(const SimProfile_t * profile);
+void sim_profile_at(const SimProfile_t * profile, double t, SimProfilePoint_t * point);
+
+#endif /* SIM_PROFILE_H_ */
@@ -0,0 +1,104 @@
+/*
+ * sim.h
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Glue between the simulated peripherals (sim_hal.c) and the scenario
+ *  runner (sim_main.c).
+ */
+
+#ifndef SIM_SIM_H_
+#define SIM_SIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "plant.h"
+#include "profile.h"
+
+#define SIM_SYSCLK_HZ           100000000ULL
+#define SIM_PLANT_STEP          10U         // [SYSCLK cycles] 100ns integration step
+#define SIM_ADC_CONV_CYCLES     42U         // 10.5 ADCCLK at ADC_CLK_DIV_4_0
+#define SIM_ADC_POLL_CYCLES     4U          // one pass of while(ADC_isBusy())
+#define SIM_ISR_LATENCY_CYCLES  16U         // PIE fetch and context save
+#define SIM_CLA_LATENCY_CYCLES  4U          // trigger to first task instruction
+
+/** V/I pairs, for sim_pair_stats() */
+#define SIM_PAIR_PV1            0U
+#define SIM_PAIR_PV2            1U
+#define SIM_PAIR_BATTERY        2U
+#define SIM_PAIR_COUNT          3U
+
+typedef struct {
+    double          duration;       // [s]
+    uint32_t        seed;
+    float           noise_lsb;      // ADC noise, 1 sigma
+    float           i_zero_mv;      // current sensor zero-current output error
+    float           irradiance[2];
+    double          step_time;      // [s] irradiance step, negative for none
+    float           step_irradiance;    // both panels after the step
+    const char *    mppt_strategy[2];   // overrides MPPT_1/2_STRATEGY, NULL keeps it
+    int32_t         scan_interval;  // overrides MPPT_1/2_SCAN_INTERVAL, negative keeps it
+    int32_t         dual_mode;      // overrides MPPT_DUAL_MODE, negative keeps it
+    bool            fast_start;     // false turns off MPPT_1/2_FAST_START
+    bool            pace;           // false turns off MPPT_1/2_PACE
+    bool            pv_loop;        // false turns off PV_LOOP_1/2_ENABLE
+    bool            charger_pi;     // false caps the MPPT steps without the charger's limit loops
+    bool            ir_comp;        // false leaves the battery's resistance out of the charger's voltage
+    bool            power_manager;  // false turns off POWER_MANAGER_ENABLE
+    bool            interleave;     // false ignores the ePWM phase loads, every time-base in step
+    float           battery[3];     // state of charge, capacity [Ah] and resistance [Ohm], negative keeps them
+    float           soc_error;      // added to the state of charge estimate once it starts, 0.0 - 1.0
+    float           shading;        // irradiance on one substring of each panel, 1.0 for none
+    const SimProfile_t * profile;   // drives PV1's irradiance and shading, NULL for none
+    float           delta_d[2];     // overrides MPPT_1/2_DELTA_DC and _MAX, negative keeps them
+    float           gain;           // overrides MPPT_IC_GAIN and MPPT_RCC_GAIN, negative keeps it
+    const char *    trace_path;
+    uint32_t        trace_decimation;   // plant steps per trace row
+    const char *    dump_path;      // trace_buffer image, USE_TRACE builds
+} SimConfig_t;
+
+typedef struct {
+    uint64_t        writes;         // compare register updates
+    uint64_t        latency_min;    // [SYSCLK cycles] feedback sample to compare update
+    uint64_t        latency_max;
+    uint64_t        latency_sum;
+    uint64_t        latency_count;
+} SimConverterStats_t;
+
+typedef struct {
+    uint64_t        samples;
+    double          err_sum;        // [LSB] switching ripple at the sample instants
+    double          err_sq_sum;     // [LSB^2]
+    double          ripple_sq_sum;  // [LSB^2] mean square ripple over the period at each sample
+    uint64_t        over_range;     // samples past the ADC's full scale
+} SimSampleStats_t;
+
+typedef struct {
+    uint64_t        pairs;
+    uint64_t        skew_max;       // [SYSCLK cycles] first to second sample of a pair
+} SimPairStats_t;
+
+extern SimConfig_t sim_config;
+extern Plant_t sim_plant;
+
+/***    S I M _ H A L    ***/
+void sim_hal_init(void);
+uint64_t sim_now(void);
+uint64_t sim_idle_cycles(void);
+uint64_t sim_interrupt_count(uint32_t interruptNumber);
+uint64_t sim_cla_task_count(uint32_t task);
+float sim_duty(uint32_t converter);
+const SimConverterStats_t * sim_converter_stats(uint32_t converter);
+const SimSampleStats_t * sim_sample_stats(ePlantSignal signal);
+const SimSampleStats_t * sim_turn_on_stats(ePlantSignal signal);
+const SimPairStats_t * sim_pair_stats(uint32_t pair);
+
+/***    S I M _ M A I N    ***/
+void sim_on_plant_step(float dt);
+void sim_finish(void);
+
+/***    F I R M W A R E    ***/
+void ifec_main(void);
+
+#endif /* SIM_SIM_H_ */
@@ -0,0 +1,1327 @@
+/*
+ * sim_hal.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Simulated F28004x peripherals. Time is kept in SYSCLK cycles and only
+ *  moves forward when the firmware waits: IDLE, DEVICE_DELAY_US and each
+ *  pass of a while(ADC_isBusy()) loop. Straight-line firmware code is
+ *  treated as free, so the CPU load reported is the time spent outside
+ *  IDLE, not an instruction count.
+ *
+ *  CLA tasks run SIM_CLA_LATENCY_CYCLES after their trigger, in parallel
+ *  with the CPU: they neither wake it from IDLE nor count towards its load.
+ *  DMA bursts complete at their trigger and likewise cost the CPU nothing.
+ *
+ *  All ePWM time-bases count from zero together, and a module that loads
+ *  its phase at sync is offset by TBPHS from the module whose SYNCOUT
+ *  reaches it, less SIM_EPWM_SYNC_DELAY. Every time-base is assumed to run
+ *  at the sync master's period. ADC samples include the switching ripple
+ *  at the position in the period where the S+H window opens
+ *  (plant_sense_ripple()), and how far that lands from the period average
+ *  is recorded per net.
+ */
+
+#include <math.h>
+#include <stddef.h>
+
+#include "driverlib.h"
+#include "device.h"
+#include "config.h"
+#include "src_adc.h"
+#include "sim.h"
+
+#define SIM_ADC_COUNT           3U
+#define SIM_SOC_COUNT           16U
+#define SIM_EPWM_COUNT          8U
+#define SIM_TIMER_COUNT         3U
+#define SIM_INTERRUPT_COUNT     16U
+#define SIM_ADC_INT_COUNT       4U
+#define SIM_EPWM_SOC_COUNT      2U
+#define SIM_CLA_TASK_COUNT      8U
+#define SIM_DMA_COUNT           6U
+#define SIM_PERIPHERAL_TOP      0x400000U   // DMA addresses below this are device registers
+#define SIM_RIPPLE_POINTS       16U         // phases per period for the ripple RMS
+#define SIM_EPWM_SYNC_DELAY     2U          // [TBCLK] sync pulse to phase load
+
+typedef struct {
+    ADC_Trigger     trigger;
+    ADC_Channel     channel;
+    uint32_t        acqps;
+} SimSOC_t;
+
+typedef struct {
+    uint32_t        base;
+    uint32_t        result_base;
+    const ePlantSignal * pins;
+    SimSOC_t        soc[SIM_SOC_COUNT];
+    uint16_t        result[SIM_SOC_COUNT];
+    uint16_t        pending;        // SOC flags waiting for the converter
+    int32_t         converting;     // SOC being converted, -1 when idle
+    uint32_t        last_soc;       // round-robin pointer
+    uint32_t        hipri_count;    // SOC0 .. SOC(n-1) are high priority
+    uint64_t        done_at;
+    uint16_t        sample;         // code latched at end of the S+H window
+    const uint32_t * int_numbers;
+    ADC_SOCNumber   int_source[SIM_ADC_INT_COUNT];
+    bool            int_enabled[SIM_ADC_INT_COUNT];
+    bool            int_flag[SIM_ADC_INT_COUNT];
+    bool            int_continuous[SIM_ADC_INT_COUNT];
+} SimADC_t;
+
+typedef struct {
+    bool            enabled;
+    EPWM_ADCStartOfConversionSource source;
+    uint16_t        prescale;       // events per SOC, 0 disables
+    uint16_t        count;
+    uint16_t        count_init;     // loaded into count by a software force
+    uint64_t        last_event;
+} SimEPWMSoc_t;
+
+typedef struct {
+    uint16_t        tbprd;
+    float           cmpa;           // [TBCLK] shadow, including the HRPWM fraction
+    float           cmpa_active;    // loaded from the shadow at counter zero
+    uint16_t        cmpb;
+    uint16_t        cmpc;           // active, loaded from the shadows at counter zero like CMPA
+    uint16_t        cmpd;
+    uint16_t        cmpc_shadow;
+    uint16_t        cmpd_shadow;
+    uint64_t        period_index;
+    uint16_t        tbphs;
+    bool            phase_load;
+    EPWM_SyncOutPulseMode sync_out;
+    uint64_t        offset;         // [SYSCLK] counter = (now + offset) % period
+    SimEPWMSoc_t    soc[SIM_EPWM_SOC_COUNT];
+} SimEPWM_t;
+
+typedef struct {
+    uint32_t        prd;
+    uint16_t        tddr;
+    bool            running;
+    bool            tie;
+    uint64_t        next_fire;
+} SimTimer_t;
+
+typedef struct {
+    void            (*vector[SIM_CLA_TASK_COUNT])(void);
+    CLA_Trigger     trigger[SIM_CLA_TASK_COUNT];
+    uint16_t        enabled;        // CLA_TASKFLAG_x
+    uint16_t        pending;        // MIFR, triggered but not started
+    uint64_t        start_at[SIM_CLA_TASK_COUNT];
+    uint64_t        count[SIM_CLA_TASK_COUNT];
+} SimCLA_t;
+
+typedef struct {
+    DMA_Trigger     trigger;
+    bool            trigger_enabled;
+    bool            running;
+    bool            continuous;
+    bool            int_enabled;
+    bool            int_at_end;
+    uint16_t        burst_size;     // [words]
+    int16_t         src_burst_step;
+    int16_t         dst_burst_step;
+    int16_t         src_transfer_step;
+    int16_t         dst_transfer_step;
+    uint32_t        transfer_size;  // [bursts]
+    uint32_t        bursts_left;    // 0 when the next trigger starts a transfer
+    uintptr_t       src_shadow;
+    uintptr_t       dst_shadow;
+    uintptr_t       src;
+    uintptr_t       dst;
+} SimDMA_t;
+
+typedef struct {
+    uint32_t        number;
+    void            (*handler)(void);
+    bool            enabled;
+    bool            pending;
+    uint64_t        count;
+} SimInterrupt_t;
+
+
+/**********************************************************
+ *          P R I V A T E   V A R I A B L E S
+ **********************************************************/
+
+/* Board nets wired to each ADC input, indexed by ADC_Channel */
+static const ePlantSignal adca_pins[SIM_SOC_COUNT] = {
+    [ADC_CH_ADCIN3] = Plant_PV2_I,
+    [ADC_CH_ADCIN8] = Plant_Battery_I,
+    [ADC_CH_ADCIN10] = Plant_PV1_I,
+};
+
+static const ePlantSignal adcb_pins[SIM_SOC_COUNT] = {
+    [ADC_CH_ADCIN0] = Plant_PV1_V,
+    [ADC_CH_ADCIN4] = Plant_PV2_V,
+    [ADC_CH_ADCIN6] = Plant_Battery_V,
+};
+
+static const ePlantSignal adcc_pins[SIM_SOC_COUNT] = {
+    [ADC_CH_ADCIN4] = Plant_Buck_3V3_V,
+    [ADC_CH_ADCIN14] = Plant_Buck_5V_V,
+};
+
+static const uint32_t adca_ints[SIM_ADC_INT_COUNT] = { INT_ADCA1, INT_ADCA2, INT_ADCA3, INT_ADCA4 };
+static const uint32_t adcb_ints[SIM_ADC_INT_COUNT] = { INT_ADCB1, INT_ADCB2, INT_ADCB3, INT_ADCB4 };
+static const uint32_t adcc_ints[SIM_ADC_INT_COUNT] = { INT_ADCC1, INT_ADCC2, INT_ADCC3, INT_ADCC4 };
+
+/* Task entry points by CLA_MVECT_x; weak so builds without USE_CLA link */
+extern void Cla1Task1(void) __attribute__((weak));
+extern void Cla1Task2(void) __attribute__((weak));
+extern void Cla1Task3(void) __attribute__((weak));
+extern void Cla1Task4(void) __attribute__((weak));
+extern void Cla1Task5(void) __attribute__((weak));
+extern void Cla1Task6(void) __attribute__((weak));
+extern void Cla1Task7(void) __attribute__((weak));
+extern void Cla1Task8(void) __attribute__((weak));
+
+static void (* const cla_tasks[SIM_CLA_TASK_COUNT])(void) = {
+    Cla1Task1, Cla1Task2, Cla1Task3, Cla1Task4, Cla1Task5, Cla1Task6, Cla1Task7, Cla1Task8
+};
+static const uint32_t dma_ints[SIM_DMA_COUNT] = {
+    INT_DMA_CH1, INT_DMA_CH2, INT_DMA_CH3, INT_DMA_CH4, INT_DMA_CH5, INT_DMA_CH6
+};
+static const uint32_t cla_ints[SIM_CLA_TASK_COUNT] = {
+    INT_CLA1_1, INT_CLA1_2, INT_CLA1_3, INT_CLA1_4, INT_CLA1_5, INT_CLA1_6, INT_CLA1_7, INT_CLA1_8
+};
+
+static const uint32_t converter_epwm[PLANT_CONVERTER_COUNT] = {
+    MPPT_1_PWM, MPPT_2_PWM, BUCK_5V_PWM, BUCK_3V3_PWM
+};
+
+/* Nets converted as a V/I pair, by SIM_PAIR_x */
+static const ePlantSignal pair_signals[SIM_PAIR_COUNT][2] = {
+    [SIM_PAIR_PV1] = { Plant_PV1_V, Plant_PV1_I },
+    [SIM_PAIR_PV2] = { Plant_PV2_V, Plant_PV2_I },
+    [SIM_PAIR_BATTERY] = { Plant_Battery_V, Plant_Battery_I },
+};
+
+/* Feedback net of each converter, used for the sample-to-update latency */
+static const ePlantSignal converter_feedback[PLANT_CONVERTER_COUNT] = {
+    [PLANT_PV1] = Plant_PV1_V,
+    [PLANT_PV2] = Plant_PV2_V,
+    [PLANT_BUCK_5V] = Plant_Buck_5V_V,
+    [PLANT_BUCK_3V3] = Plant_Buck_3V3_V,
+};
+
+static SimADC_t adcs[SIM_ADC_COUNT];
+static SimEPWM_t epwms[SIM_EPWM_COUNT];
+static SysCtl_SyncInputSource epwm_sync_select[2];     // EPWM4 and EPWM7 SYNCIN
+static SimTimer_t timers[SIM_TIMER_COUNT];
+static SimCLA_t cla;
+static SimDMA_t dmas[SIM_DMA_COUNT];
+static SimInterrupt_t interrupts[SIM_INTERRUPT_COUNT];
+static SimConverterStats_t converter_stats[PLANT_CONVERTER_COUNT];
+static SimSampleStats_t sample_stats[Plant_Signal_Count];
+static SimSampleStats_t turn_on_stats[Plant_Signal_Count];
+static SimPairStats_t pair_stats[SIM_PAIR_COUNT];
+static ePlantSignal pair_open[SIM_PAIR_COUNT];     // first of the pair sampled, waiting for the second
+static uint64_t pair_open_at[SIM_PAIR_COUNT];
+
+static uint64_t now;
+static uint64_t plant_next;
+static uint64_t idle_cycles;
+static uint64_t sample_time[Plant_Signal_Count];
+static bool sample_valid[Plant_Signal_Count];
+static bool interrupts_enabled;
+static uint16_t pie_ack_pending;    // PIE groups waiting for Interrupt_clearACKGroup()
+static bool in_isr;
+static bool cpu_idle;
+static uint64_t dispatch_count;
+static uint32_t rng_state;
+
+Plant_t sim_plant;
+
+
+/**********************************************************
+ *                  L O O K U P S
+ **********************************************************/
+
+static SimADC_t * adc_from_base(uint32_t base) {
+    uint32_t n;
+    for(n = 0; n < SIM_ADC_COUNT; n++) {
+        if((adcs[n].base == base) || (adcs[n].result_base == base)) {
+            return &adcs[n];
+        }
+    }
+    return NULL;
+}
+
+static SimEPWM_t * epwm_from_base(uint32_t base) {
+    uint32_t n = (base - EPWM1_BASE) / (EPWM2_BASE - EPWM1_BASE);
+    return (n < SIM_EPWM_COUNT) ? &epwms[n] : NULL;
+}
+
+static int32_t converter_from_epwm(uint32_t base) {
+    switch(base) {
+    case(MPPT_1_PWM): return PLANT_PV1;
+    case(MPPT_2_PWM): return PLANT_PV2;
+    case(BUCK_5V_PWM): return PLANT_BUCK_5V;
+    case(BUCK_3V3_PWM): return PLANT_BUCK_3V3;
+    }
+    return -1;
+}
+
+static SimDMA_t * dma_from_base(uint32_t base) {
+    uint32_t n = (base - DMA_CH1_BASE) / (DMA_CH2_BASE - DMA_CH1_BASE);
+    return (n < SIM_DMA_COUNT) ? &dmas[n] : NULL;
+}
+
+static SimTimer_t * timer_from_base(uint32_t base) {
+    switch(base) {
+    case(CPUTIMER0_BASE): return &timers[0];
+    case(CPUTIMER1_BASE): return &timers[1];
+    case(CPUTIMER2_BASE): return &timers[2];
+    }
+    return NULL;
+}
+
+static SimInterrupt_t * interrupt_from_number(uint32_t number, bool create) {
+    uint32_t n;
+    for(n = 0; n < SIM_INTERRUPT_COUNT; n++) {
+        if(interrupts[n].number == number) {
+            return &interrupts[n];
+        }
+    }
+    if(create) {
+        for(n = 0; n < SIM_INTERRUPT_COUNT; n++) {
+            if(interrupts[n].number == 0) {
+                interrupts[n].number = number;
+                return &interrupts[n];
+            }
+        }
+    }
+    return NULL;
+}
+
+
+/**********************************************************
+ *                  N O I S E
+ **********************************************************/
+
+static float rng_uniform(void) {
+    // xorshift32, reproducible across hosts
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return ((float)(rng_state >> 8) + 0.5f) / 16777216.0f;
+}
+
+static float rng_gaussian(void) {
+    float u1 = rng_uniform();
+    float u2 = rng_uniform();
+    return sqrtf(-2.0f * logf(u1)) * cosf(6.2831853f * u2);
+}
+
+
+/**********************************************************
+ *                  E V E N T   L O O P
+ **********************************************************/
+
+static void raise_interrupt(uint32_t number) {
+    SimInterrupt_t * irq = interrupt_from_number(number, false);
+    if(irq != NULL) {
+        irq->pending = true;
+    }
+}
+
+/* PIE group bit of an INT_xxx number, 0 for the non-PIE CPU timer 1/2 lines */
+static uint16_t pie_group_bit(uint32_t number) {
+    uint32_t group = (number >> 8) & 0xFFU;
+    return (group == 0) ? 0 : (uint16_t)(1U << (group - 1U));
+}
+
+static void advance(uint64_t cycles);
+
+static void dispatch_interrupts(void) {
+    uint32_t n;
+    bool serviced = true;
+
+    if(!interrupts_enabled || in_isr) {
+        return;
+    }
+
+    while(serviced) {
+        serviced = false;
+        for(n = 0; n < SIM_INTERRUPT_COUNT; n++) {
+            SimInterrupt_t * irq = &interrupts[n];
+            uint16_t group = pie_group_bit(irq->number);
+
+            if(irq->pending && irq->enabled && (irq->handler != NULL) && !(pie_ack_pending & group)) {
+                irq->pending = false;
+                irq->count++;
+                pie_ack_pending |= group;
+                dispatch_count++;
+                in_isr = true;
+                advance(SIM_ISR_LATENCY_CYCLES);
+                irq->handler();
+                in_isr = false;
+                serviced = true;
+            }
+        }
+    }
+}
+
+/* Marks the tasks started by a peripheral event as pending */
+static void cla_trigger(CLA_Trigger trigger) {
+    uint32_t n;
+
+    for(n = 0; n < SIM_CLA_TASK_COUNT; n++) {
+        uint16_t flag = (uint16_t)(1U << n);
+        if((cla.enabled & flag) && (cla.trigger[n] == trigger) && !(cla.pending & flag)) {
+            cla.pending |= flag;
+            cla.start_at[n] = now + SIM_CLA_LATENCY_CYCLES;
+        }
+    }
+}
+
+/* Runs the due tasks, lowest task number first like the CLA's priority */
+static void cla_update(void) {
+    uint32_t n;
+
+    for(n = 0; n < SIM_CLA_TASK_COUNT; n++) {
+        uint16_t flag = (uint16_t)(1U << n);
+        if((cla.pending & flag) && (now >= cla.start_at[n])) {
+            cla.pending &= ~flag;
+            if(cla.vector[n] != NULL) {
+                cla.count[n]++;
+                cla.vector[n]();
+                raise_interrupt(cla_ints[n]);
+            }
+        }
+    }
+}
+
+/*
+ * DMA address space: device registers by word address, anything above
+ * SIM_PERIPHERAL_TOP is host memory. Only ADC result registers are mapped.
+ */
+static uint16_t dma_read(uintptr_t addr) {
+    uint32_t n;
+
+    if(addr >= SIM_PERIPHERAL_TOP) {
+        return *(const uint16_t *)addr;
+    }
+    for(n = 0; n < SIM_ADC_COUNT; n++) {
+        uintptr_t offset = addr - (adcs[n].result_base + ADC_O_RESULT0);
+        if(offset < SIM_SOC_COUNT) {
+            return adcs[n].result[offset];
+        }
+    }
+    return 0;
+}
+
+static void dma_write(uintptr_t addr, uint16_t value) {
+    if(addr >= SIM_PERIPHERAL_TOP) {
+        *(uint16_t *)addr = value;
+    }
+}
+
+/* Steps are in 16-bit words, host memory is byte addressed */
+static uintptr_t dma_step(uintptr_t addr, int16_t step) {
+    return addr + (intptr_t)step * ((addr >= SIM_PERIPHERAL_TOP) ? (intptr_t)sizeof(uint16_t) : 1);
+}
+
+/* One burst per trigger, done at once */
+static void dma_trigger(DMA_Trigger trigger) {
+    uint32_t n;
+    uint32_t word;
+
+    for(n = 0; n < SIM_DMA_COUNT; n++) {
+        SimDMA_t * dma = &dmas[n];
+
+        if(!dma->running || !dma->trigger_enabled || (dma->trigger != trigger)) {
+            continue;
+        }
+        if(dma->bursts_left == 0) {
+            dma->src = dma->src_shadow;
+            dma->dst = dma->dst_shadow;
+            dma->bursts_left = dma->transfer_size;
+            if(dma->int_enabled && !dma->int_at_end) {
+                raise_interrupt(dma_ints[n]);
+            }
+        }
+        for(word = 0; word < dma->burst_size; word++) {
+            bool last = (word + 1U) == dma->burst_size;
+            dma_write(dma->dst, dma_read(dma->src));
+            dma->src = dma_step(dma->src, last ? dma->src_transfer_step : dma->src_burst_step);
+            dma->dst = dma_step(dma->dst, last ? dma->dst_transfer_step : dma->dst_burst_step);
+        }
+        if(--dma->bursts_left == 0) {
+            if(dma->int_enabled && dma->int_at_end) {
+                raise_interrupt(dma_ints[n]);
+            }
+            dma->running = dma->continuous;
+        }
+    }
+}
+
+/*
+ * Records how far the ripple puts a sample from the period average, next to
+ * the ripple RMS over the whole period: what a sample at an arbitrary point
+ * in the period would be off by.
+ */
+static void record_sample(SimSampleStats_t * stats, ePlantSignal signal, float ripple,
+                          const float duty[PLANT_CONVERTER_COUNT], const float phase[PLANT_CONVERTER_COUNT],
+                          float period) {
+    float shifted[PLANT_CONVERTER_COUNT];
+    double sq = 0.0;
+    uint32_t k;
+    uint32_t n;
+    uint32_t pair;
+
+    for(k = 0; k < SIM_RIPPLE_POINTS; k++) {
+        for(n = 0; n < PLANT_CONVERTER_COUNT; n++) {
+            shifted[n] = phase[n] + ((float)k / (float)SIM_RIPPLE_POINTS);
+            shifted[n] -= (shifted[n] >= 1.0f) ? 1.0f : 0.0f;
+        }
+        float r = plant_sense_ripple(&sim_plant, signal, duty, shifted, period) * ADC_MAX_VALUE_F / VREFHI_V;
+        sq += (double)(r * r);
+    }
+
+    ripple *= ADC_MAX_VALUE_F / VREFHI_V;
+    stats->samples++;
+    stats->err_sum += ripple;
+    stats->err_sq_sum += (double)(ripple * ripple);
+    stats->ripple_sq_sum += sq / SIM_RIPPLE_POINTS;
+
+    // time from the first of a V/I pair to the second
+    for(pair = 0; pair < SIM_PAIR_COUNT; pair++) {
+        if((signal != pair_signals[pair][0]) && (signal != pair_signals[pair][1])) {
+            continue;
+        }
+        if((pair_open[pair] != Plant_No_Signal) && (pair_open[pair] != signal)) {
+            uint64_t skew = now - pair_open_at[pair];
+            if(skew > pair_stats[pair].skew_max) {
+                pair_stats[pair].skew_max = skew;
+            }
+            pair_stats[pair].pairs++;
+            pair_open[pair] = Plant_No_Signal;
+        }
+        else {
+            pair_open[pair] = signal;
+            pair_open_at[pair] = now;
+        }
+    }
+}
+
+/**
+ * @brief Error of the sensor in front of the ADC pin [V]
+ */
+static float sensor_error(ePlantSignal signal) {
+    switch(signal) {
+    case(Plant_PV1_I):
+    case(Plant_PV2_I):
+    case(Plant_Battery_I):  return sim_config.i_zero_mv / 1000.0f;
+    default:                return 0.0f;
+    }
+}
+
+/* The MPPT pairs' samples at turn-on, for ripple correlation, are recorded apart */
+static bool adc_turn_on_soc(const SimSOC_t * soc) {
+    return (soc->trigger == MPPT_1_RIPPLE_TRIGGER) || (soc->trigger == MPPT_2_RIPPLE_TRIGGER);
+}
+
+static void adc_convert(SimADC_t * adc, uint32_t soc) {
+    ePlantSignal signal = adc->pins[adc->soc[soc].channel];
+    float duty[PLANT_CONVERTER_COUNT];
+    float phase[PLANT_CONVERTER_COUNT];
+    float period = 0.0f;
+    float ripple;
+    float code;
+    uint32_t n;
+
+    for(n = 0; n < PLANT_CONVERTER_COUNT; n++) {
+        const SimEPWM_t * epwm = epwm_from_base(converter_epwm[n]);
+        uint64_t cycles = (uint64_t)epwm->tbprd + 1U;
+
+        duty[n] = sim_duty(n);
+        phase[n] = (float)((now + epwm->offset) % cycles) / (float)cycles;
+        period = (float)cycles / (float)SIM_SYSCLK_HZ;
+    }
+    ripple = plant_sense_ripple(&sim_plant, signal, duty, phase, period);
+    record_sample(adc_turn_on_soc(&adc->soc[soc]) ? &turn_on_stats[signal] : &sample_stats[signal],
+                  signal, ripple, duty, phase, period);
+
+    code = ((plant_sense(&sim_plant, signal) + ripple + sensor_error(signal)) * ADC_MAX_VALUE_F / VREFHI_V)
+           + (sim_config.noise_lsb * rng_gaussian());
+
+    if(code < 0.0f) {
+        code = 0.0f;
+    }
+    else if(code > ADC_MAX_VALUE_F) {
+        sample_stats[signal].over_range++;
+        code = ADC_MAX_VALUE_F;
+    }
+
+    adc->pending &= ~(1U << soc);
+    adc->converting = (int32_t)soc;
+    adc->sample = (uint16_t)(code + 0.5f);
+    adc->done_at = now + adc->soc[soc].acqps + 1U + SIM_ADC_CONV_CYCLES;
+    sample_time[signal] = now;
+    sample_valid[signal] = true;
+}
+
+static void adc_start_next(SimADC_t * adc) {
+    uint32_t n;
+
+    if((adc->converting >= 0) || (adc->pending == 0)) {
+        return;
+    }
+
+    // high priority SOCs in numerical order, they don't move the round-robin pointer
+    for(n = 0; n < adc->hipri_count; n++) {
+        if(adc->pending & (1U << n)) {
+            adc_convert(adc, n);
+            return;
+        }
+    }
+
+    // round-robin from the SOC after the last one converted
+    for(n = 1; n <= SIM_SOC_COUNT; n++) {
+        uint32_t soc = (adc->last_soc + n) % SIM_SOC_COUNT;
+        if((soc >= adc->hipri_count) && (adc->pending & (1U << soc))) {
+            adc_convert(adc, soc);
+            adc->last_soc = soc;
+            return;
+        }
+    }
+}
+
+static void adc_update(SimADC_t * adc) {
+    uint32_t n;
+
+    if((adc->converting >= 0) && (now >= adc->done_at)) {
+        adc->result[adc->converting] = adc->sample;
+
+        // ADCINTx pulses on EOC, but not while its flag is still set unless continuous
+        for(n = 0; n < SIM_ADC_INT_COUNT; n++) {
+            if(adc->int_enabled[n] && (adc->int_source[n] == (ADC_SOCNumber)adc->converting)
+               && (!adc->int_flag[n] || adc->int_continuous[n])) {
+                adc->int_flag[n] = true;
+                raise_interrupt(adc->int_numbers[n]);
+                // ADCx1 .. ADCx4 and ADCxEVT per ADC, in ADC order
+                cla_trigger((CLA_Trigger)(CLA_TRIGGER_ADCA1 + (5U * (uint32_t)(adc - adcs)) + n));
+                dma_trigger((DMA_Trigger)(DMA_TRIGGER_ADCA1 + (5U * (uint32_t)(adc - adcs)) + n));
+            }
+        }
+        adc->converting = -1;
+    }
+    adc_start_next(adc);
+}
+
+static void adc_trigger(ADC_Trigger trigger) {
+    uint32_t n;
+    uint32_t soc;
+
+    for(n = 0; n < SIM_ADC_COUNT; n++) {
+        for(soc = 0; soc < SIM_SOC_COUNT; soc++) {
+            if(adcs[n].soc[soc].trigger == trigger) {
+                adcs[n].pending |= (1U << soc);
+            }
+        }
+        adc_start_next(&adcs[n]);
+    }
+}
+
+/* Counter value of an ePWM event in up-count mode, -1 if it never occurs */
+static int32_t epwm_event_count(const SimEPWM_t * epwm, EPWM_ADCStartOfConversionSource source) {
+    switch(source) {
+    case(EPWM_SOC_TBCTR_ZERO): return 0;
+    case(EPWM_SOC_TBCTR_PERIOD): return epwm->tbprd;
+    case(EPWM_SOC_TBCTR_U_CMPA): return (int32_t)epwm->cmpa_active;
+    case(EPWM_SOC_TBCTR_U_CMPB): return epwm->cmpb;
+    case(EPWM_SOC_TBCTR_U_CMPC): return epwm->cmpc;
+    case(EPWM_SOC_TBCTR_U_CMPD): return epwm->cmpd;
+    default: return -1;
+    }
+}
+
+static uint64_t epwm_next_at(uint64_t after, uint64_t period, uint64_t offset, int32_t count) {
+    uint64_t t;
+
+    if(count < 0) {
+        return UINT64_MAX;
+    }
+    after += offset;
+    t = ((after / period) * period) + (uint64_t)count;
+    return ((t <= after) ? (t + period) : t) - offset;
+}
+
+/*
+ * First SOC event after both the last one and 'after'. A compare moved
+ * below the counter by the firmware is missed for that period, like on
+ * the device; CMPA, CMPC and CMPD only move at counter zero, from their
+ * shadows.
+ */
+static uint64_t epwm_next_soc(const SimEPWM_t * epwm, const SimEPWMSoc_t * soc, uint64_t after) {
+    uint64_t period = (uint64_t)epwm->tbprd + 1U;
+    uint64_t next;
+
+    if(!soc->enabled || (soc->prescale == 0) || (epwm->tbprd == 0)) {
+        return UINT64_MAX;
+    }
+    if(soc->last_event > after) {
+        after = soc->last_event;
+    }
+    if(soc->source == EPWM_SOC_TBCTR_ZERO_OR_PERIOD) {
+        uint64_t zero = epwm_next_at(after, period, epwm->offset, 0);
+        uint64_t prd = epwm_next_at(after, period, epwm->offset, epwm->tbprd);
+        return (zero < prd) ? zero : prd;
+    }
+    next = epwm_next_at(after, period, epwm->offset, epwm_event_count(epwm, soc->source));
+    return next;
+}
+
+/* ePWM whose SYNCOUT reaches an ePWM's SYNCIN, -1 for none */
+static int32_t epwm_sync_source(uint32_t n) {
+    SysCtl_SyncInputSource select;
+
+    switch(n) {
+    case(0): return -1;         // EXTSYNCIN1
+    case(3): select = epwm_sync_select[0]; break;
+    case(6): select = epwm_sync_select[1]; break;
+    default: return (int32_t)n - 1;
+    }
+    switch(select) {
+    case(SYSCTL_SYNC_IN_SRC_EPWM1SYNCOUT): return 0;
+    case(SYSCTL_SYNC_IN_SRC_EPWM4SYNCOUT): return 3;
+    case(SYSCTL_SYNC_IN_SRC_EPWM7SYNCOUT): return 6;
+    default: return -1;
+    }
+}
+
+static int64_t epwm_sync_in_offset(uint32_t n, uint32_t depth);
+
+/* Counter offset of an ePWM, from its phase load and the chain above it */
+static uint64_t epwm_resolve_offset(uint32_t n, uint32_t depth) {
+    const SimEPWM_t * epwm = &epwms[n];
+    uint64_t period = (uint64_t)epwm->tbprd + 1U;
+    int64_t sync;
+
+    if(!sim_config.interleave || !epwm->phase_load) {
+        return 0;
+    }
+    sync = epwm_sync_in_offset(n, depth);
+    if(sync < 0) {
+        return 0;
+    }
+    // at the pulse the source is at zero, SIM_EPWM_SYNC_DELAY later this one is at TBPHS
+    return ((uint64_t)epwm->tbphs + (uint64_t)sync + period - (SIM_EPWM_SYNC_DELAY % period)) % period;
+}
+
+/* Offset of the sync pulses an ePWM sends, at its source's counter zero; -1 for none */
+static int64_t epwm_sync_out_offset(uint32_t n, uint32_t depth) {
+    switch(epwms[n].sync_out) {
+    case(EPWM_SYNC_OUT_PULSE_ON_COUNTER_ZERO): return (int64_t)epwm_resolve_offset(n, depth);
+    case(EPWM_SYNC_OUT_PULSE_ON_EPWMxSYNCIN): return epwm_sync_in_offset(n, depth);
+    default: return -1;
+    }
+}
+
+static int64_t epwm_sync_in_offset(uint32_t n, uint32_t depth) {
+    int32_t source = epwm_sync_source(n);
+
+    if((source < 0) || (depth >= SIM_EPWM_COUNT)) {
+        return -1;
+    }
+    return epwm_sync_out_offset((uint32_t)source, depth + 1U);
+}
+
+static void epwm_resolve_sync(void) {
+    uint32_t n;
+
+    for(n = 0; n < SIM_EPWM_COUNT; n++) {
+        epwms[n].offset = epwm_resolve_offset(n, 0);
+    }
+}
+
+static void epwm_update(uint32_t n) {
+    SimEPWM_t * epwm = &epwms[n];
+    uint32_t x;
+
+    if(epwm->tbprd == 0) {
+        return;
+    }
+
+    // shadow to active compare load at counter zero
+    if(((now + epwm->offset) / ((uint64_t)epwm->tbprd + 1U)) != epwm->period_index) {
+        epwm->period_index = (now + epwm->offset) / ((uint64_t)epwm->tbprd + 1U);
+        epwm->cmpa_active = epwm->cmpa;
+        epwm->cmpc = epwm->cmpc_shadow;
+        epwm->cmpd = epwm->cmpd_shadow;
+    }
+
+    for(x = 0; x < SIM_EPWM_SOC_COUNT; x++) {
+        SimEPWMSoc_t * soc = &epwm->soc[x];
+        uint64_t next = epwm_next_soc(epwm, soc, now - 1U);
+
+        if(now >= next) {
+            soc->last_event = next;
+            if(++soc->count >= soc->prescale) {
+                soc->count = 0;
+                adc_trigger((ADC_Trigger)(ADC_TRIGGER_EPWM1_SOCA + (2U * n) + x));
+            }
+        }
+    }
+}
+
+/* CPU timer period in SYSCLK cycles, PRD + 1 does not fit in 32 bits */
+static uint64_t timer_cycles(const SimTimer_t * timer) {
+    return ((uint64_t)timer->prd + 1U) * ((uint64_t)timer->tddr + 1U);
+}
+
+static void timer_update(uint32_t n) {
+    SimTimer_t * timer = &timers[n];
+    static const uint32_t numbers[SIM_TIMER_COUNT] = { INT_TIMER0, INT_TIMER1, INT_TIMER2 };
+
+    if(timer->running && (now >= timer->next_fire)) {
+        timer->next_fire += timer_cycles(timer);
+        if(timer->tie) {
+            raise_interrupt(numbers[n]);
+        }
+        adc_trigger((ADC_Trigger)(ADC_TRIGGER_CPU1_TINT0 + n));
+    }
+}
+
+static uint64_t next_event(uint64_t limit) {
+    uint32_t n;
+    uint64_t next = (plant_next < limit) ? plant_next : limit;
+
+    for(n = 0; n < SIM_TIMER_COUNT; n++) {
+        if(timers[n].running && (timers[n].next_fire < next)) {
+            next = timers[n].next_fire;
+        }
+    }
+    for(n = 0; n < SIM_ADC_COUNT; n++) {
+        if((adcs[n].converting >= 0) && (adcs[n].done_at < next)) {
+            next = adcs[n].done_at;
+        }
+    }
+    for(n = 0; n < SIM_CLA_TASK_COUNT; n++) {
+        if((cla.pending & (1U << n)) && (cla.start_at[n] < next)) {
+            next = cla.start_at[n];
+        }
+    }
+    for(n = 0; n < SIM_EPWM_COUNT; n++) {
+        uint32_t x;
+        for(x = 0; x < SIM_EPWM_SOC_COUNT; x++) {
+            uint64_t soc = epwm_next_soc(&epwms[n], &epwms[n].soc[x], now);
+            if(soc < next) {
+                next = soc;
+            }
+        }
+    }
+    return next;
+}
+
+static void step_plant(void) {
+    float duty[PLANT_CONVERTER_COUNT];
+    uint32_t n;
+
+    for(n = 0; n < PLANT_CONVERTER_COUNT; n++) {
+        duty[n] = sim_duty(n);
+    }
+    plant_step(&sim_plant, duty, (float)SIM_PLANT_STEP / (float)SIM_SYSCLK_HZ);
+    sim_on_plant_step((float)SIM_PLANT_STEP / (float)SIM_SYSCLK_HZ);
+}
+
+/**
+ * @brief Moves simulated time forward to the given cycle, servicing the
+ *      plant, converters, timers and interrupts on the way
+ */
+static void advance_to(uint64_t target) {
+    uint32_t n;
+
+    while(now < target) {
+        uint64_t next = next_event(target);
+
+        if(cpu_idle && !in_isr) {
+            idle_cycles += next - now;
+        }
+        now = next;
+
+        for(n = 0; n < SIM_EPWM_COUNT; n++) {
+            epwm_update(n);
+        }
+        while(now >= plant_next) {
+            step_plant();
+            plant_next += SIM_PLANT_STEP;
+        }
+        for(n = 0; n < SIM_ADC_COUNT; n++) {
+            adc_update(&adcs[n]);
+        }
+        cla_update();
+        for(n = 0; n < SIM_TIMER_COUNT; n++) {
+            timer_update(n);
+        }
+
+        if(now >= (uint64_t)(sim_config.duration * (double)SIM_SYSCLK_HZ)) {
+            sim_finish();
+        }
+        dispatch_interrupts();
+    }
+}
+
+static void advance(uint64_t cycles) {
+    advance_to(now + cycles);
+}
+
+
+/**********************************************************
+ *                  S I M   A P I
+ **********************************************************/
+
+void sim_hal_init(void) {
+    uint32_t n;
+
+    adcs[0].base = ADCA_BASE;
+    adcs[0].result_base = ADCARESULT_BASE;
+    adcs[0].pins = adca_pins;
+    adcs[0].int_numbers = adca_ints;
+    adcs[1].base = ADCB_BASE;
+    adcs[1].result_base = ADCBRESULT_BASE;
+    adcs[1].pins = adcb_pins;
+    adcs[1].int_numbers = adcb_ints;
+    adcs[2].base = ADCC_BASE;
+    adcs[2].result_base = ADCCRESULT_BASE;
+    adcs[2].pins = adcc_pins;
+    adcs[2].int_numbers = adcc_ints;
+    for(n = 0; n < SIM_ADC_COUNT; n++) {
+        adcs[n].converting = -1;
+        adcs[n].last_soc = SIM_SOC_COUNT - 1U;
+    }
+
+    rng_state = (sim_config.seed != 0) ? sim_config.seed : 1U;
+    plant_init(&sim_plant);
+    plant_set_irradiance(&sim_plant, PLANT_PV1, sim_config.irradiance[0]);
+    plant_set_irradiance(&sim_plant, PLANT_PV2, sim_config.irradiance[1]);
+    plant_set_shading(&sim_plant, PLANT_PV1, sim_config.shading);
+    plant_set_shading(&sim_plant, PLANT_PV2, sim_config.shading);
+    if(sim_config.battery[0] >= 0.0f) {
+        plant_set_battery(&sim_plant, sim_config.battery[0], sim_config.battery[1], sim_config.battery[2]);
+    }
+
+    for(n = 0; n < PLANT_CONVERTER_COUNT; n++) {
+        converter_stats[n].latency_min = UINT64_MAX;
+    }
+
+    now = 0;
+    plant_next = SIM_PLANT_STEP;
+}
+
+uint64_t sim_now(void) {
+    return now;
+}
+
+uint64_t sim_idle_cycles(void) {
+    return idle_cycles;
+}
+
+uint64_t sim_interrupt_count(uint32_t interruptNumber) {
+    SimInterrupt_t * irq = interrupt_from_number(interruptNumber, false);
+    return (irq != NULL) ? irq->count : 0;
+}
+
+uint64_t sim_cla_task_count(uint32_t task) {
+    return (task < SIM_CLA_TASK_COUNT) ? cla.count[task] : 0;
+}
+
+/**
+ * @brief Duty cycle (0.0 - 1.0) the plant sees for a converter
+ */
+float sim_duty(uint32_t converter) {
+    SimEPWM_t * epwm = epwm_from_base(converter_epwm[converter]);
+    float duty = epwm->cmpa_active / ((float)epwm->tbprd + 1.0f);
+
+    if(duty < 0.0f) {
+        return 0.0f;
+    }
+    return (duty > 1.0f) ? 1.0f : duty;
+}
+
+const SimConverterStats_t * sim_converter_stats(uint32_t converter) {
+    return &converter_stats[converter];
+}
+
+const SimSampleStats_t * sim_sample_stats(ePlantSignal signal) {
+    return &sample_stats[signal];
+}
+
+const SimSampleStats_t * sim_turn_on_stats(ePlantSignal signal) {
+    return &turn_on_stats[signal];
+}
+
+const SimPairStats_t * sim_pair_stats(uint32_t pair) {
+    return &pair_stats[pair];
+}
+
+void sim_enable_interrupts(void) {
+    interrupts_enabled = true;
+    dispatch_interrupts();
+}
+
+void sim_disable_interrupts(void) {
+    interrupts_enabled = false;
+}
+
+/* INTM is already set inside an ISR and restored by its return */
+bool Interrupt_enableGlobal(void) {
+    bool was_disabled = !interrupts_enabled || in_isr;
+
+    if(!in_isr) {
+        sim_enable_interrupts();
+    }
+    return was_disabled;
+}
+
+bool Interrupt_disableGlobal(void) {
+    bool was_disabled = !interrupts_enabled || in_isr;
+
+    if(!in_isr) {
+        sim_disable_interrupts();
+    }
+    return was_disabled;
+}
+
+/**
+ * @brief IDLE: sleep until the next interrupt has been serviced
+ */
+void sim_idle(void) {
+    uint64_t serviced = dispatch_count;
+
+    cpu_idle = true;
+    while(serviced == dispatch_count) {
+        advance_to(next_event(now + SIM_PLANT_STEP));
+    }
+    cpu_idle = false;
+}
+
+void sim_delay_us(uint32_t us) {
+    advance((uint64_t)us * (SIM_SYSCLK_HZ / 1000000U));
+}
+
+
+/**********************************************************
+ *                          A D C
+ **********************************************************/
+
+void ADC_setupSOC(uint32_t base, ADC_SOCNumber socNumber, ADC_Trigger trigger,
+                  ADC_Channel channel, uint32_t sampleWindow) {
+    SimADC_t * adc = adc_from_base(base);
+    adc->soc[socNumber].trigger = trigger;
+    adc->soc[socNumber].channel = channel;
+    adc->soc[socNumber].acqps = sampleWindow;
+}
+
+void ADC_forceSOC(uint32_t base, ADC_SOCNumber socNumber) {
+    SimADC_t * adc = adc_from_base(base);
+    adc->pending |= (1U << socNumber);
+    adc_start_next(adc);
+}
+
+bool ADC_isBusy(uint32_t base) {
+    SimADC_t * adc = adc_from_base(base);
+    advance(SIM_ADC_POLL_CYCLES);
+    return (adc->converting >= 0) || (adc->pending != 0);
+}
+
+uint16_t ADC_readResult(uint32_t resultBase, ADC_SOCNumber socNumber) {
+    return adc_from_base(resultBase)->result[socNumber];
+}
+
+void ADC_setInterruptSource(uint32_t base, ADC_IntNumber adcIntNum, ADC_SOCNumber socNumber) {
+    adc_from_base(base)->int_source[adcIntNum] = socNumber;
+}
+
+void ADC_enableInterrupt(uint32_t base, ADC_IntNumber adcIntNum) {
+    adc_from_base(base)->int_enabled[adcIntNum] = true;
+}
+
+void ADC_disableInterrupt(uint32_t base, ADC_IntNumber adcIntNum) {
+    adc_from_base(base)->int_enabled[adcIntNum] = false;
+}
+
+void ADC_clearInterruptStatus(uint32_t base, ADC_IntNumber adcIntNum) {
+    adc_from_base(base)->int_flag[adcIntNum] = false;
+}
+
+void ADC_enableContinuousMode(uint32_t base, ADC_IntNumber adcIntNum) {
+    adc_from_base(base)->int_continuous[adcIntNum] = true;
+}
+
+void ADC_disableContinuousMode(uint32_t base, ADC_IntNumber adcIntNum) {
+    adc_from_base(base)->int_continuous[adcIntNum] = false;
+}
+
+void ADC_setSOCPriority(uint32_t base, ADC_PriorityMode priMode) {
+    adc_from_base(base)->hipri_count = (uint32_t)priMode;
+}
+
+
+/**********************************************************
+ *                          D M A
+ **********************************************************/
+
+void DMA_configAddresses(uint32_t base, const void * destAddr, const void * srcAddr) {
+    SimDMA_t * dma = dma_from_base(base);
+    dma->dst_shadow = (uintptr_t)destAddr;
+    dma->src_shadow = (uintptr_t)srcAddr;
+}
+
+void DMA_configBurst(uint32_t base, uint16_t size, int16_t srcStep, int16_t destStep) {
+    SimDMA_t * dma = dma_from_base(base);
+    dma->burst_size = size;
+    dma->src_burst_step = srcStep;
+    dma->dst_burst_step = destStep;
+}
+
+void DMA_configTransfer(uint32_t base, uint32_t transferSize, int16_t srcStep, int16_t destStep) {
+    SimDMA_t * dma = dma_from_base(base);
+    dma->transfer_size = transferSize;
+    dma->src_transfer_step = srcStep;
+    dma->dst_transfer_step = destStep;
+}
+
+void DMA_configMode(uint32_t base, DMA_Trigger trigger, uint32_t config) {
+    SimDMA_t * dma = dma_from_base(base);
+    dma->trigger = trigger;
+    dma->continuous = (config & DMA_CFG_CONTINUOUS_ENABLE) != 0;
+}
+
+void DMA_setInterruptMode(uint32_t base, DMA_InterruptMode mode) {
+    dma_from_base(base)->int_at_end = (mode == DMA_INT_AT_END);
+}
+
+void DMA_enableInterrupt(uint32_t base) {
+    dma_from_base(base)->int_enabled = true;
+}
+
+void DMA_disableInterrupt(uint32_t base) {
+    dma_from_base(base)->int_enabled = false;
+}
+
+void DMA_enableTrigger(uint32_t base) {
+    dma_from_base(base)->trigger_enabled = true;
+}
+
+void DMA_disableTrigger(uint32_t base) {
+    dma_from_base(base)->trigger_enabled = false;
+}
+
+void DMA_startChannel(uint32_t base) {
+    SimDMA_t * dma = dma_from_base(base);
+    dma->running = true;
+    dma->bursts_left = 0;
+}
+
+void DMA_stopChannel(uint32_t base) {
+    dma_from_base(base)->running = false;
+}
+
+
+/**********************************************************
+ *                     E P W M / H R P W M
+ **********************************************************/
+
+static void record_compare_write(uint32_t base) {
+    int32_t converter = converter_from_epwm(base);
+    SimConverterStats_t * stats;
+    ePlantSignal signal;
+
+    if(converter < 0) {
+        return;
+    }
+    stats = &converter_stats[converter];
+    signal = converter_feedback[converter];
+    stats->writes++;
+    if(sample_valid[signal]) {
+        uint64_t latency = now - sample_time[signal];
+        if(latency < stats->latency_min) stats->latency_min = latency;
+        if(latency > stats->latency_max) stats->latency_max = latency;
+        stats->latency_sum += latency;
+        stats->latency_count++;
+    }
+}
+
+void EPWM_setTimeBasePeriod(uint32_t base, uint16_t periodCount) {
+    epwm_from_base(base)->tbprd = periodCount;
+    epwm_resolve_sync();
+}
+
+void EPWM_setPhaseShift(uint32_t base, uint16_t phaseCount) {
+    epwm_from_base(base)->tbphs = phaseCount;
+    epwm_resolve_sync();
+}
+
+void EPWM_enablePhaseShiftLoad(uint32_t base) {
+    epwm_from_base(base)->phase_load = true;
+    epwm_resolve_sync();
+}
+
+void EPWM_disablePhaseShiftLoad(uint32_t base) {
+    epwm_from_base(base)->phase_load = false;
+    epwm_resolve_sync();
+}
+
+void EPWM_setSyncOutPulseMode(uint32_t base, EPWM_SyncOutPulseMode mode) {
+    epwm_from_base(base)->sync_out = mode;
+    epwm_resolve_sync();
+}
+
+void EPWM_setCounterCompareValue(uint32_t base, EPWM_CounterCompareModule compModule,
+                                 uint16_t compCount) {
+    SimEPWM_t * epwm = epwm_from_base(base);
+
+    switch(compModule) {
+    case(EPWM_COUNTER_COMPARE_A):
+        epwm->cmpa = (float)compCount;
+        record_compare_write(base);
+        break;
+    case(EPWM_COUNTER_COMPARE_B): epwm->cmpb = compCount; break;
+    case(EPWM_COUNTER_COMPARE_C): epwm->cmpc_shadow = compCount; break;
+    case(EPWM_COUNTER_COMPARE_D): epwm->cmpd_shadow = compCount; break;
+    }
+}
+
+void HRPWM_setCounterCompareValue(uint32_t base, HRPWM_CounterCompareModule compModule,
+                                  uint32_t compCount) {
+    if(compModule == HRPWM_COUNTER_COMPARE_A) {
+        // CMPA:CMPAHR, the low 8 bits are the MEP fraction
+        epwm_from_base(base)->cmpa = (float)compCount / 256.0f;
+        record_compare_write(base);
+    }
+}
+
+void HRPWM_setChannelBOutputPath(uint32_t base, HRPWM_ChannelBOutput outputOnB) {
+    (void)base;
+    (void)outputOnB;
+}
+
+void EPWM_enableADCTrigger(uint32_t base, EPWM_ADCStartOfConversionType adcSOCType) {
+    SimEPWMSoc_t * soc = &epwm_from_base(base)->soc[adcSOCType];
+    if(!soc->enabled) {
+        soc->enabled = true;
+        soc->last_event = now;
+    }
+}
+
+void EPWM_disableADCTrigger(uint32_t base, EPWM_ADCStartOfConversionType adcSOCType) {
+    epwm_from_base(base)->soc[adcSOCType].enabled = false;
+}
+
+void EPWM_setADCTriggerSource(uint32_t base, EPWM_ADCStartOfConversionType adcSOCType,
+                              EPWM_ADCStartOfConversionSource socSource) {
+    epwm_from_base(base)->soc[adcSOCType].source = socSource;
+}
+
+void EPWM_setADCTriggerEventPrescale(uint32_t base, EPWM_ADCStartOfConversionType adcSOCType,
+                                     uint16_t preScaleCount) {
+    SimEPWMSoc_t * soc = &epwm_from_base(base)->soc[adcSOCType];
+    soc->prescale = preScaleCount;
+    soc->count = 0;
+}
+
+void EPWM_setADCTriggerEventCountInitValue(uint32_t base, EPWM_ADCStartOfConversionType adcSOCType,
+                                           uint16_t eventCount) {
+    epwm_from_base(base)->soc[adcSOCType].count_init = eventCount;
+}
+
+void EPWM_forceADCTriggerEventCountInit(uint32_t base, EPWM_ADCStartOfConversionType adcSOCType) {
+    SimEPWMSoc_t * soc = &epwm_from_base(base)->soc[adcSOCType];
+    soc->count = soc->count_init;
+}
+
+
+void SysCtl_setSyncInputConfig(SysCtl_SyncInput syncInput, SysCtl_SyncInputSource syncSrc) {
+    switch(syncInput) {
+    case(SYSCTL_SYNC_IN_EPWM4): epwm_sync_select[0] = syncSrc; break;
+    case(SYSCTL_SYNC_IN_EPWM7): epwm_sync_select[1] = syncSrc; break;
+    }
+    epwm_resolve_sync();
+}
+
+
+/**********************************************************
+ *                  C P U   T I M E R S
+ **********************************************************/
+
+void CPUTimer_setPeriod(uint32_t base, uint32_t periodCount) {
+    timer_from_base(base)->prd = periodCount;
+}
+
+void CPUTimer_setPreScaler(uint32_t base, uint16_t prescaler) {
+    timer_from_base(base)->tddr = prescaler;
+}
+
+void CPUTimer_stopTimer(uint32_t base) {
+    timer_from_base(base)->running = false;
+}
+
+void CPUTimer_startTimer(uint32_t base) {
+    SimTimer_t * timer = timer_from_base(base);
+    timer->running = true;
+    timer->next_fire = now + timer_cycles(timer);
+}
+
+void CPUTimer_reloadTimerCounter(uint32_t base) {
+    SimTimer_t * timer = timer_from_base(base);
+    timer->next_fire = now + timer_cycles(timer);
+}
+
+void CPUTimer_enableInterrupt(uint32_t base) {
+    timer_from_base(base)->tie = true;
+}
+
+uint32_t CPUTimer_getTimerCount(uint32_t base) {
+    SimTimer_t * timer = timer_from_base(base);
+    if(!timer->running) {
+        return timer->prd;
+    }
+    return (uint32_t)((timer->next_fire - now) / (timer->tddr + 1U));
+}
+
+
+/**********************************************************
+ *                          C L A
+ **********************************************************/
+
+void sim_cla_map_task(CLA_MVECTNumber claIntVect) {
+    cla.vector[claIntVect] = cla_tasks[claIntVect];
+}
+
+void CLA_setTriggerSource(CLA_TaskNumber taskNumber, CLA_Trigger trigger) {
+    cla.trigger[taskNumber] = trigger;
+}
+
+void CLA_enableTasks(uint32_t base, uint16_t taskFlags) {
+    cla.enabled |= taskFlags;
+}
+
+void CLA_disableTasks(uint32_t base, uint16_t taskFlags) {
+    cla.enabled &= ~taskFlags;
+    cla.pending &= ~taskFlags;
+}
+
+
+/**********************************************************
+ *                  I N T E R R U P T S
+ **********************************************************/
+
+void Interrupt_register(uint32_t interruptNumber, void (*handler)(void)) {
+    interrupt_from_number(interruptNumber, true)->handler = handler;
+}
+
+void Interrupt_enable(uint32_t interruptNumber) {
+    interrupt_from_number(interruptNumber, true)->enabled = true;
+}
+
+void Interrupt_disable(uint32_t interruptNumber) {
+    interrupt_from_number(interruptNumber, true)->enabled = false;
+}
+
+void Interrupt_clearACKGroup(uint16_t group) {
+    pie_ack_pending &= ~group;
+}
@@ -0,0 +1,1141 @@
+/*
+ * sim_main.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Host simulation runner. Builds the firmware against the simulated
+ *  peripherals, runs it for a fixed amount of simulated time and prints
+ *  one "key value unit" line per metric so runs can be diffed or parsed.
+ */
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "driverlib.h"
+#include "config.h"
+#include "sim.h"
+#include "src_adc.h"
+#include "src_dma.h"
+#include "trace.h"
+#include "bench.h"
+#include "mppt.h"
+#include "mppt_dual.h"
+#include "pv_loop.h"
+#include "battery.h"
+#include "power_manager.h"
+
+#define SIM_DEFAULT_DURATION_MS     100.0
+#define SIM_SETTLE_BAND             0.02f   // +/-2% of nominal
+#define SIM_WINDOW_START            0.8     // steady-state window, fraction of the run
+#define SIM_MPPT_BAND               0.95    // tracked once within 5% of the MPP
+#define SIM_CONVERGE_HOLD           0.02    // [s] in the band this long counts as converged
+#define SIM_RISE_BAND               0.9     // rise time ends at 90% of the MPP
+#define SIM_DP_RESOLVABLE           0.01    // [W] smaller true power changes have no right direction to score
+#define SIM_PROFILE_TICK            0.001   // [s] between irradiance updates along a profile
+#define SIM_PROFILE_SETTLE          0.05    // [s] into a dwell before it counts towards static efficiency
+#define SIM_LIMIT_I_BAND            0.05f   // over the charger's current limit by more than 5% counts as over
+#define SIM_LIMIT_V_BAND            0.005f  // and over its voltage limit by more than 0.5%
+#define SIM_OUTPUT_START            0.005   // [s] after an output turns on before it counts as on
+
+typedef struct {
+    double  settle_time;    // [s] last time the output was outside the band
+    double  sum;
+    double  count;
+    float   min;
+    float   max;
+    bool    on;             // the power manager keeps the output on
+    double  on_since;       // [s]
+    double  off_time;       // [s] shed or cut off
+    float   on_min;         // [V] while on, from SIM_OUTPUT_START after it turned on
+    float   on_max;
+} SimBuckMetrics_t;
+
+typedef struct {
+    double  harvested;      // [J]
+    double  available;      // [J]
+    double  harvested_ss;   // [J] in the steady-state window
+    double  available_ss;   // [J]
+    double  change_time;    // [s] last irradiance change
+    double  band_time;      // [s] power last entered the band
+    double  converge_time;  // [s] from change_time to the band, negative until held
+    double  rise_time;      // [s] from change_time to SIM_RISE_BAND, negative until reached
+    double  scan_time;      // [s] with a global scan running
+    double  scan_lost;      // [J] below the MPP while scanning
+    double  block_v_sum;    // [V] plant averages over the DMA block being filled
+    double  block_i_sum;    // [A]
+    double  block_n;
+    double  block_v;        // [V] over the last complete block
+    double  block_i;        // [A]
+    double  seen_v;         // [V] block_v at the tracker's last measurement, or last paced step
+    double  seen_p;         // [W]
+    uint32_t measurements;  // tracker measurements seen
+    uint32_t pace_steps;    // paced strategy steps seen
+    double  loop_err_sq;    // [V^2] panel voltage off the loop's reference, squared and summed
+    double  loop_n;         // plant steps with the loop engaged
+    uint64_t decisions;     // measurements compared with the one before
+    uint64_t resolvable;    // decisions the plant's power changed SIM_DP_RESOLVABLE in
+    uint64_t wrong;         // resolvable, the sign of the measured dP*dV differed from the plant's
+    double  dp_err_sq;      // [W^2] measured dP less the plant's, squared and summed
+    float   irradiance;     // irradiance p_max was computed for
+    float   shading;        // shading p_max was computed for
+    float   p_max;          // [W]
+} SimPVMetrics_t;
+
+/* PV1 along an irradiance profile, see sim/profile.c */
+typedef struct {
+    SimProfilePoint_t point;    // as of the last update
+    double  next;           // [s] next update
+    double  harvested_static;   // [J] in dwells, after SIM_PROFILE_SETTLE
+    double  available_static;   // [J]
+    double  dwell_start;    // [s] the current dwell began, negative outside one
+    double  band_time;      // [s] power last entered the band in this dwell
+    bool    settled;
+    uint32_t dwells;
+    uint32_t unsettled;     // dwells that ended before the power settled
+    double  settle_sum;     // [s]
+    double  settle_max;     // [s]
+} SimProfileMetrics_t;
+
+SimConfig_t sim_config = {
+    .duration = SIM_DEFAULT_DURATION_MS / 1000.0,
+    .seed = 1,
+    .noise_lsb = 1.0f,
+    .i_zero_mv = 0.0f,
+    .irradiance = { 1.0f, 1.0f },
+    .step_time = -1.0,
+    .step_irradiance = 1.0f,
+    .mppt_strategy = { NULL, NULL },
+    .scan_interval = -1,
+    .dual_mode = -1,
+    .fast_start = true,
+    .pace = true,
+    .pv_loop = true,
+    .charger_pi = true,
+    .ir_comp = true,
+    .power_manager = true,
+    .interleave = true,
+    .battery = { -1.0f, -1.0f, -1.0f },
+    .soc_error = 0.0f,
+    .shading = 1.0f,
+    .profile = NULL,
+    .delta_d = { -1.0f, -1.0f },
+    .gain = -1.0f,
+    .trace_path = NULL,
+    .trace_decimation = 100,
+    .dump_path = NULL
+};
+
+static SimBuckMetrics_t buck_metrics[2] = { { .on_min = FLT_MAX }, { .on_min = FLT_MAX } };
+static SimPVMetrics_t pv_metrics[2];
+static SimProfileMetrics_t profile_metrics;
+static double battery_charge;       // [C]
+static float battery_v_min = FLT_MAX;    // [V]
+static float battery_i_overshoot;   // [A] most over the charger's current limit
+static float battery_v_overshoot;   // [V] most over the charger's voltage limit
+static double battery_i_over_time;  // [s] over the current limit by more than SIM_LIMIT_I_BAND
+static double battery_v_over_time;  // [s] over the voltage limit by more than SIM_LIMIT_V_BAND
+static double battery_i_read_err;   // [C] firmware battery current less the plant's
+static double battery_i_read_time;  // [s]
+static double soc_error_sq;         // [s] state of charge estimate less the plant's, squared, over time
+static double soc_error_time;       // [s] since the estimate started
+static float soc_error_max;         // most either way
+static uint32_t ring_blocks;        // DMA blocks the PV averages were taken over
+static uint64_t plant_steps;
+static FILE * trace;
+
+// the firmware's trackers, in main.c
+extern MPPT_t mppt_one;
+extern MPPT_t mppt_two;
+extern MpptDual_t mppt_dual;
+extern PvLoop_t pv_loop_one;
+extern PvLoop_t pv_loop_two;
+extern Battery_t battery;
+extern PowerManager_t power_manager;
+static MPPT_t * const sim_mppt[2] = { &mppt_one, &mppt_two };
+static PvLoop_t * const sim_pv_loop[2] = { &pv_loop_one, &pv_loop_two };
+
+
+static void usage(const char * name) {
+    fprintf(stderr,
+            "usage: %s [-t ms] [-s seed] [-n lsb] [-z mV] [-1 G] [-2 G] [-S ms:G] [-H f] [-P profile] [-L] [-m s[:s]] [-M] [-p d:max] [-G gain] [-f] [-r] [-u] [-k] [-i] [-a] [-I] [-b soc[:Ah[:Ohm]]] [-e soc] [-g steps] [-c mode] [-o trace.csv] [-d steps] [-D dump.bin]\n"
+            "  -t  simulated time in ms (default %.0f, or the profile's length)\n"
+            "  -s  noise seed\n"
+            "  -n  ADC noise, 1 sigma in LSB (default 1.0)\n"
+            "  -z  current sensor zero-current output error in mV\n"
+            "  -1  PV1 irradiance, 0.0 - 1.0 of full sun\n"
+            "  -2  PV2 irradiance\n"
+            "  -S  step both irradiances to G at ms\n"
+            "  -H  shade one substring of each panel to f of the irradiance\n"
+            "  -P  drive PV1 through an irradiance profile\n"
+            "  -L  list the irradiance profiles\n"
+            "  -m  MPPT strategy of both PV inputs, or of PV1:PV2\n"
+            "  -M  list the MPPT strategies\n"
+            "  -p  duty cycle step and largest step of both trackers, in %%\n"
+            "  -G  ic and rcc step per W/V of dP/dV, in %%\n"
+            "  -f  start the trackers from 0%% duty cycle, without an open-circuit voltage snapshot\n"
+            "  -r  step the trackers on every MPPT tick, without waiting to settle or holding at the MPP\n"
+            "  -u  step the duty cycles directly, without the panel voltage loops\n"
+            "  -k  cap the MPPT steps in proportion to the charger's current or voltage error, without its limit loops\n"
+            "  -i  leave the battery's resistance out of the charger's voltage\n"
+            "  -a  keep both outputs on whatever the battery, without the power manager\n"
+            "  -I  switch every converter in phase, the ePWM phase shifts ignored\n"
+            "  -b  battery state of charge, 0.0 - 1.0, capacity in Ah and resistance in Ohm, or the plant's\n"
+            "  -e  error added to the firmware's state of charge estimate once it starts, 0.0 - 1.0\n"
+            "  -g  MPPT steps between global scans, 0 for none\n"
+            "  -c  how the PV inputs share the MPPT ticks: independent or interleaved\n"
+            "  -o  write a CSV trace of the plant state\n"
+            "  -d  plant steps (100ns) per trace row (default 100)\n"
+            "  -D  save trace_buffer for trace_decode (USE_TRACE builds)\n",
+            name, SIM_DEFAULT_DURATION_MS);
+    exit(2);
+}
+
+/**
+ * @brief The plant's state of charge on the firmware's scale, 0.0 - 1.0
+ *
+ * @details The firmware's 100% is a pack charged to V_BATTERY_CHG_LIMIT,
+ *      the plant's the top of its cell curve, so the plant's charge is
+ *      taken as a fraction of what it holds at V_BATTERY_CHG_LIMIT.
+ */
+static float plant_soc_charged(void) {
+    static float full = 0.0f;
+    float lo = 0.0f;
+    float hi = 1.0f;
+    uint32_t n;
+
+    if(full == 0.0f) {
+        for(n = 0; n < 24U; n++) {
+            float mid = 0.5f * (lo + hi);
+
+            if(plant_battery_ocv(mid) < V_BATTERY_CHG_LIMIT) {
+                lo = mid;
+            }
+            else {
+                hi = mid;
+            }
+        }
+        full = hi;
+    }
+    return ((float)sim_plant.battery.soc >= full) ? 1.0f : ((float)sim_plant.battery.soc / full);
+}
+
+static eMpptStrategy find_strategy(const char * name) {
+    uint32_t n;
+
+    for(n = 0; n < Mppt_Strategy_Count; n++) {
+        if(strcmp(mppt_strategies[n]->name, name) == 0) {
+            break;
+        }
+    }
+    return (eMpptStrategy)n;
+}
+
+static eMpptDualMode find_dual_mode(const char * name) {
+    uint32_t n;
+
+    for(n = 0; n < Mppt_Dual_Mode_Count; n++) {
+        if(strcmp(mppt_dual_mode_names[n], name) == 0) {
+            break;
+        }
+    }
+    return (eMpptDualMode)n;
+}
+
+/**
+ * @brief Applies -m, -p, -f, -r, -u, -g and -c once mppt_init() and mppt_dual_init() have run
+ */
+static void apply_mppt_options(void) {
+    uint32_t n;
+
+    if(mppt_one.strategy == NULL) {
+        return;
+    }
+    for(n = 0; n < 2; n++) {
+        if(sim_config.mppt_strategy[n] != NULL) {
+            mppt_set_strategy(sim_mppt[n], find_strategy(sim_config.mppt_strategy[n]));
+            sim_config.mppt_strategy[n] = NULL;
+        }
+    }
+    if(sim_config.delta_d[0] >= 0.0f) {
+        for(n = 0; n < 2; n++) {
+            sim_mppt[n]->delta_d = sim_config.delta_d[0];
+            sim_mppt[n]->delta_max = sim_config.delta_d[1];
+            sim_mppt[n]->strategy->init(sim_mppt[n]);
+        }
+        sim_config.delta_d[0] = -1.0f;
+    }
+    if(sim_config.gain >= 0.0f) {
+        for(n = 0; n < 2; n++) {
+            sim_mppt[n]->gains.ic = sim_config.gain;
+            sim_mppt[n]->gains.rcc = sim_config.gain;
+        }
+        sim_config.gain = -1.0f;
+    }
+    if(sim_config.fast_start == false) {
+        mppt_start_init(sim_mppt[0], sim_mppt[0]->start.pwm_base, false);
+        mppt_start_init(sim_mppt[1], sim_mppt[1]->start.pwm_base, false);
+        sim_config.fast_start = true;
+    }
+    if(sim_config.pace == false) {
+        mppt_pace_init(sim_mppt[0], false);
+        mppt_pace_init(sim_mppt[1], false);
+        sim_config.pace = true;
+    }
+    if(sim_config.pv_loop == false) {
+        for(n = 0; n < 2; n++) {
+            pv_loop_init(sim_pv_loop[n], sim_pv_loop[n]->mppt_id, sim_pv_loop[n]->pwm_base, false);
+        }
+        sim_config.pv_loop = true;
+    }
+    if(sim_config.charger_pi == false) {
+        init_charger(&battery.charger, false);
+        sim_config.charger_pi = true;
+    }
+    if(sim_config.ir_comp == false) {
+        battery.charger.ir_comp = false;
+        sim_config.ir_comp = true;
+    }
+    if(sim_config.power_manager == false) {
+        init_power_manager(&power_manager, false);
+        sim_config.power_manager = true;
+    }
+    if((sim_config.battery[1] > 0.0f) && (battery.soc.capacity != 0)) {
+        soc_init(&battery.soc, sim_config.battery[1]);
+        sim_config.battery[1] = -1.0f;
+    }
+    if(sim_config.scan_interval >= 0) {
+        sim_mppt[0]->scan.interval = (uint32_t)sim_config.scan_interval;
+        sim_mppt[0]->scan.countdown = (uint32_t)sim_config.scan_interval;
+        sim_mppt[1]->scan.interval = (uint32_t)sim_config.scan_interval;
+        sim_mppt[1]->scan.countdown = (uint32_t)sim_config.scan_interval;
+        sim_config.scan_interval = -1;
+    }
+    if(sim_config.dual_mode >= 0) {
+        mppt_dual_set_mode(&mppt_dual, (eMpptDualMode)sim_config.dual_mode);
+        sim_config.dual_mode = -1;
+    }
+}
+
+/**
+ * @brief Scores a new tracker measurement against the noise-free plant
+ *
+ * @details P&O steps on the sign of dP*dV and incremental conductance on the
+ *      sign of dP/dV, the same thing. The plant averages over the DMA block
+ *      the firmware just averaged give the right answer. On the maximum power
+ *      point a step hardly changes the power and either direction is as good,
+ *      so only changes of SIM_DP_RESOLVABLE or more are scored. A paced
+ *      tracker is scored on the steps it takes, against the block it took
+ *      the last one on.
+ */
+static void check_decision(uint32_t n) {
+    const MPPT_t * mppt = sim_mppt[n];
+    SimPVMetrics_t * m = &pv_metrics[n];
+    double p = m->block_v * m->block_i;
+
+    if((mppt->strategy == NULL) || (mppt->measurements == m->measurements)) {
+        return;
+    }
+    m->measurements = mppt->measurements;
+    // a paced strategy judges its step against the measurement it stepped on
+    if(mppt->pace.enabled == true) {
+        if(mppt->pace.steps == m->pace_steps) {
+            return;
+        }
+        m->pace_steps = mppt->pace.steps;
+    }
+    if(m->seen_v != 0.0) {
+        double dp = p - m->seen_p;
+        double dp_err = (double)CTL_TO_F(mppt->delta_p) - dp;
+        bool truth = (dp * (m->block_v - m->seen_v)) > 0.0;
+        bool measured = (CTL_TO_F(mppt->delta_p) * CTL_TO_F(mppt->delta_v)) > 0.0f;
+
+        m->decisions++;
+        m->dp_err_sq += dp_err * dp_err;
+        if(fabs(dp) >= SIM_DP_RESOLVABLE) {
+            m->resolvable++;
+            m->wrong += (truth != measured) ? 1U : 0U;
+        }
+    }
+    m->seen_v = m->block_v;
+    m->seen_p = p;
+}
+
+/**
+ * @brief Moves PV1 along the irradiance profile, every SIM_PROFILE_TICK
+ *
+ * @details A dwell that ends before the power settled in it counts as
+ *      unsettled. Past the end of the profile nothing is scored.
+ */
+static void profile_update(double t) {
+    SimProfileMetrics_t * m = &profile_metrics;
+    const PlantPV_t * pv = &sim_plant.pv[PLANT_PV1];
+    uint32_t segment = m->point.segment;
+
+    if(t < m->next) {
+        return;
+    }
+    m->next += SIM_PROFILE_TICK;
+    sim_profile_at(sim_config.profile, t, &m->point);
+    if(m->point.irradiance != pv->irradiance) {
+        plant_set_irradiance(&sim_plant, PLANT_PV1, m->point.irradiance);
+    }
+    if(m->point.shading != pv->shading) {
+        plant_set_shading(&sim_plant, PLANT_PV1, m->point.shading);
+    }
+    if(m->point.segment == segment) {
+        return;
+    }
+    if((m->dwell_start >= 0.0) && (m->settled == false)) {
+        m->unsettled++;
+    }
+    m->dwell_start = -1.0;
+    if((m->point.dwell == true) && (m->point.segment < sim_config.profile->segments)) {
+        m->dwell_start = t;
+        m->band_time = -1.0;
+        m->settled = false;
+        m->dwells++;
+    }
+}
+
+/**
+ * @brief Scores PV1's power in the profile's dwells
+ *
+ * @details A dwell is settled once the power has held within SIM_MPPT_BAND
+ *      of the MPP for SIM_CONVERGE_HOLD, and its settling time runs from the
+ *      start of the dwell to the start of that hold.
+ */
+static void profile_score(double t, float p, float dt) {
+    SimProfileMetrics_t * m = &profile_metrics;
+    const SimPVMetrics_t * pv = &pv_metrics[PLANT_PV1];
+
+    if(m->dwell_start < 0.0) {
+        return;
+    }
+    if(m->point.since >= SIM_PROFILE_SETTLE) {
+        m->harvested_static += (double)(p * dt);
+        m->available_static += (double)(pv->p_max * dt);
+    }
+    if(m->settled == true) {
+        return;
+    }
+    if(p < (SIM_MPPT_BAND * pv->p_max)) {
+        m->band_time = -1.0;
+    }
+    else if(m->band_time < 0.0) {
+        m->band_time = t;
+    }
+    else if((t - m->band_time) >= SIM_CONVERGE_HOLD) {
+        double settle = m->band_time - m->dwell_start;
+
+        m->settled = true;
+        m->settle_sum += settle;
+        m->settle_max = (settle > m->settle_max) ? settle : m->settle_max;
+    }
+}
+
+/**
+ * @brief Called by sim_hal.c after every plant integration step
+ */
+void sim_on_plant_step(float dt) {
+    double t = (double)sim_now() / (double)SIM_SYSCLK_HZ;
+    uint32_t n;
+
+    for(n = 0; n < 2; n++) {
+        const PlantBuck_t * buck = &sim_plant.buck[n];
+        SimBuckMetrics_t * m = &buck_metrics[n];
+        float band = buck->v_nominal * SIM_SETTLE_BAND;
+
+        // the 5V output is shed first, see power_shed_order in src/power_manager.c
+        bool on = (n == 0) ? (power_manager.level == Power_All_On) : (power_manager.level != Power_Cutoff);
+
+        if((buck->v > (buck->v_nominal + band)) || (buck->v < (buck->v_nominal - band))) {
+            m->settle_time = t;
+        }
+        if((on == true) && (m->on == false)) {
+            m->on_since = t;
+        }
+        m->on = on;
+        if(on == false) {
+            m->off_time += (double)dt;
+        }
+        else if((t - m->on_since) >= SIM_OUTPUT_START) {
+            m->on_min = (buck->v < m->on_min) ? buck->v : m->on_min;
+            m->on_max = (buck->v > m->on_max) ? buck->v : m->on_max;
+        }
+        if(t >= (SIM_WINDOW_START * sim_config.duration)) {
+            if((m->count == 0) || (buck->v < m->min)) m->min = buck->v;
+            if((m->count == 0) || (buck->v > m->max)) m->max = buck->v;
+            m->sum += buck->v;
+            m->count += 1.0;
+        }
+    }
+
+    apply_mppt_options();
+    if((sim_config.step_time >= 0.0) && (t >= sim_config.step_time)) {
+        plant_set_irradiance(&sim_plant, PLANT_PV1, sim_config.step_irradiance);
+        plant_set_irradiance(&sim_plant, PLANT_PV2, sim_config.step_irradiance);
+        sim_config.step_time = -1.0;
+    }
+
+    if(sim_config.profile != NULL) {
+        profile_update(t);
+    }
+
+    if(get_adc_ring_stats()->blocks != ring_blocks) {
+        ring_blocks = get_adc_ring_stats()->blocks;
+        for(n = 0; n < 2; n++) {
+            SimPVMetrics_t * m = &pv_metrics[n];
+
+            m->block_v = (m->block_n > 0.0) ? (m->block_v_sum / m->block_n) : 0.0;
+            m->block_i = (m->block_n > 0.0) ? (m->block_i_sum / m->block_n) : 0.0;
+            m->block_v_sum = 0.0;
+            m->block_i_sum = 0.0;
+            m->block_n = 0.0;
+        }
+    }
+
+    for(n = 0; n < 2; n++) {
+        const PlantPV_t * pv = &sim_plant.pv[n];
+        SimPVMetrics_t * m = &pv_metrics[n];
+        float p = pv->v * pv->i_pv;
+
+        m->block_v_sum += (double)pv->v;
+        m->block_i_sum += (double)pv->i_pv;
+        m->block_n += 1.0;
+        check_decision(n);
+        if(sim_pv_loop[n]->engaged == true) {
+            double err = (double)(pv->v - CTL_TO_F(sim_pv_loop[n]->v_ref));
+
+            m->loop_err_sq += err * err;
+            m->loop_n += 1.0;
+        }
+
+        if((pv->irradiance != m->irradiance) || (pv->shading != m->shading)) {
+            m->irradiance = pv->irradiance;
+            m->shading = pv->shading;
+            m->p_max = plant_pv_mpp(pv, NULL);
+            m->change_time = t;
+            m->band_time = -1.0;
+            m->converge_time = -1.0;
+            m->rise_time = -1.0;
+        }
+        if((m->rise_time < 0.0) && (p >= (SIM_RISE_BAND * m->p_max))) {
+            m->rise_time = t - m->change_time;
+        }
+        if(p < (SIM_MPPT_BAND * m->p_max)) {
+            m->band_time = -1.0;
+        }
+        else if(m->band_time < 0.0) {
+            m->band_time = t;
+        }
+        else if((m->converge_time < 0.0) && ((t - m->band_time) >= SIM_CONVERGE_HOLD)) {
+            m->converge_time = m->band_time - m->change_time;
+        }
+        if(sim_mppt[n]->scan.state != Mppt_Scan_Idle) {
+            m->scan_time += (double)dt;
+            m->scan_lost += (double)((m->p_max - p) * dt);
+        }
+        m->harvested += (double)(p * dt);
+        m->available += (double)(m->p_max * dt);
+        if(t >= (SIM_WINDOW_START * sim_config.duration)) {
+            m->harvested_ss += (double)(p * dt);
+            m->available_ss += (double)(m->p_max * dt);
+        }
+    }
+
+    if(sim_config.profile != NULL) {
+        profile_score(t, sim_plant.pv[PLANT_PV1].v * sim_plant.pv[PLANT_PV1].i_pv, dt);
+    }
+
+    battery_charge += (double)(sim_plant.battery.i * dt);
+    battery_v_min = (sim_plant.battery.v < battery_v_min) ? sim_plant.battery.v : battery_v_min;
+    // the trackers' fast starts move the duty cycles past the charger's limit loops
+    if((charger_regulates(&battery.charger) == true) && (sim_mppt[0]->start.state == Mppt_Start_Done)
+       && (sim_mppt[1]->start.state == Mppt_Start_Done)) {
+        float i_over = sim_plant.battery.i - battery.charger.i_limit;
+        float v_over = sim_plant.battery.v - battery.charger.v_comp - battery.charger.v_limit;
+
+        battery_i_overshoot = (i_over > battery_i_overshoot) ? i_over : battery_i_overshoot;
+        battery_v_overshoot = (v_over > battery_v_overshoot) ? v_over : battery_v_overshoot;
+        if(i_over > (battery.charger.i_limit * SIM_LIMIT_I_BAND)) {
+            battery_i_over_time += (double)dt;
+        }
+        if(v_over > (battery.charger.v_limit * SIM_LIMIT_V_BAND)) {
+            battery_v_over_time += (double)dt;
+        }
+    }
+
+    if((charger_regulates(&battery.charger) == true) && (mppt_overridden(sim_mppt[0]) == false)
+       && (mppt_overridden(sim_mppt[1]) == false)) {
+        battery_i_read_err += (double)((get_battery_i() - sim_plant.battery.i) * dt);
+        battery_i_read_time += (double)dt;
+    }
+
+    if(battery.soc.seeded == true) {
+        float soc_error;
+
+        if(sim_config.soc_error != 0.0f) {
+            battery.soc.charge += (int64_t)((double)sim_config.soc_error * (double)battery.soc.capacity);
+            sim_config.soc_error = 0.0f;
+        }
+        soc_error = battery.soc.fraction - plant_soc_charged();
+        soc_error_sq += (double)(soc_error * soc_error * dt);
+        soc_error_time += (double)dt;
+        soc_error_max = (fabsf(soc_error) > soc_error_max) ? fabsf(soc_error) : soc_error_max;
+    }
+
+    if((trace != NULL) && ((plant_steps % sim_config.trace_decimation) == 0)) {
+        fprintf(trace, "%.3f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f\n",
+                t * 1e6,
+                sim_plant.buck[0].v, sim_plant.buck[1].v,
+                sim_plant.pv[0].v, sim_plant.pv[0].i_pv,
+                sim_plant.pv[1].v, sim_plant.pv[1].i_pv,
+                sim_plant.battery.v, sim_plant.battery.i,
+                sim_duty(PLANT_PV1), sim_duty(PLANT_PV2),
+                sim_duty(PLANT_BUCK_5V), sim_duty(PLANT_BUCK_3V3));
+    }
+    plant_steps++;
+}
+
+static void report(const char * key, double value, const char * unit) {
+    printf("%-32s %14.6f %s\n", key, value, unit);
+}
+
+static void report_converter(const char * name, uint32_t converter) {
+    const SimConverterStats_t * stats = sim_converter_stats(converter);
+    const double ns_per_cycle = 1e9 / (double)SIM_SYSCLK_HZ;
+    char key[64];
+
+    snprintf(key, sizeof(key), "%s.updates", name);
+    report(key, (double)stats->writes, "");
+    if(stats->latency_count != 0) {
+        snprintf(key, sizeof(key), "%s.latency_min", name);
+        report(key, (double)stats->latency_min * ns_per_cycle, "ns");
+        snprintf(key, sizeof(key), "%s.latency_avg", name);
+        report(key, ((double)stats->latency_sum / (double)stats->latency_count) * ns_per_cycle, "ns");
+        snprintf(key, sizeof(key), "%s.latency_max", name);
+        report(key, (double)stats->latency_max * ns_per_cycle, "ns");
+    }
+}
+
+static void report_buck(const char * name, uint32_t n) {
+    const SimBuckMetrics_t * m = &buck_metrics[n];
+    double end = (double)sim_now() / (double)SIM_SYSCLK_HZ;
+    char key[64];
+
+    snprintf(key, sizeof(key), "%s.v_mean", name);
+    report(key, (m->count != 0) ? (m->sum / m->count) : 0.0, "V");
+    snprintf(key, sizeof(key), "%s.v_ripple_pp", name);
+    report(key, (m->count != 0) ? ((m->max - m->min) * 1000.0) : 0.0, "mV");
+    snprintf(key, sizeof(key), "%s.settle_time", name);
+    report(key, (m->settle_time < end) ? (m->settle_time * 1000.0) : -1.0, "ms");
+}
+
+static void report_pv(const char * name, uint32_t n) {
+    const SimPVMetrics_t * m = &pv_metrics[n];
+    double duration = (double)sim_now() / (double)SIM_SYSCLK_HZ;
+    char key[64];
+
+    snprintf(key, sizeof(key), "%s.p_avg", name);
+    report(key, m->harvested / duration, "W");
+    snprintf(key, sizeof(key), "%s.p_available", name);
+    report(key, m->available / duration, "W");
+    snprintf(key, sizeof(key), "%s.tracking_eff", name);
+    report(key, (m->available > 0.0) ? (100.0 * m->harvested / m->available) : 0.0, "%");
+    snprintf(key, sizeof(key), "%s.tracking_eff_ss", name);
+    report(key, (m->available_ss > 0.0) ? (100.0 * m->harvested_ss / m->available_ss) : 0.0, "%");
+    // from the last irradiance change until the power holds within the band
+    snprintf(key, sizeof(key), "%s.converge_time", name);
+    report(key, (m->converge_time >= 0.0) ? (m->converge_time * 1000.0) : -1.0, "ms");
+    // from the last irradiance change, or power-up, until the power first reaches 90% of the MPP
+    snprintf(key, sizeof(key), "%s.rise_time", name);
+    report(key, (m->rise_time >= 0.0) ? (m->rise_time * 1000.0) : -1.0, "ms");
+    snprintf(key, sizeof(key), "%s.fast_starts", name);
+    report(key, (double)sim_mppt[n]->start.starts, "");
+    snprintf(key, sizeof(key), "%s.pace_steps", name);
+    report(key, (double)sim_mppt[n]->pace.steps, "");
+    snprintf(key, sizeof(key), "%s.pace_waits", name);
+    report(key, (double)sim_mppt[n]->pace.waits, "");
+    snprintf(key, sizeof(key), "%s.pace_timeouts", name);
+    report(key, (double)sim_mppt[n]->pace.timeouts, "");
+    snprintf(key, sizeof(key), "%s.pace_holds", name);
+    report(key, (double)sim_mppt[n]->pace.holds, "");
+    snprintf(key, sizeof(key), "%s.pace_resumes", name);
+    report(key, (double)sim_mppt[n]->pace.resumes, "");
+    snprintf(key, sizeof(key), "%s.pace_held", name);
+    report(key, (double)sim_mppt[n]->pace.held, "");
+    snprintf(key, sizeof(key), "%s.loop_runs", name);
+    report(key, (double)sim_pv_loop[n]->runs, "");
+    snprintf(key, sizeof(key), "%s.loop_engages", name);
+    report(key, (double)sim_pv_loop[n]->engages, "");
+    // panel voltage off the reference while the loop holds it, steps included
+    snprintf(key, sizeof(key), "%s.loop_v_err_rms", name);
+    report(key, (m->loop_n > 0.0) ? (1000.0 * sqrt(m->loop_err_sq / m->loop_n)) : 0.0, "mV");
+    if(sim_mppt[n]->strategy_id == Mppt_Ripple_Correlation) {
+        // blocks correlated with the panel loaded
+        snprintf(key, sizeof(key), "%s.rcc_blocks", name);
+        report(key, (double)sim_mppt[n]->state.rcc.blocks, "");
+    }
+    snprintf(key, sizeof(key), "%s.scans", name);
+    report(key, (double)sim_mppt[n]->scan.scans, "");
+    snprintf(key, sizeof(key), "%s.scan_jumps", name);
+    report(key, (double)sim_mppt[n]->scan.jumps, "");
+    snprintf(key, sizeof(key), "%s.scan_aborts", name);
+    report(key, (double)sim_mppt[n]->scan.aborts, "");
+    snprintf(key, sizeof(key), "%s.scan_time", name);
+    report(key, m->scan_time * 1000.0, "ms");
+    snprintf(key, sizeof(key), "%s.scan_energy_lost", name);
+    report(key, m->scan_lost * 1000.0, "mJ");
+    snprintf(key, sizeof(key), "%s.decisions", name);
+    report(key, (double)m->decisions, "");
+    snprintf(key, sizeof(key), "%s.resolvable", name);
+    report(key, (double)m->resolvable, "");
+    snprintf(key, sizeof(key), "%s.wrong_direction", name);
+    report(key, (m->resolvable != 0) ? (100.0 * (double)m->wrong / (double)m->resolvable) : 0.0, "%");
+    snprintf(key, sizeof(key), "%s.dp_error_rms", name);
+    report(key, (m->decisions != 0) ? (1000.0 * sqrt(m->dp_err_sq / (double)m->decisions)) : 0.0, "mW");
+}
+
+/*
+ * Switching ripple in the samples of a net: ripple_rms is what a sample at
+ * an arbitrary point in the period would be off by, sample_err_rms and
+ * sample_bias what the samples actually taken were off by. over_range
+ * counts the samples past the ADC's full scale.
+ */
+static void report_samples(const char * name, ePlantSignal signal) {
+    const SimSampleStats_t * stats = sim_sample_stats(signal);
+    double n = (stats->samples != 0) ? (double)stats->samples : 1.0;
+    char key[64];
+
+    snprintf(key, sizeof(key), "adc.%s.ripple_rms", name);
+    report(key, sqrt(stats->ripple_sq_sum / n), "LSB");
+    snprintf(key, sizeof(key), "adc.%s.sample_err_rms", name);
+    report(key, sqrt(stats->err_sq_sum / n), "LSB");
+    snprintf(key, sizeof(key), "adc.%s.sample_bias", name);
+    report(key, stats->err_sum / n, "LSB");
+    snprintf(key, sizeof(key), "adc.%s.over_range", name);
+    report(key, (double)stats->over_range, "");
+}
+
+/*
+ * The MPPT pairs' samples at their converter's turn-on: turn_on_ripple is
+ * the ripple they caught, about the period average, which ripple
+ * correlation takes for the peak.
+ */
+static void report_turn_on(const char * name, ePlantSignal signal) {
+    const SimSampleStats_t * stats = sim_turn_on_stats(signal);
+    double n = (stats->samples != 0) ? (double)stats->samples : 1.0;
+    char key[64];
+
+    snprintf(key, sizeof(key), "adc.%s.turn_on_samples", name);
+    report(key, (double)stats->samples, "");
+    snprintf(key, sizeof(key), "adc.%s.turn_on_ripple", name);
+    report(key, stats->err_sum / n, "LSB");
+}
+
+#ifdef USE_TRACE
+/*
+ * Firmware task execution times from trace_buffer. Only waits, ISR entry
+ * and preemption take simulated time, so these are lower bounds; overruns
+ * are exact. trace_decode prints the same lines from a saved buffer.
+ */
+static const char * const trace_task_names[Trace_Task_Count] = {
+#define TRACE_TASK_NAME(id, name)   name,
+    TRACE_TASKS(TRACE_TASK_NAME)
+};
+
+static void report_trace(void) {
+    const double ns_per_cycle = 1e9 / (double)SIM_SYSCLK_HZ;
+    char key[64];
+    uint32_t n;
+
+    for(n = 0; n < Trace_Task_Count; n++) {
+        const TraceStats_t * stats = &trace_buffer.stats[n];
+        double total = ((double)stats->total_hi * 4294967296.0) + (double)stats->total_lo;
+
+        snprintf(key, sizeof(key), "trace.%s.count", trace_task_names[n]);
+        report(key, (double)stats->count, "");
+        snprintf(key, sizeof(key), "trace.%s.overruns", trace_task_names[n]);
+        report(key, (double)stats->overruns, "");
+        if(stats->count != 0) {
+            snprintf(key, sizeof(key), "trace.%s.min", trace_task_names[n]);
+            report(key, (double)stats->min * ns_per_cycle, "ns");
+            snprintf(key, sizeof(key), "trace.%s.avg", trace_task_names[n]);
+            report(key, (total / (double)stats->count) * ns_per_cycle, "ns");
+            snprintf(key, sizeof(key), "trace.%s.max", trace_task_names[n]);
+            report(key, (double)stats->max * ns_per_cycle, "ns");
+        }
+    }
+}
+
+/* Same bytes as saving &trace_buffer from the debugger as raw binary */
+static void dump_trace(const char * path) {
+    FILE * dump = fopen(path, "wb");
+
+    if((dump == NULL) || (fwrite(&trace_buffer, sizeof(trace_buffer), 1, dump) != 1)) {
+        perror(path);
+    }
+    if(dump != NULL) {
+        fclose(dump);
+    }
+}
+#endif /* USE_TRACE */
+
+#ifdef USE_KERNEL_BENCH
+/*
+ * Kernel benchmark from bench_results, in backend ticks converted to ns;
+ * hist_N counts the runs of N/2 to N-1 ticks (hist_0: 0 ticks)
+ */
+static const char * const bench_kernel_names[Bench_Kernel_Count] = {
+#define BENCH_KERNEL_NAME(id, name)     name,
+    BENCH_KERNELS(BENCH_KERNEL_NAME)
+};
+
+static void report_bench_result(const char * name, const BenchResult_t * result, double ns_per_tick) {
+    double total = ((double)result->total_hi * 4294967296.0) + (double)result->total_lo;
+    char key[64];
+    uint32_t b;
+
+    if(result->runs == 0) {
+        return;
+    }
+    snprintf(key, sizeof(key), "kbench.%s.runs", name);
+    report(key, (double)result->runs, "");
+    snprintf(key, sizeof(key), "kbench.%s.min", name);
+    report(key, (double)result->min * ns_per_tick, "ns");
+    snprintf(key, sizeof(key), "kbench.%s.avg", name);
+    report(key, (total / (double)result->runs) * ns_per_tick, "ns");
+    snprintf(key, sizeof(key), "kbench.%s.max", name);
+    report(key, (double)result->max * ns_per_tick, "ns");
+    for(b = 0; b < BENCH_HIST_BINS; b++) {
+        if(result->hist[b] != 0) {
+            snprintf(key, sizeof(key), "kbench.%s.hist_%lu", name, (b == 0) ? 0UL : (1UL << b));
+            report(key, (double)result->hist[b], "");
+        }
+    }
+}
+
+static void report_bench(void) {
+    const double ns_per_tick = 1e9 / (double)bench_results.tick_hz;
+    char name[48];
+    uint32_t k;
+
+    report("kbench.done", (double)bench_results.done, "");
+    report("kbench.overhead", (double)bench_results.overhead * ns_per_tick, "ns");
+    for(k = 0; k < Bench_Kernel_Count; k++) {
+        report_bench_result(bench_kernel_names[k], &bench_results.kernel[k], ns_per_tick);
+    }
+    for(k = 0; k < Mppt_Strategy_Count; k++) {
+        snprintf(name, sizeof(name), "mppt_calculate.%s", mppt_strategies[k]->name);
+        report_bench_result(name, &bench_results.mppt_strategy[k], ns_per_tick);
+    }
+}
+#endif /* USE_KERNEL_BENCH */
+
+/*
+ * PV1 along the irradiance profile. The dynamic efficiency is EN 50530's,
+ * the energy harvested over the energy available over the whole profile,
+ * the static one covers the dwells after SIM_PROFILE_SETTLE.
+ */
+static void report_profile(void) {
+    SimProfileMetrics_t * m = &profile_metrics;
+    const SimPVMetrics_t * pv = &pv_metrics[PLANT_PV1];
+    uint32_t settled;
+
+    // the run ended in a dwell
+    if((m->dwell_start >= 0.0) && (m->settled == false)) {
+        m->unsettled++;
+        m->dwell_start = -1.0;
+    }
+    settled = m->dwells - m->unsettled;
+
+    report("profile.eff_static", (m->available_static > 0.0) ? (100.0 * m->harvested_static / m->available_static) : 0.0, "%");
+    report("profile.eff_dynamic", (pv->available > 0.0) ? (100.0 * pv->harvested / pv->available) : 0.0, "%");
+    report("profile.energy_lost", (pv->available - pv->harvested) * 1000.0, "mJ");
+    report("profile.dwells", (double)m->dwells, "");
+    report("profile.unsettled", (double)m->unsettled, "");
+    report("profile.settle_avg", (settled != 0) ? ((m->settle_sum / (double)settled) * 1000.0) : -1.0, "ms");
+    report("profile.settle_max", (settled != 0) ? (m->settle_max * 1000.0) : -1.0, "ms");
+}
+
+/* Charging stages, the time in each from the MPPT ticks spent there */
+static void report_charger(void) {
+    const Charger_t * charger = &battery.charger;
+    char key[64];
+    uint32_t n;
+
+    printf("%-32s %14s\n", "charger.stage", charge_stage_names[charger->cc_cv]);
+    report("charger.transitions", (double)charger->transitions, "");
+    report("charger.faults", (double)charger->faults, "");
+    for(n = 0; n < Charge_Stage_Count; n++) {
+        snprintf(key, sizeof(key), "charger.%s_time", charge_stage_names[n]);
+        report(key, (double)charger->stage_ticks[n] * (CHARGE_TICK_S * 1000.0), "ms");
+    }
+}
+
+/* Load shedding, and the outputs while the power manager keeps them on */
+static void report_power(void) {
+    static const char * const names[2] = { "buck5v", "buck3v3" };
+    char key[64];
+    uint32_t n;
+
+    printf("%-32s %14s\n", "power.level", power_level_names[power_manager.level]);
+    report("power.transitions", (double)power_manager.transitions, "");
+    for(n = 0; n < Power_Level_Count; n++) {
+        snprintf(key, sizeof(key), "power.%s_time", power_level_names[n]);
+        report(key, (double)power_manager.level_ticks[n] * (CHARGE_TICK_S * 1000.0), "ms");
+    }
+    for(n = 0; n < 2; n++) {
+        const SimBuckMetrics_t * m = &buck_metrics[n];
+
+        snprintf(key, sizeof(key), "power.%s_off_time", names[n]);
+        report(key, m->off_time * 1000.0, "ms");
+        snprintf(key, sizeof(key), "power.%s_on_v_min", names[n]);
+        report(key, (m->on_max > 0.0f) ? m->on_min : 0.0, "V");
+        snprintf(key, sizeof(key), "power.%s_on_v_max", names[n]);
+        report(key, m->on_max, "V");
+    }
+}
+
+static void report_pair(const char * name, uint32_t pair) {
+    char key[64];
+
+    snprintf(key, sizeof(key), "adc.%s.vi_skew_max", name);
+    report(key, (double)sim_pair_stats(pair)->skew_max * (1e9 / (double)SIM_SYSCLK_HZ), "ns");
+}
+
+/**
+ * @brief Ends the run: prints the metrics and exits
+ *
+ * @details The firmware main loop never returns, so this is called by
+ *      sim_hal.c from inside whatever wait reached the end of the run.
+ */
+void sim_finish(void) {
+    double duration = (double)sim_now() / (double)SIM_SYSCLK_HZ;
+    const SimSampleStats_t * battery_i = sim_sample_stats(Plant_Battery_I);
+    double battery_i_samples = (battery_i->samples != 0) ? (double)battery_i->samples : 1.0;
+    double harvested;
+    double available;
+
+    report("sim.time", duration * 1000.0, "ms");
+    report("sim.seed", (double)sim_config.seed, "");
+    report("cpu.load", 100.0 * (1.0 - ((double)sim_idle_cycles() / (double)sim_now())), "%");
+    report("isr.buck5v_adc", (double)sim_interrupt_count(BUCK_5V_ADC_INT), "");
+    report("isr.buck3v3_adc", (double)sim_interrupt_count(BUCK_3V3_ADC_INT), "");
+    report("isr.mppt_timer", (double)sim_interrupt_count(MPPT_TIMER_INT), "");
+    report("isr.adc_ring_dma", (double)sim_interrupt_count(ADC_RING_DMA_INT), "");
+    report("isr.adc_ripple_dma", (double)sim_interrupt_count(ADC_RIPPLE_DMA_INT), "");
+    report("isr.pv_loop", (double)sim_interrupt_count(PV_LOOP_TIMER_INT), "");
+#ifdef USE_CLA
+    report("cla.buck5v_task", (double)sim_cla_task_count(BUCK_5V_CLA_TASK), "");
+    report("cla.buck3v3_task", (double)sim_cla_task_count(BUCK_3V3_CLA_TASK), "");
+#endif
+
+    report_converter("buck5v", PLANT_BUCK_5V);
+    report_buck("buck5v", 0);
+    report_converter("buck3v3", PLANT_BUCK_3V3);
+    report_buck("buck3v3", 1);
+
+    report_converter("pv1", PLANT_PV1);
+    report_pv("pv1", PLANT_PV1);
+    report_converter("pv2", PLANT_PV2);
+    report_pv("pv2", PLANT_PV2);
+    harvested = pv_metrics[0].harvested + pv_metrics[1].harvested;
+    available = pv_metrics[0].available + pv_metrics[1].available;
+    report("pv.p_total", harvested / duration, "W");
+    report("pv.tracking_eff", (available > 0.0) ? (100.0 * harvested / available) : 0.0, "%");
+    report("mppt_dual.limit_steps", (double)mppt_dual.limit_steps, "");
+    if(sim_config.profile != NULL) {
+        report_profile();
+    }
+
+    report_samples("pv1_v", Plant_PV1_V);
+    report_samples("pv1_i", Plant_PV1_I);
+    report_turn_on("pv1_v", Plant_PV1_V);
+    report_turn_on("pv1_i", Plant_PV1_I);
+    report_pair("pv1", SIM_PAIR_PV1);
+    report_samples("pv2_v", Plant_PV2_V);
+    report_samples("pv2_i", Plant_PV2_I);
+    report_turn_on("pv2_v", Plant_PV2_V);
+    report_turn_on("pv2_i", Plant_PV2_I);
+    report_pair("pv2", SIM_PAIR_PV2);
+    report_samples("battery_v", Plant_Battery_V);
+    report_samples("battery_i", Plant_Battery_I);
+    report_pair("battery", SIM_PAIR_BATTERY);
+
+    report("adc_ring.blocks", (double)get_adc_ring_stats()->blocks, "");
+    report("adc_ring.overruns", (double)get_adc_ring_stats()->overruns, "");
+    report("adc_ring.ripple_blocks", (double)get_adc_ring_stats()->ripple_blocks, "");
+    report("adc_ring.ripple_misses", (double)get_adc_ring_stats()->ripple_misses, "");
+
+    report("battery.v", sim_plant.battery.v, "V");
+    report("battery.i_avg", battery_charge / duration, "A");
+    report("battery.soc", sim_plant.battery.soc * 100.0, "%");
+    report("battery.v_min", battery_v_min, "V");
+    // the PV bucks' summed switching ripple, over the periods the battery was sampled in
+    report("battery.i_ripple_rms", sqrt(battery_i->ripple_sq_sum / battery_i_samples)
+           * (VREFHI_V / ADC_MAX_VALUE_F) * (1000.0 / I_SENSE_SENS) * 1000.0, "mA");
+    // plant battery current and voltage, less the charger's resistance compensation,
+    // while the charger regulates and neither tracker starts
+    report("battery.i_overshoot", battery_i_overshoot * 1000.0, "mA");
+    report("battery.v_overshoot", battery_v_overshoot * 1000.0, "mV");
+    report("battery.i_over_time", battery_i_over_time * 1000.0, "ms");
+    report("battery.v_over_time", battery_v_over_time * 1000.0, "ms");
+    // what the charger reads off the plant's average current, while it regulates and neither tracker starts or scans
+    report("battery.i_read_bias", (battery_i_read_time > 0.0) ? (1000.0 * battery_i_read_err / battery_i_read_time) : 0.0,
+           "mA");
+    // the firmware's estimate against the plant's charge up to V_BATTERY_CHG_LIMIT, from the tick it starts
+    report("soc.estimate", battery.soc.fraction * 100.0, "%");
+    report("soc.charged", plant_soc_charged() * 100.0, "%");
+    report("soc.error", (battery.soc.fraction - plant_soc_charged()) * 100.0, "%");
+    report("soc.error_rms", (soc_error_time > 0.0) ? (sqrt(soc_error_sq / soc_error_time) * 100.0) : 0.0, "%");
+    report("soc.error_max", soc_error_max * 100.0, "%");
+    report("soc.energy", soc_energy(&battery.soc), "Wh");
+    report("soc.correction_time", (double)battery.soc.corrections * (CHARGE_TICK_S * 1000.0), "ms");
+    // the fitted battery resistance against the plant's
+    report("ir.r", battery.ir.r * 1000.0, "mOhm");
+    report("ir.r_error", (battery.ir.r - sim_plant.battery.r_int) * 1000.0, "mOhm");
+    report("ir.soh", battery.ir.soh * 100.0, "%");
+    report("ir.updates", (double)battery.ir.updates, "");
+    report_charger();
+    report_power();
+
+#ifdef USE_KERNEL_BENCH
+    report_bench();
+#endif
+#ifdef USE_TRACE
+    report_trace();
+    if(sim_config.dump_path != NULL) {
+        dump_trace(sim_config.dump_path);
+    }
+#endif
+
+    if(trace != NULL) {
+        fclose(trace);
+    }
+    fflush(stdout);
+    exit(0);
+}
+
+int main(int argc, char ** argv) {
+    bool duration_set = false;
+    int opt;
+
+    while((opt = getopt(argc, argv, "t:s:n:z:1:2:S:H:P:Lm:Mp:G:frukiaIb:e:g:c:o:d:D:h")) != -1) {
+        switch(opt) {
+        case('t'):
+            sim_config.duration = atof(optarg) / 1000.0;
+            duration_set = true;
+            break;
+        case('s'): sim_config.seed = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case('n'): sim_config.noise_lsb = (float)atof(optarg); break;
+        case('z'): sim_config.i_zero_mv = (float)atof(optarg); break;
+        case('1'): sim_config.irradiance[0] = (float)atof(optarg); break;
+        case('2'): sim_config.irradiance[1] = (float)atof(optarg); break;
+        case('m'):
+            sim_config.mppt_strategy[0] = strtok(optarg, ":");
+            sim_config.mppt_strategy[1] = strtok(NULL, ":");
+            if(sim_config.mppt_strategy[1] == NULL) {
+                sim_config.mppt_strategy[1] = sim_config.mppt_strategy[0];
+            }
+            if((sim_config.mppt_strategy[0] == NULL)
+               || (find_strategy(sim_config.mppt_strategy[0]) == Mppt_Strategy_Count)
+               || (find_strategy(sim_config.mppt_strategy[1]) == Mppt_Strategy_Count)) {
+                usage(argv[0]);
+            }
+            break;
+        case('M'):
+            for(opt = 0; opt < (int)Mppt_Strategy_Count; opt++) {
+                printf("%s\n", mppt_strategies[opt]->name);
+            }
+            return 0;
+        case('H'): sim_config.shading = (float)atof(optarg); break;
+        case('P'):
+            sim_config.profile = sim_profile_find(optarg);
+            if(sim_config.profile == NULL) {
+                usage(argv[0]);
+            }
+            break;
+        case('L'):
+            for(opt = 0; opt < (int)sim_profile_count; opt++) {
+                printf("%-12s %s\n", sim_profiles[opt].name, sim_profiles[opt].description);
+            }
+            return 0;
+        case('p'):
+            if((sscanf(optarg, "%f:%f", &sim_config.delta_d[0], &sim_config.delta_d[1]) != 2)
+               || (sim_config.delta_d[0] < 0.0f)) {
+                usage(argv[0]);
+            }
+            break;
+        case('G'):
+            if((sscanf(optarg, "%f", &sim_config.gain) != 1) || (sim_config.gain < 0.0f)) {
+                usage(argv[0]);
+            }
+            break;
+        case('f'): sim_config.fast_start = false; break;
+        case('r'): sim_config.pace = false; break;
+        case('u'): sim_config.pv_loop = false; break;
+        case('k'): sim_config.charger_pi = false; break;
+        case('i'): sim_config.ir_comp = false; break;
+        case('a'): sim_config.power_manager = false; break;
+        case('I'): sim_config.interleave = false; break;
+        case('b'):
+            if((sscanf(optarg, "%f:%f:%f", &sim_config.battery[0], &sim_config.battery[1],
+                       &sim_config.battery[2]) < 1)
+               || (sim_config.battery[0] < 0.0f) || (sim_config.battery[1] == 0.0f)) {
+                usage(argv[0]);
+            }
+            break;
+        case('e'): sim_config.soc_error = (float)atof(optarg); break;
+        case('g'): sim_config.scan_interval = atoi(optarg); break;
+        case('c'):
+            sim_config.dual_mode = (int32_t)find_dual_mode(optarg);
+            if(sim_config.dual_mode == (int32_t)Mppt_Dual_Mode_Count) {
+                usage(argv[0]);
+            }
+            break;
+        case('S'):
+            if(sscanf(optarg, "%lf:%f", &sim_config.step_time, &sim_config.step_irradiance) != 2) {
+                usage(argv[0]);
+            }
+            sim_config.step_time /= 1000.0;
+            break;
+        case('o'): sim_config.trace_path = optarg; break;
+        case('d'): sim_config.trace_decimation = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case('D'): sim_config.dump_path = optarg; break;
+        default: usage(argv[0]);
+        }
+    }
+    if((sim_config.profile != NULL) && (duration_set == false)) {
+        sim_config.duration = sim_profile_duration(sim_config.profile);
+    }
+    if((sim_config.duration <= 0.0) || (sim_config.trace_decimation == 0)) {
+        usage(argv[0]);
+    }
+
+    if(sim_config.trace_path != NULL) {
+        trace = fopen(sim_config.trace_path, "w");
+        if(trace == NULL) {
+            perror(sim_config.trace_path);
+            return 1;
+        }
+        fprintf(trace, "t_us,buck5v_v,buck3v3_v,pv1_v,pv1_i,pv2_v,pv2_i,"
+                       "batt_v,batt_i,pv1_d,pv2_d,buck5v_d,buck3v3_d\n");
+    }
+
+    // no irradiance matches, so the first plant step computes p_max
+    pv_metrics[0].irradiance = -1.0f;
+    pv_metrics[1].irradiance = -1.0f;
+    profile_metrics.point.segment = UINT32_MAX;
+    profile_metrics.dwell_start = -1.0;
+
+    sim_hal_init();
+    ifec_main();
+
+    // not reached, sim_finish() exits
+    return 1;
+}
@@ -0,0 +1,220 @@
+/*
+ * trace_decode.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Host decoder for a saved trace_buffer (see include/trace.h). Accepts
+ *  either a raw binary image (CCS "Save Memory", TI Raw Data, or the
+ *  simulator's -D) or a TI .dat hex file saved with 16-bit words. Prints
+ *  the per-task statistics as "key value unit" lines, the same as the
+ *  simulator, and with -e every event in the ring oldest first.
+ *
+ *  Everything in trace_buffer is a 32-bit word stored low half first, so the
+ *  file is read as a stream of little-endian words rather than cast onto
+ *  the struct.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "trace.h"
+
+#define DECODE_HEADER_WORDS     6U
+#define DECODE_STATS_WORDS      (sizeof(TraceStats_t) / sizeof(uint32_t))
+#define DECODE_ENTRY_WORDS      (sizeof(TraceEntry_t) / sizeof(uint32_t))
+#define DAT_MAGIC               "1651"
+
+static const char * const task_names[Trace_Task_Count] = {
+#define TRACE_TASK_NAME(id, name)   name,
+    TRACE_TASKS(TRACE_TASK_NAME)
+};
+
+static const char * const event_names[] = { "start", "end", "overrun" };
+
+static uint32_t * words;
+static size_t words_size;
+
+
+static void report(const char * key, double value, const char * unit) {
+    printf("%-32s %14.6f %s\n", key, value, unit);
+}
+
+static void usage(const char * name) {
+    fprintf(stderr,
+            "usage: %s [-e] dump\n"
+            "  dump  trace_buffer saved as raw binary or as a TI .dat file\n"
+            "  -e    list the ring's events, oldest first\n",
+            name);
+    exit(2);
+}
+
+/**
+ * @brief Sets 16-bit half n of the dump, growing it as needed
+ */
+static void store_half(size_t n, uint32_t half) {
+    if((n / 2U) >= words_size) {
+        words_size = (words_size != 0) ? (2U * words_size) : 1024U;
+        words = realloc(words, words_size * sizeof(uint32_t));
+        if(words == NULL) {
+            perror("realloc");
+            exit(1);
+        }
+        memset(&words[words_size / 2U], 0, (words_size / 2U) * sizeof(uint32_t));
+    }
+    if((n & 1U) == 0) {
+        words[n / 2U] = half;
+    }
+    else {
+        words[n / 2U] |= half << 16;
+    }
+}
+
+/**
+ * @brief Reads a TI .dat file: one header line, then one 16-bit word per line
+ *
+ * @return Number of 32-bit words read
+ */
+static size_t read_dat(FILE * file) {
+    char line[64];
+    size_t halves = 0;
+
+    if(fgets(line, sizeof(line), file) == NULL) {
+        return 0;
+    }
+    while(fgets(line, sizeof(line), file) != NULL) {
+        store_half(halves++, (uint32_t)strtoul(line, NULL, 16) & 0xFFFFU);
+    }
+    return halves / 2U;
+}
+
+/**
+ * @brief Reads a raw little-endian image
+ *
+ * @return Number of 32-bit words read
+ */
+static size_t read_raw(FILE * file) {
+    unsigned char bytes[2];
+    size_t halves = 0;
+
+    while(fread(bytes, 1, sizeof(bytes), file) == sizeof(bytes)) {
+        store_half(halves++, (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8));
+    }
+    return halves / 2U;
+}
+
+static size_t read_dump(const char * path) {
+    FILE * file = fopen(path, "rb");
+    char magic[sizeof(DAT_MAGIC) - 1U];
+    size_t n;
+
+    if(file == NULL) {
+        perror(path);
+        exit(1);
+    }
+    n = fread(magic, 1, sizeof(magic), file);
+    rewind(file);
+    if((n == sizeof(magic)) && (memcmp(magic, DAT_MAGIC, sizeof(magic)) == 0)) {
+        n = read_dat(file);
+    }
+    else {
+        n = read_raw(file);
+    }
+    fclose(file);
+    return n;
+}
+
+static void print_stats(const uint32_t * stats, uint32_t task_count, double ns_per_cycle) {
+    char key[64];
+    uint32_t n;
+
+    for(n = 0; n < task_count; n++, stats += DECODE_STATS_WORDS) {
+        const char * name = (n < Trace_Task_Count) ? task_names[n] : "unknown";
+        double total = ((double)stats[5] * 4294967296.0) + (double)stats[4];
+
+        snprintf(key, sizeof(key), "trace.%s.count", name);
+        report(key, (double)stats[0], "");
+        snprintf(key, sizeof(key), "trace.%s.overruns", name);
+        report(key, (double)stats[1], "");
+        if(stats[0] != 0) {
+            snprintf(key, sizeof(key), "trace.%s.min", name);
+            report(key, (double)stats[2] * ns_per_cycle, "ns");
+            snprintf(key, sizeof(key), "trace.%s.avg", name);
+            report(key, (total / (double)stats[0]) * ns_per_cycle, "ns");
+            snprintf(key, sizeof(key), "trace.%s.max", name);
+            report(key, (double)stats[3] * ns_per_cycle, "ns");
+        }
+    }
+}
+
+/**
+ * @brief Lists the ring oldest first, with the time since the previous event
+ */
+static void print_events(const uint32_t * ring, uint32_t ring_size, uint32_t written,
+                         double ns_per_cycle) {
+    uint32_t count = (written < ring_size) ? written : ring_size;
+    uint32_t first = written - count;
+    uint32_t previous = 0;
+    uint32_t n;
+
+    printf("%10s %12s  %-16s %s\n", "entry", "dt_ns", "task", "event");
+    for(n = first; n != written; n++) {
+        const uint32_t * entry = &ring[(n % ring_size) * DECODE_ENTRY_WORDS];
+        uint32_t task = TRACE_EVENT_TASK(entry[1]);
+        uint32_t type = TRACE_EVENT_TYPE(entry[1]);
+
+        printf("%10lu %12.0f  %-16s %s\n", (unsigned long)n,
+               (n == first) ? 0.0 : (double)(entry[0] - previous) * ns_per_cycle,
+               (task < Trace_Task_Count) ? task_names[task] : "unknown",
+               (type < (sizeof(event_names) / sizeof(event_names[0]))) ? event_names[type] : "unknown");
+        previous = entry[0];
+    }
+}
+
+int main(int argc, char ** argv) {
+    bool events = false;
+    size_t n;
+    uint32_t task_count;
+    uint32_t ring_size;
+    size_t needed;
+    double ns_per_cycle;
+    int opt;
+
+    while((opt = getopt(argc, argv, "eh")) != -1) {
+        switch(opt) {
+        case('e'): events = true; break;
+        default: usage(argv[0]);
+        }
+    }
+    if(optind != (argc - 1)) {
+        usage(argv[0]);
+    }
+
+    n = read_dump(argv[optind]);
+    if((n < DECODE_HEADER_WORDS) || (words[0] != TRACE_MAGIC) || (words[1] != TRACE_VERSION)) {
+        fprintf(stderr, "%s: not a version %u trace_buffer\n", argv[optind], TRACE_VERSION);
+        return 1;
+    }
+
+    // sizes come from the dump, so a build with a different TRACE_RING_SIZE still decodes
+    task_count = words[3];
+    ring_size = words[4];
+    needed = DECODE_HEADER_WORDS + ((size_t)task_count * DECODE_STATS_WORDS)
+             + ((size_t)ring_size * DECODE_ENTRY_WORDS);
+    if((words[2] == 0) || (ring_size == 0) || (needed > n)) {
+        fprintf(stderr, "%s: truncated, %lu of %lu words\n", argv[optind],
+                (unsigned long)n, (unsigned long)needed);
+        return 1;
+    }
+    ns_per_cycle = 1e9 / (double)words[2];
+
+    report("trace.sysclk", (double)words[2] / 1e6, "MHz");
+    report("trace.events", (double)words[5], "");
+    print_stats(&words[DECODE_HEADER_WORDS], task_count, ns_per_cycle);
+    if(events) {
+        print_events(&words[DECODE_HEADER_WORDS + (task_count * DECODE_STATS_WORDS)],
+                     ring_size, words[5], ns_per_cycle);
+    }
+    return 0;
+}
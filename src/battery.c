@@ -3,68 +3,381 @@
  *
  *  Created on: Jun 13, 2020
  *      Author: jack
+ *
+ *  The charger runs once per MPPT tick, before the trackers. Its stages:
+ *
+ *      Precharge   under V_BATTERY_PRECHARGE, limited to I_BATTERY_PRECHARGE
+ *      CC          I_BATTERY_MAX_LIMIT, until the battery is within
+ *                  V_BATTERY_CV_BAND of V_BATTERY_CHG_LIMIT
+ *      CV          V_BATTERY_CHG_LIMIT, until the current stays under
+ *                  I_BATTERY_MIN_LIMIT for CHARGE_TERM_S
+ *      Full        converters off, until the battery falls to V_BATTERY_MAX_LIMIT
+ *      Float       V_BATTERY_MAX_LIMIT, the PV supplies the loads; back to CC
+ *                  V_BATTERY_STAGE_HYST under it
+ *      Fault       converters off: over V_BATTERY_OVP or I_BATTERY_OCP for
+ *                  CHARGE_FAULT_S, or a precharge or charge that takes too long
+ *
+ *  Every stage change but a fault has to be asked for CHARGE_DEBOUNCE_S in a
+ *  row, and the thresholds back have V_BATTERY_STAGE_HYST of hysteresis.
+ *
+ *  In every stage that charges, a current and a voltage limit loop cap the
+ *  trackers' steps. Each is a PI in velocity form: its output is the most a
+ *  step may raise a duty cycle by, Ki * Ts * error + Kp * change in error,
+ *  and the smaller of the two loops' outputs caps the steps. Under the
+ *  limits the cap is large and the trackers step freely; at a limit it
+ *  shrinks as the error does. Within CHARGE_I_BAND or CHARGE_V_BAND of the
+ *  limit the proportional term brakes a current or voltage that is still
+ *  rising, but never speeds the steps up. Over a limit the cap is
+ *  negative, and the input whose turn it is steps down.
+ *
+ *  The state of charge (src/soc.c) counts every tick, and a terminated
+ *  charge sets it full.
+ *
+ *  While charging, the battery voltage rises over its open-circuit voltage
+ *  by the current through its resistance. The stages and the voltage loop
+ *  see the voltage less that drop, the fitted resistance (src/battery_ir.c)
+ *  times the current, at most CHARGE_IR_COMP_MAX. CV then holds the cells
+ *  themselves nearer V_BATTERY_CHG_LIMIT, and the current tapers off
+ *  sooner. The faults stay on the voltage as measured.
  */
 
 #include "battery.h"
 #include "config.h"
+#include "mppt.h"
 #include "src_adc.h"
 
+/** Indexed by eBatteryChargeType */
+const char * const charge_stage_names[Charge_Stage_Count] = {
+    "inactive",
+    "precharge",
+    "cc",
+    "cv",
+    "float",
+    "full",
+    "fault"
+};
+
 
 void init_battery(Battery_t * battery)
 {
     battery->voltage = get_battery_v();
     battery->current = get_battery_i();
     battery->state = Supply;
-    battery->charger.cc_cv = Charging_Inactive;
+    init_charger(&battery->charger, true);
+    soc_init(&battery->soc, SOC_CAPACITY_AH);
+    battery_ir_init(&battery->ir, IR_R_NEW);
+}
+
+/**
+ * @brief Resets the charger to inactive, with its statistics
+ *
+ * @param pi false caps the trackers' steps in proportion to the current or
+ *      voltage error, MPPT_DUAL_CC_GAIN or MPPT_DUAL_CV_GAIN, without the
+ *      PI loops
+ */
+void init_charger(Charger_t * charger, bool pi)
+{
+    uint32_t n;
+
+    charger->cc_cv = Charging_Inactive;
+    charger->source = Not_Charging;
+    charger->pi = pi;
+    charger->ir_comp = true;
+    charger->v_comp = 0.0f;
+    charger->i_limit = 0.0f;
+    charger->v_limit = 0.0f;
+    charger->i_error = 0.0f;
+    charger->v_error = 0.0f;
+    charger->headroom = 0.0f;
+    charger->pending = Charging_Inactive;
+    charger->held = 0;
+    charger->ticks = 0;
+    charger->charge_ticks = 0;
+    for(n = 0; n < Charge_Stage_Count; n++)
+    {
+        charger->stage_ticks[n] = 0;
+    }
+    charger->transitions = 0;
+    charger->faults = 0;
 }
 
 void update_battery(Battery_t * battery)
 {
     battery->voltage = get_battery_v();
     battery->current = get_battery_i();
+    soc_update(&battery->soc, get_battery_v_ctl(), get_battery_i_ctl());
+    battery_ir_update(&battery->ir, battery->voltage, battery->current);
     determine_battery_state(battery);
+    update_charger(battery);
+}
+
+/**
+ * @brief True in the stages where the converters charge under the limit loops
+ */
+bool charger_regulates(const Charger_t * charger)
+{
+    return (charger->cc_cv == Precharge) || (charger->cc_cv == Continuous_Current)
+           || (charger->cc_cv == Continuous_Voltage) || (charger->cc_cv == Float_Charge);
+}
+
+/**
+ * @brief Battery voltage the stages and the voltage loop see [V]
+ */
+static float charger_voltage(const Battery_t * battery)
+{
+    return battery->voltage - battery->charger.v_comp;
+}
 
-    if(battery->state == Charge)
+/**
+ * @brief Moves to a stage, with its limits, and restarts the limit loops there
+ */
+static void charger_enter(Battery_t * battery, eBatteryChargeType stage)
+{
+    Charger_t * charger = &battery->charger;
+
+    if(stage == charger->cc_cv)
     {
-        battery->charger.cc_cv = determine_cc_cv(*battery);
+        return;
     }
-    else
+    // a charge begins in precharge, or in CC from anywhere but precharge and CV
+    if((stage == Precharge) || ((stage == Continuous_Current) && (charger->cc_cv != Precharge)
+                                && (charger->cc_cv != Continuous_Voltage)))
     {
-        battery->charger.cc_cv = Charging_Inactive;
+        charger->charge_ticks = 0;
+    }
+    charger->cc_cv = stage;
+    charger->pending = stage;
+    charger->held = 0;
+    charger->ticks = 0;
+    charger->transitions++;
+
+    charger->i_limit = (stage == Precharge) ? I_BATTERY_PRECHARGE : I_BATTERY_MAX_LIMIT;
+    charger->v_limit = (stage == Float_Charge) ? V_BATTERY_MAX_LIMIT : V_BATTERY_CHG_LIMIT;
+    charger->i_error = charger->i_limit - battery->current;
+    charger->v_error = charger->v_limit - charger_voltage(battery);
+    if(stage == Battery_Full)
+    {
+        soc_set_full(&battery->soc);
     }
 }
 
-eBatteryChargeType determine_cc_cv(Battery_t battery)
+/**
+ * @brief Enters a stage once it has been asked for ticks in a row
+ */
+static void charger_request(Battery_t * battery, eBatteryChargeType stage, uint32_t ticks)
 {
-    if((battery.current <= I_BATTERY_MIN_LIMIT) && (battery.voltage >= V_BATTERY_MAX_LIMIT)) {
-            return Battery_Full;
+    Charger_t * charger = &battery->charger;
+
+    if(stage != charger->pending)
+    {
+        charger->pending = stage;
+        charger->held = 0;
     }
-    else if(battery.voltage < V_BATTERY_MAX_LIMIT)
+    if(++charger->held >= ticks)
     {
-        return Continuous_Current;
+        charger_enter(battery, stage);
     }
-    else
+}
+
+/**
+ * @brief The stage the battery's voltage and current ask for, or the current one
+ */
+static eBatteryChargeType charger_next(const Battery_t * battery)
+{
+    const Charger_t * charger = &battery->charger;
+    float v = charger_voltage(battery);
+
+    switch(charger->cc_cv)
     {
-        return Continuous_Voltage;
+    case(Charging_Inactive):
+        return (v < V_BATTERY_PRECHARGE) ? Precharge : Continuous_Current;
+    case(Precharge):
+        if(v > (V_BATTERY_PRECHARGE + V_BATTERY_STAGE_HYST))
+        {
+            return Continuous_Current;
+        }
+        break;
+    case(Continuous_Current):
+        if(v < V_BATTERY_PRECHARGE)
+        {
+            return Precharge;
+        }
+        if(v >= (V_BATTERY_CHG_LIMIT - V_BATTERY_CV_BAND))
+        {
+            return Continuous_Voltage;
+        }
+        break;
+    case(Continuous_Voltage):
+        if(v < (V_BATTERY_CHG_LIMIT - V_BATTERY_STAGE_HYST))
+        {
+            return Continuous_Current;
+        }
+        break;
+    case(Battery_Full):
+        if(v < V_BATTERY_MAX_LIMIT)
+        {
+            return Float_Charge;
+        }
+        break;
+    case(Float_Charge):
+        if(v < (V_BATTERY_MAX_LIMIT - V_BATTERY_STAGE_HYST))
+        {
+            return Continuous_Current;
+        }
+        break;
+    default:
+        break;
     }
+    return charger->cc_cv;
 }
 
-void determine_battery_state(Battery_t * battery)
+/**
+ * @brief Cap on this tick's MPPT steps from the current and voltage limit loops [% duty]
+ */
+static float charger_headroom(Charger_t * charger, float i_error, float v_error)
 {
-    if(get_mppt_v(MPPT_ONE_ID) > battery->voltage)
+    float h_i = CHARGE_I_KI * CHARGE_TICK_S * i_error;
+    float h_v = CHARGE_V_KI * CHARGE_TICK_S * v_error;
+    float d_i = i_error - charger->i_error;
+    float d_v = v_error - charger->v_error;
+
+    // only near a limit, and only against a rise: the battery's current and
+    // voltage show a step ticks late, a falling one is no reason to step faster
+    if((i_error < CHARGE_I_BAND) && (d_i < 0.0f))
     {
-        battery->state = Charge;
+        h_i += CHARGE_I_KP * d_i;
+    }
+    if((v_error < CHARGE_V_BAND) && (d_v < 0.0f))
+    {
+        h_v += CHARGE_V_KP * d_v;
+    }
+
+    if(charger->pi == false)
+    {
+        if((charger->cc_cv == Continuous_Current) || (charger->cc_cv == Precharge))
+        {
+            return MPPT_DUAL_CC_GAIN * i_error;
+        }
+        return MPPT_DUAL_CV_GAIN * v_error;
+    }
+    return (h_i < h_v) ? h_i : h_v;
+}
 
-        if(get_mppt_v(MPPT_ONE_ID) > get_mppt_v(MPPT_TWO_ID))
+/**************************************************
+ * update_charger
+ *
+ * @brief Runs the charging stages and limit loops for one MPPT tick
+ *
+ * @details Call with the battery's voltage and current of this tick, after
+ *  determine_battery_state(). The trackers follow charger.headroom in the
+ *  stages charger_regulates() is true for. A battery that stops charging
+ *  goes back to inactive, but a fault holds through it. A battery reading
+ *  at the divider's full scale faults like V_BATTERY_OVP, since the battery
+ *  could be at any voltage over it.
+ *
+ **************************************************/
+void update_charger(Battery_t * battery)
+{
+    Charger_t * charger = &battery->charger;
+    float i_error;
+    float v_error;
+    eBatteryChargeType next;
+
+    charger->ticks++;
+    charger->stage_ticks[charger->cc_cv]++;
+    charger->v_comp = 0.0f;
+    if((charger->ir_comp == true) && (battery->current > 0.0f))
+    {
+        charger->v_comp = battery->ir.r * battery->current;
+        charger->v_comp = (charger->v_comp > CHARGE_IR_COMP_MAX) ? CHARGE_IR_COMP_MAX : charger->v_comp;
+        charger->v_comp = (charger->v_comp < 0.0f) ? 0.0f : charger->v_comp;
+    }
+
+    if(charger->cc_cv == Charge_Fault)
+    {
+        if((battery->voltage > V_BATTERY_CHG_LIMIT) || (battery->voltage >= V_BATT_SENSE_MAX)
+           || (battery->current > I_BATTERY_MAX_LIMIT))
+        {
+            charger->ticks = 0;
+        }
+        else if(charger->ticks >= CHARGE_TICKS(CHARGE_FAULT_RETRY_S))
+        {
+            charger_enter(battery, Charging_Inactive);
+        }
+        return;
+    }
+
+    if((battery->voltage > V_BATTERY_OVP) || (battery->voltage >= V_BATT_SENSE_MAX)
+       || (battery->current > I_BATTERY_OCP))
+    {
+        charger_request(battery, Charge_Fault, CHARGE_TICKS(CHARGE_FAULT_S));
+    }
+    else if(battery->state != Charge)
+    {
+        charger_enter(battery, Charging_Inactive);
+        return;
+    }
+    else
+    {
+        next = charger_next(battery);
+        if((charger->cc_cv == Continuous_Voltage) && (battery->current < I_BATTERY_MIN_LIMIT))
+        {
+            next = Battery_Full;
+            charger_request(battery, next, CHARGE_TICKS(CHARGE_TERM_S));
+        }
+        else if(charger->cc_cv == Charging_Inactive)
+        {
+            charger_enter(battery, next);
+        }
+        else if(next != charger->cc_cv)
         {
-            battery->charger.source = PV1;
+            charger_request(battery, next, CHARGE_TICKS(CHARGE_DEBOUNCE_S));
         }
         else
         {
-            battery->charger.source = PV2;
+            charger->pending = charger->cc_cv;
+            charger->held = 0;
         }
     }
-    else if(get_mppt_v(MPPT_TWO_ID) > battery->voltage)
+
+    if((charger->cc_cv == Continuous_Current) || (charger->cc_cv == Continuous_Voltage))
+    {
+        charger->charge_ticks++;
+    }
+    if(((charger->cc_cv == Precharge) && (charger->ticks >= CHARGE_TICKS(CHARGE_PRECHARGE_MAX_S)))
+       || (charger->charge_ticks >= CHARGE_TICKS(CHARGE_MAX_S)))
+    {
+        charger_enter(battery, Charge_Fault);
+    }
+    if(charger->cc_cv == Charge_Fault)
+    {
+        charger->faults++;
+        return;
+    }
+
+    i_error = charger->i_limit - battery->current;
+    v_error = charger->v_limit - charger_voltage(battery);
+    charger->headroom = charger_headroom(charger, i_error, v_error);
+    charger->i_error = i_error;
+    charger->v_error = v_error;
+}
+
+/**
+ * @brief Charges while a panel is PV_HYSTERISIS over the battery voltage,
+ *      until no panel is over it
+ */
+void determine_battery_state(Battery_t * battery)
+{
+    float v_one = get_mppt_v(MPPT_ONE_ID);
+    float v_two = get_mppt_v(MPPT_TWO_ID);
+    float v_on = (battery->state == Charge) ? battery->voltage : (battery->voltage + PV_HYSTERISIS);
+
+    if((v_one > v_on) && (v_one > v_two))
+    {
+        battery->state = Charge;
+        battery->charger.source = PV1;
+    }
+    else if(v_two > v_on)
     {
         battery->state = Charge;
         battery->charger.source = PV2;
@@ -75,5 +388,3 @@ void determine_battery_state(Battery_t * battery)
         battery->charger.source = Not_Charging;
     }
 }
-
-
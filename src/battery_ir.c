@@ -0,0 +1,76 @@
+/*
+ * battery_ir.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Internal resistance. From one MPPT tick to the next the battery's
+ *  open-circuit voltage barely moves, so a change in its current shows in
+ *  its voltage through the ohmic resistance alone,
+ *      dv = R * di
+ *  The trackers' steps and the charger's limit loops move the current
+ *  enough to fit R by recursive least squares on every tick the current
+ *  changes by IR_DI_MIN or more; smaller changes are mostly ADC noise, and
+ *  noise in di would pull the fit towards 0. IR_FORGET lets older ticks go,
+ *  so the fit follows the resistance as the battery warms, cools and ages.
+ *
+ *  The resistance of a Li-ion cell about doubles over its life while its
+ *  capacity fades, and the state of health is where R lies between
+ *  IR_R_NEW and IR_R_EOL. The charger takes R times the charging current
+ *  off the battery voltage (src/battery.c).
+ */
+
+#include "battery_ir.h"
+#include "config.h"
+
+
+/**
+ * @param r Resistance to start from [Ohm]
+ */
+void battery_ir_init(BatteryIr_t * ir, float r) {
+    ir->r = r;
+    ir->p = IR_P_INIT;
+    ir->v_last = 0.0f;
+    ir->i_last = 0.0f;
+    ir->soh = 1.0f;
+    ir->updates = 0;
+    ir->primed = false;
+}
+
+/**************************************************
+ * battery_ir_update
+ *
+ * @brief Fits one MPPT tick's change in battery voltage and current
+ *
+ * @param v Battery voltage [V], 0 before the ADC has averaged a block
+ *
+ * @param i Into the battery [A]
+ *
+ **************************************************/
+void battery_ir_update(BatteryIr_t * ir, float v, float i) {
+    float di = i - ir->i_last;
+    float dv = v - ir->v_last;
+    float k;
+    float soh;
+
+    if((ir->primed == false) || (v <= 0.0f)) {
+        ir->v_last = v;
+        ir->i_last = i;
+        ir->primed = (v > 0.0f);
+        return;
+    }
+    ir->v_last = v;
+    ir->i_last = i;
+    if((di < IR_DI_MIN) && (di > -IR_DI_MIN)) {
+        return;
+    }
+
+    k = (ir->p * di) / (IR_FORGET + (ir->p * di * di));
+    ir->r += k * (dv - (ir->r * di));
+    ir->p = (ir->p - (k * di * ir->p)) / IR_FORGET;
+    ir->p = (ir->p > IR_P_INIT) ? IR_P_INIT : ir->p;
+    ir->updates++;
+
+    soh = (IR_R_EOL - ir->r) / (IR_R_EOL - IR_R_NEW);
+    soh = (soh < 0.0f) ? 0.0f : soh;
+    ir->soh = (soh > 1.0f) ? 1.0f : soh;
+}
@@ -0,0 +1,207 @@
+/*
+ * bench.c
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "bench.h"
+#include "pid.h"
+#include "compensator.h"
+#include "battery_ir.h"
+#include "mppt.h"
+#include "soc.h"
+#include "src_adc.h"
+#include "src_epwm.h"
+#include "src_dma.h"
+
+#ifdef USE_KERNEL_BENCH
+
+#define BENCH_OVERHEAD_RUNS     64U
+#define BENCH_DUTY_PWM          MPPT_1_PWM
+
+/*
+ * Times one call: the kernel sits between two backend reads with nothing
+ * else, so the overhead measured with an empty call is all that is added
+ */
+#define BENCH_MEASURE(result, call)                         \
+    do {                                                    \
+        uint32_t bench_t0 = bench_timer_read();             \
+        call;                                               \
+        bench_record((result), bench_timer_read() - bench_t0); \
+    } while(0)
+
+#define BENCH_KERNEL(id)        (&bench_results.kernel[(id)])
+
+#pragma DATA_SECTION(bench_results, "ramgs1")
+BenchResults_t bench_results;
+
+static PID_t bench_pid;
+static Compensator_t bench_cntl;
+static MPPT_t bench_mppt;
+static Soc_t bench_soc;
+static BatteryIr_t bench_ir;
+static AdcRingRipple_t bench_ripple;
+static uint16_t bench_v_block[ADC_RIPPLE_BLOCK];
+static uint16_t bench_i_block[ADC_RIPPLE_BLOCK];
+static volatile float bench_sink;
+static uint32_t bench_rng = 1;
+
+
+/**
+ * @brief xorshift32, gives the kernels inputs that take all their branches
+ *
+ * @return Uniform in [-1, 1)
+ */
+static float bench_uniform(void) {
+    bench_rng ^= bench_rng << 13;
+    bench_rng ^= bench_rng >> 17;
+    bench_rng ^= bench_rng << 5;
+    return ((float)(bench_rng >> 8) * (2.0f / 16777216.0f)) - 1.0f;
+}
+
+/**
+ * @brief Histogram bin of a run: 0 for 0 ticks, else one past the top set bit
+ */
+static uint32_t bench_bin(uint32_t ticks) {
+    uint32_t bin = 0;
+
+    while(ticks != 0) {
+        ticks >>= 1;
+        bin++;
+    }
+    return bin;
+}
+
+static void bench_record(BenchResult_t * result, uint32_t ticks) {
+    ticks = (ticks > bench_results.overhead) ? (ticks - bench_results.overhead) : 0U;
+    result->runs++;
+    result->min = (ticks < result->min) ? ticks : result->min;
+    result->max = (ticks > result->max) ? ticks : result->max;
+    result->total_lo += ticks;
+    result->total_hi += (result->total_lo < ticks) ? 1U : 0U;
+    result->hist[bench_bin(ticks)]++;
+}
+
+/**
+ * @brief Smallest cost of two back-to-back backend reads
+ */
+static uint32_t bench_overhead(void) {
+    uint32_t best = UINT32_MAX;
+    uint32_t n;
+
+    for(n = 0; n < BENCH_OVERHEAD_RUNS; n++) {
+        uint32_t t0 = bench_timer_read();
+        uint32_t ticks = bench_timer_read() - t0;
+        best = (ticks < best) ? ticks : best;
+    }
+    return best;
+}
+
+static void bench_reset_result(BenchResult_t * result) {
+    uint32_t b;
+
+    result->runs = 0;
+    result->min = UINT32_MAX;
+    result->max = 0;
+    result->total_lo = 0;
+    result->total_hi = 0;
+    for(b = 0; b < BENCH_HIST_BINS; b++) {
+        result->hist[b] = 0;
+    }
+}
+
+static void bench_reset(void) {
+    uint32_t k;
+
+    for(k = 0; k < Bench_Kernel_Count; k++) {
+        bench_reset_result(&bench_results.kernel[k]);
+    }
+    for(k = 0; k < Mppt_Strategy_Count; k++) {
+        bench_reset_result(&bench_results.mppt_strategy[k]);
+    }
+    bench_results.done = 0;
+}
+
+/**
+ * @brief Times every kernel iterations times
+ *
+ * @details Call with interrupts disabled, so no run includes an ISR, and
+ *      before the ePWM pins are muxed: change_pwm_duty_cycle() is timed on
+ *      BENCH_DUTY_PWM with random duty cycles. The controllers are private
+ *      instances; the running ones are not touched. The ADC conversions are
+ *      timed through update_mppt_conversions(), four update_conversion()
+ *      calls after adc_ring_update() finds no new DMA block. soc_update()
+ *      runs as if the battery had rested long enough, so every current
+ *      under SOC_REST_I takes the open-circuit voltage correction.
+ *      battery_ir_update() sees current changes over IR_DI_MIN most ticks.
+ *      adc_ring_correlate() runs on a private block of turn-on pairs about a
+ *      mid-scale operating point, as adc_ring_update() does for each input
+ *      the DMA ring correlates.
+ */
+void bench_run_suite(uint32_t iterations) {
+    uint32_t n;
+    uint32_t k;
+    float v_batt;
+    float i_batt;
+
+    bench_timer_init();
+    bench_reset();
+    bench_results.tick_hz = bench_timer_hz();
+    bench_results.overhead = 0;
+    bench_results.overhead = bench_overhead();
+
+    PID_init(&bench_pid, BUCK_KP, BUCK_KI, BUCK_KD, V_BUCK_5V_OUT, PID_US);
+    compensator_init_pid(&bench_cntl, BUCK_KP, BUCK_KI, BUCK_KD, BUCK_KD_TF,
+                         PID_PERIOD_S, V_BUCK_5V_OUT, BUCK_DUTY_MIN, BUCK_DUTY_MAX);
+    mppt_init(&bench_mppt, MPPT_ONE_ID, MPPT_1_STRATEGY, MPPT_1_DELTA_DC, MPPT_1_DELTA_DC_MAX);
+    soc_init(&bench_soc, SOC_CAPACITY_AH);
+    battery_ir_init(&bench_ir, IR_R_NEW);
+
+    for(n = 0; n < iterations; n++) {
+        // output voltage within +/-1V of the setpoint, saturating now and then
+        float v = V_BUCK_5V_OUT + bench_uniform();
+        float duty = 50.0f + (60.0f * bench_uniform());
+        ctl_t v_ctl = CTL_FROM_F(v);
+
+        BENCH_MEASURE(BENCH_KERNEL(Bench_PID_Calculate), bench_sink = PID_calculate(&bench_pid, v));
+        BENCH_MEASURE(BENCH_KERNEL(Bench_Compensator_2P2Z), bench_sink = CTL_TO_F(compensator_run_2p2z(&bench_cntl, v_ctl)));
+        BENCH_MEASURE(BENCH_KERNEL(Bench_MPPT_Update_Values), mppt_update_values(&bench_mppt));
+
+        // any sign of delta_p, delta_v and delta_i, around a loaded panel
+        bench_mppt.v_result = CTL_FROM_F(15.0f + (5.0f * bench_uniform()));
+        bench_mppt.i_result = CTL_FROM_F(0.6f + (0.6f * bench_uniform()));
+        bench_mppt.delta_p = CTL_FROM_F(bench_uniform());
+        bench_mppt.delta_v = CTL_FROM_F(0.1f * bench_uniform());
+        bench_mppt.delta_i = CTL_FROM_F(0.05f * bench_uniform());
+        for(k = 0; k < Mppt_Strategy_Count; k++) {
+            // the same inputs for every strategy, from its freshly initialised state
+            mppt_set_strategy(&bench_mppt, (eMpptStrategy)k);
+            BENCH_MEASURE(&bench_results.mppt_strategy[k], bench_sink = mppt_calculate(&bench_mppt));
+        }
+
+        BENCH_MEASURE(BENCH_KERNEL(Bench_Update_Conversions), update_mppt_conversions());
+        BENCH_MEASURE(BENCH_KERNEL(Bench_Change_Duty_Cycle), change_pwm_duty_cycle(BENCH_DUTY_PWM, duty));
+
+        // a battery between empty and full, resting half the time
+        bench_soc.rest_ticks = CHARGE_TICKS(SOC_REST_S);
+        BENCH_MEASURE(BENCH_KERNEL(Bench_SOC_Update),
+                      soc_update(&bench_soc, CTL_FROM_F(7.2f + bench_uniform()),
+                                 CTL_FROM_F(0.2f * bench_uniform())));
+        v_batt = 7.4f + (0.1f * bench_uniform());
+        i_batt = 1.5f + (0.5f * bench_uniform());
+        BENCH_MEASURE(BENCH_KERNEL(Bench_Battery_IR_Update), battery_ir_update(&bench_ir, v_batt, i_batt));
+
+        // a panel's turn-on samples, an LSB of ripple over mid-scale means, and noise
+        for(k = 0; k < ADC_RIPPLE_BLOCK; k++) {
+            bench_v_block[k] = (uint16_t)(2049.0f + (2.0f * bench_uniform()));
+            bench_i_block[k] = (uint16_t)(2048.0f + (2.0f * bench_uniform()));
+        }
+        BENCH_MEASURE(BENCH_KERNEL(Bench_ADC_Ring_Correlate),
+                      adc_ring_correlate(&bench_ripple, bench_v_block, bench_i_block,
+                                         2048U << ADC_OVERSAMPLE_BITS, 2048U << ADC_OVERSAMPLE_BITS));
+    }
+    change_pwm_duty_cycle(BENCH_DUTY_PWM, 0.0f);
+    bench_results.done = 1;
+}
+
+#endif /* USE_KERNEL_BENCH */
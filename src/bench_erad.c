@@ -0,0 +1,50 @@
+/*
+ * bench_erad.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Target timing backend for bench.c: ERAD counter 1 counting CPU cycles.
+ *  The driverlib in this tree has no ERAD driver, so the registers from
+ *  inc/hw_erad.h are written directly.
+ */
+
+#include "bench.h"
+#include "inc/hw_types.h"
+#include "inc/hw_erad.h"
+
+#ifdef USE_KERNEL_BENCH
+
+#define BENCH_ERAD_COUNTER      ERAD_COUNTER1_BASE
+#define BENCH_ERAD_APPLICATION  1U      // GLBL_OWNER: application owns ERAD
+
+/**
+ * @brief Claims ERAD and starts counter 1 free-running on CPU cycles
+ *
+ * @details Counting mode (CTM_CNTL.EVENT_MODE = 0) counts every CPU cycle
+ *      while the counter is enabled. With the reference at its maximum the
+ *      count wraps modulo 2^32 like the subtraction in bench.c expects.
+ *      Fails silently if the debugger already owns ERAD.
+ */
+void bench_timer_init(void) {
+    EALLOW;
+    HWREGH(ERAD_GLOBAL_BASE + ERAD_O_GLBL_OWNER) = BENCH_ERAD_APPLICATION;
+
+    HWREGH(ERAD_GLOBAL_BASE + ERAD_O_GLBL_ENABLE) &= ~ERAD_GLBL_ENABLE_CTM1;
+    HWREGH(BENCH_ERAD_COUNTER + ERAD_O_CTM_CNTL) = 0U;
+    HWREGH(BENCH_ERAD_COUNTER + ERAD_O_CTM_INPUT_SEL) = 0U;
+    HWREG(BENCH_ERAD_COUNTER + ERAD_O_CTM_REF) = UINT32_MAX;
+    HWREGH(BENCH_ERAD_COUNTER + ERAD_O_CTM_CLEAR) = ERAD_CTM_CLEAR_EVENT_CLEAR | ERAD_CTM_CLEAR_OVERFLOW_CLEAR;
+    HWREGH(ERAD_GLOBAL_BASE + ERAD_O_GLBL_CTM_RESET) = ERAD_GLBL_CTM_RESET_CTM1;
+    HWREGH(ERAD_GLOBAL_BASE + ERAD_O_GLBL_ENABLE) |= ERAD_GLBL_ENABLE_CTM1;
+    EDIS;
+}
+
+uint32_t bench_timer_read(void) {
+    return HWREG(BENCH_ERAD_COUNTER + ERAD_O_CTM_COUNT);
+}
+
+uint32_t bench_timer_hz(void) {
+    return DEVICE_SYSCLK_FREQ;
+}
+
+#endif /* USE_KERNEL_BENCH */
@@ -0,0 +1,100 @@
+/*
+ * compensator.c
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "compensator.h"
+
+/**
+ * @brief Stores the reference and output limits, then resets to u_min
+ */
+static void compensator_set_limits(Compensator_t * cntl, float ref, float u_min, float u_max) {
+    cntl->ref = CTL_FROM_F(ref);
+    cntl->u_min = COMP_MAC(COMP_COEF(1.0f), CTL_FROM_F(u_min));
+    cntl->u_max = COMP_MAC(COMP_COEF(1.0f), CTL_FROM_F(u_max));
+    compensator_reset(cntl, CTL_FROM_F(u_min));
+}
+
+/**************************************************
+ * compensator_init_pid
+ *
+ * @brief Computes 2P2Z coefficients for a parallel PID
+ *
+ * @details Backward-Euler discretization of
+ *
+ *      C(s) = Kp + Ki / s + Kd s / (Tf s + 1)
+ *
+ *  giving poles at z = 1 (integrator) and z = Tf / (Tf + Ts) (derivative
+ *  filter). With Tf = 0 this is the same difference equation PID_calculate()
+ *  evaluates, without the divide.
+ *
+ * @param Kp Proportional gain [output / input]
+ * @param Ki Integral gain [output / (input * s)]
+ * @param Kd Derivative gain [output * s / input]
+ * @param Tf Derivative filter time constant [s], 0 for none
+ * @param Ts Sample period [s]
+ * @param ref Initial reference
+ * @param u_min Lower output limit
+ * @param u_max Upper output limit
+ *
+ **************************************************/
+void compensator_init_pid(Compensator_t * cntl, float Kp, float Ki, float Kd, float Tf,
+                          float Ts, float ref, float u_min, float u_max) {
+    float alpha = Tf / (Tf + Ts);
+    float ki = Ki * Ts;
+    float kd = Kd / (Tf + Ts);
+
+    cntl->b0 = COMP_COEF(Kp + ki + kd);
+    cntl->b1 = COMP_COEF(-(Kp * (1.0f + alpha)) - (ki * alpha) - (2.0f * kd));
+    cntl->b2 = COMP_COEF((Kp * alpha) + kd);
+    cntl->b3 = COMP_COEF(0.0f);
+    cntl->a1 = COMP_COEF(1.0f + alpha);
+    cntl->a2 = COMP_COEF(-alpha);
+    cntl->a3 = COMP_COEF(0.0f);
+
+    compensator_set_limits(cntl, ref, u_min, u_max);
+}
+
+/**************************************************
+ * compensator_init_3p3z
+ *
+ * @brief Loads coefficients for a general 3P3Z compensator
+ *
+ * @param b Numerator b0..b3
+ * @param a Denominator a1..a3 of 1 + a1 z^-1 + a2 z^-2 + a3 z^-3, as
+ *      written; they are negated when stored
+ *
+ **************************************************/
+void compensator_init_3p3z(Compensator_t * cntl, const float b[4], const float a[3],
+                           float ref, float u_min, float u_max) {
+    cntl->b0 = COMP_COEF(b[0]);
+    cntl->b1 = COMP_COEF(b[1]);
+    cntl->b2 = COMP_COEF(b[2]);
+    cntl->b3 = COMP_COEF(b[3]);
+    cntl->a1 = COMP_COEF(-a[0]);
+    cntl->a2 = COMP_COEF(-a[1]);
+    cntl->a3 = COMP_COEF(-a[2]);
+
+    compensator_set_limits(cntl, ref, u_min, u_max);
+}
+
+/**
+ * @brief Clears the error history and preloads the output history with u
+ *
+ * @details With zero error the next output is (a1 + a2 + a3) * u. For a
+ *      compensator with an integrator, a pole at z = 1, the a's sum to 1,
+ *      so the output holds at u, e.g. the duty cycle the converter is
+ *      already running at. Without one the preload only decays: a P-only
+ *      compensator (all a's 0) gives Kp * e from the next sample, a filtered
+ *      PD p * u decaying by p = Tf / (Tf + Ts) a sample towards Kp * e.
+ */
+void compensator_reset(Compensator_t * cntl, ctl_t u) {
+    cntl->s3 = COMP_MAC(cntl->a3, u);
+    cntl->s2 = COMP_MAC(cntl->a2, u) + cntl->s3;
+    cntl->s1 = COMP_MAC(cntl->a1, u) + cntl->s2;
+}
+
+void compensator_set_ref(Compensator_t * cntl, ctl_t ref) {
+    cntl->ref = ref;
+}
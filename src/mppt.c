@@ -13,6 +13,13 @@
 #include "src_adc.h"
 #include "src_epwm.h"
 
+#define MPPT_STRATEGY_PTR(id, strategy)     &strategy,
+
+/** Indexed by eMpptStrategy */
+const MpptStrategy_t * const mppt_strategies[Mppt_Strategy_Count] = {
+    MPPT_STRATEGIES(MPPT_STRATEGY_PTR)
+};
+
 /**************************************************
  * mppt_init
  *
@@ -22,42 +29,89 @@
  *
  * @param mppt_base EPWM base that this MPPT strcuture is associated with
  *
+ * @param strategy MPPT algorithm to run, see MPPT_STRATEGIES
+ *
  * @param delta_d How much to vary the duty cycle by to find the maximum power point
  *
  * @param delta_max How much to vary the duty cycle by if a maximum voltage or current reading is made
  *
  **************************************************/
-void mppt_init(MPPT_t * mppt, uint32_t mppt_base, float delta_d, float delta_max) {
-//    mppt->suspended = false;
+void mppt_init(MPPT_t * mppt, uint32_t mppt_base, eMpptStrategy strategy, float delta_d, float delta_max) {
+    mppt->mppt_base = mppt_base;
     mppt->delta_d = delta_d;
     mppt->delta_max = delta_max;
+    mppt->gains.ic = MPPT_IC_GAIN;
+    mppt->gains.rcc = MPPT_RCC_GAIN;
 
     mppt->v_result = 0;
     mppt->v_old = 0;
     mppt->i_result = 0;
     mppt->i_old = 0;
-//    mppt->power = 0;
+    mppt->power = 0;
     mppt->power_old = 0;
     mppt->delta_v = 0;
     mppt->delta_i = 0;
     mppt->delta_p = 0;
+    mppt->measurements = 0;
+
+    mppt_start_init(mppt, 0, false);
+    mppt_pace_init(mppt, false);
+    mppt_scan_init(mppt, 0, 0);
+    mppt_set_strategy(mppt, strategy);
+}
+
+/**************************************************
+ * mppt_set_strategy
+ *
+ * @brief Switches an MPPT instance to another algorithm
+ *
+ * @details Safe between two mppt_calculate() calls. The measurements are
+ *  kept, the new algorithm's state starts from its init(). An unknown
+ *  strategy leaves the current one running. The DMA ring correlates the
+ *  input's V/I pair only while its algorithm needs the ripple.
+ *
+ **************************************************/
+void mppt_set_strategy(MPPT_t * mppt, eMpptStrategy strategy) {
+    if(strategy >= Mppt_Strategy_Count) {
+        return;
+    }
+    mppt->strategy_id = strategy;
+    mppt->strategy = mppt_strategies[strategy];
+    set_mppt_ripple(mppt->mppt_base, mppt->strategy->ripple);
+    mppt->strategy->init(mppt);
 }
 
 
 /**************************************************
  * mppt_update_values
  *
+ * @brief Hands the associated MPPT converter's new measurements to
+ *      the selected algorithm
+ *
+ * @param mppt Instance of the MPPT structure
+ *
+ *************************************************/
+void mppt_update_values(MPPT_t * mppt) {
+    mppt->strategy->update(mppt);
+}
+
+/**************************************************
+ * mppt_measure
+ *
  * @brief Samples the associated MPPT converter's voltage and current
  *      and updates the corresponding values in the MPPT structure
  *
+ * @details The update() of the strategies that track on the change
+ *      since the last call.
+ *
  * @param mppt Instance of the MPPT structure
  *
  *************************************************/
-void mppt_update_values(MPPT_t * mppt) {
+void mppt_measure(MPPT_t * mppt) {
     // get updated values from ADC conversions
-    mppt->v_result = get_mppt_v(mppt->mppt_base);
-    mppt->i_result = get_mppt_i(mppt->mppt_base);
-    mppt->power = mppt->v_result * mppt->i_result;
+    mppt->v_result = get_mppt_v_ctl(mppt->mppt_base);
+    mppt->i_result = get_mppt_i_ctl(mppt->mppt_base);
+    mppt->power = CTL_MPY(mppt->v_result, mppt->i_result);
 
     // calculate delta values
     mppt->delta_v = mppt->v_result - mppt->v_old;
@@ -68,30 +122,40 @@ void mppt_update_values(MPPT_t * mppt) {
     mppt->v_old = mppt->v_result;
     mppt->i_old = mppt->i_result;
     mppt->power_old = mppt->power;
+    mppt->measurements++;
+}
+
+/**
+ * @brief True while a fast start or a global scan runs in place of the strategy
+ *
+ * @details A start waiting for a dark panel holds the converter off but
+ *  does not count, it has nothing to track.
+ */
+bool mppt_overridden(const MPPT_t * mppt) {
+    return (mppt->start.state == Mppt_Start_Open) || (mppt->start.state == Mppt_Start_Approach)
+           || (mppt->scan.state != Mppt_Scan_Idle);
 }
 
 /*************************************************
  * mppt_calculate
  *
- * @brief Implements an MPPT algorithm with CC/CV battery charging
+ * @brief Runs one step of the selected MPPT algorithm
  *
- * @details Combines the MPPT algorithm with the CC/CV battery charging algorithm
- *  to ensure than the battery voltage and current limits are not gone over. If the
- *  PV panel voltage is below the battery voltage, the converter will be disabled
+ * @details A fast start or a global scan in progress takes the place of the
+ *  algorithm, see mppt_start() and mppt_scan(). Otherwise mppt_pace() decides
+ *  whether the algorithm steps on this call. GPIO 25 shows the direction:
+ *  high while the duty cycle rises.
  *
  *  @return How much to change the duty cycle by
  *
  *************************************************/
 float mppt_calculate(MPPT_t * mppt) {
-    /** MPPT */
     float ret;
-    if((mppt->delta_p * mppt->delta_v) > 0) {
-        ret = -mppt->delta_d;
-        GPIO_writePin(25, 0);
-    }
-    else {
-        ret = mppt->delta_d;
-        GPIO_writePin(25, 1);
+
+    if((mppt_start(mppt, &ret) == false) && (mppt_scan(mppt, &ret) == false)
+       && (mppt_pace(mppt, &ret) == false)) {
+        ret = mppt_pace_stepped(mppt, mppt->strategy->step(mppt));
     }
+    GPIO_writePin(25, (ret > 0.0f) ? 1 : 0);
     return ret;
 }
@@ -0,0 +1,250 @@
+/*
+ * mppt_dual.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Coordinates the trackers of the two PV inputs. Both converters charge the
+ *  same battery, so a step of one moves the battery voltage and current the
+ *  other converter works against. With both stepping in the same tick each
+ *  tracker reads part of the other's change in its own power and can step
+ *  the wrong way.
+ *
+ *  Interleaved, only one duty cycle changes per MPPT tick, taking turns. An
+ *  input's step is measured in the next tick, when the samples averaged since
+ *  it was applied hold no change of the other input, and the step that comes
+ *  out of it waits for the input's next turn. Each tracker steps every other
+ *  tick with one tick of latency. A fast start (src/mppt_start.c) or global
+ *  scan (src/mppt_scan.c) has the ticks to itself: its input measures and
+ *  steps every tick while the other holds its duty cycle, so they take as
+ *  long as without the coordinator and the two inputs' follow each other.
+ *
+ *  The charger's limits (src/battery.c) are on the sum of both inputs. The
+ *  step of the input whose turn it is can raise the duty cycle by no more
+ *  than the charger's limit loops allow, and has to lower it once over. The
+ *  inputs share the headroom, and still change one at a time.
+ *
+ *  With panel voltage loops (src/pv_loop.c) the steps move each input's
+ *  voltage reference instead of its duty cycle.
+ */
+
+#include <stddef.h>
+#include "driverlib.h"
+
+#include "config.h"
+#include "mppt_dual.h"
+#include "src_epwm.h"
+
+/** Indexed by eMpptDualMode */
+const char * const mppt_dual_mode_names[Mppt_Dual_Mode_Count] = {
+    "independent",
+    "interleaved"
+};
+
+
+/**************************************************
+ * mppt_dual_init
+ *
+ * @brief Pairs the trackers of the two PV inputs
+ *
+ * @param one, two Trackers set up with mppt_init()
+ *
+ * @param pwm_one, pwm_two ePWM of each input's converter
+ *
+ * @param mode How the trackers share the MPPT ticks
+ *
+ **************************************************/
+void mppt_dual_init(MpptDual_t * dual, MPPT_t * one, uint32_t pwm_one,
+                    MPPT_t * two, uint32_t pwm_two, eMpptDualMode mode) {
+    dual->mppt[0] = one;
+    dual->mppt[1] = two;
+    dual->pwm_base[0] = pwm_one;
+    dual->pwm_base[1] = pwm_two;
+    dual->loop[0] = NULL;
+    dual->loop[1] = NULL;
+    dual->limit_steps = 0;
+    mppt_dual_set_mode(dual, mode);
+}
+
+/**************************************************
+ * mppt_dual_set_mode
+ *
+ * @brief Switches between independent and interleaved trackers
+ *
+ * @details Safe between two mppt_dual_step() calls. Pending steps are
+ *  dropped, an unknown mode leaves the current one running.
+ *
+ **************************************************/
+void mppt_dual_set_mode(MpptDual_t * dual, eMpptDualMode mode) {
+    if(mode >= Mppt_Dual_Mode_Count) {
+        return;
+    }
+    dual->mode = mode;
+    dual->turn = 0;
+    dual->pending[0] = 0.0f;
+    dual->pending[1] = 0.0f;
+}
+
+/**************************************************
+ * mppt_dual_set_loops
+ *
+ * @brief Has the trackers move each input's panel voltage reference
+ *
+ * @details A step of a tracker becomes a step of the reference,
+ *  PV_LOOP_V_PER_DUTY volts per % of duty cycle, lower for a rise. A fast
+ *  start, a global scan and a battery that is not charging move the duty
+ *  cycle directly and release the input's loop.
+ *
+ * @param one, two Loops set up with pv_loop_init(), NULL for none
+ *
+ **************************************************/
+void mppt_dual_set_loops(MpptDual_t * dual, PvLoop_t * one, PvLoop_t * two) {
+    dual->loop[0] = one;
+    dual->loop[1] = two;
+}
+
+/**
+ * @brief Largest change in one input's duty cycle the charger allows [%]
+ *
+ * @details charger.headroom, from the charger's current and voltage limit
+ *  loops, negative over a limit. Both inputs share it when they step in the
+ *  same tick. Below a duty cycle of V_battery / V_panel the buck does not
+ *  conduct and the battery current cannot change, so the headroom counts
+ *  from there.
+ */
+static float dual_headroom(const MpptDual_t * dual, const Battery_t * battery, uint32_t n) {
+    float v_panel = CTL_TO_F(dual->mppt[n]->v_result);
+    float headroom = battery->charger.headroom;
+    float edge;
+
+    if(dual->mode == Mppt_Dual_Independent) {
+        headroom /= (float)MPPT_DUAL_INPUTS;
+    }
+    if(v_panel > battery->voltage) {
+        edge = (100.0f * battery->voltage) / v_panel;
+        edge -= get_duty_cycle(dual->pwm_base[n]);
+        headroom += (edge > 0.0f) ? edge : 0.0f;
+    }
+    return headroom;
+}
+
+/**
+ * @brief True while an input's loop may track the panel voltage reference
+ */
+static bool dual_loop_tracks(const MpptDual_t * dual, uint32_t n) {
+    // a start waiting on a dark panel holds the converter off, there is no voltage to hold
+    return (dual->loop[n] != NULL) && (dual->loop[n]->enabled == true)
+           && (mppt_overridden(dual->mppt[n]) == false) && (dual->mppt[n]->start.state == Mppt_Start_Done);
+}
+
+static void dual_release(const MpptDual_t * dual, uint32_t n) {
+    if(dual->loop[n] != NULL) {
+        pv_loop_release(dual->loop[n]);
+    }
+}
+
+static void dual_apply(const MpptDual_t * dual, uint32_t n, float delta) {
+    if(dual_loop_tracks(dual, n) == true) {
+        if(dual->loop[n]->engaged == false) {
+            pv_loop_engage(dual->loop[n], dual->mppt[n]->v_result);
+        }
+        pv_loop_move_ref(dual->loop[n], -delta * PV_LOOP_V_PER_DUTY);
+        return;
+    }
+    dual_release(dual, n);
+    change_pwm_duty_cycle(dual->pwm_base[n], (get_duty_cycle(dual->pwm_base[n]) + delta));
+}
+
+static void dual_apply_limited(MpptDual_t * dual, const Battery_t * battery, uint32_t n, float delta) {
+    float headroom = dual_headroom(dual, battery, n);
+
+    if(delta > headroom) {
+        dual->limit_steps++;
+        delta = headroom;
+    }
+    dual_apply(dual, n, delta);
+}
+
+/**
+ * @brief Both trackers step every tick, sharing the charger's headroom
+ */
+static void dual_step_independent(MpptDual_t * dual, const Battery_t * battery, bool apply) {
+    uint32_t n;
+
+    for(n = 0; n < MPPT_DUAL_INPUTS; n++) {
+        mppt_update_values(dual->mppt[n]);
+        dual->pending[n] = mppt_calculate(dual->mppt[n]);
+    }
+    if(apply == false) {
+        return;
+    }
+    for(n = 0; n < MPPT_DUAL_INPUTS; n++) {
+        dual_apply_limited(dual, battery, n, dual->pending[n]);
+    }
+}
+
+/**
+ * @brief The input that stepped last tick measures, the other steps
+ */
+static void dual_step_interleaved(MpptDual_t * dual, const Battery_t * battery, bool apply) {
+    uint32_t turn = dual->turn;
+    uint32_t observe = turn ^ 1U;
+    float delta;
+
+    // a start or scan begins in its input's observe tick, so it is that input's turn next
+    if(mppt_overridden(dual->mppt[turn]) == true) {
+        dual->pending[observe] = 0.0f;
+        mppt_update_values(dual->mppt[turn]);
+        delta = mppt_calculate(dual->mppt[turn]);
+        if(mppt_overridden(dual->mppt[turn]) == false) {
+            // done, the last step waits for the input's turn like the strategy's
+            dual->pending[turn] = delta;
+        }
+        else if(apply == true) {
+            dual_apply_limited(dual, battery, turn, delta);
+        }
+        return;
+    }
+
+    delta = dual->pending[turn];
+    mppt_update_values(dual->mppt[observe]);
+    dual->pending[observe] = mppt_calculate(dual->mppt[observe]);
+    if(apply == true) {
+        dual_apply_limited(dual, battery, turn, delta);
+    }
+    dual->pending[turn] = 0.0f;
+    dual->turn = observe;
+}
+
+/*************************************************
+ * mppt_dual_step
+ *
+ * @brief Runs both PV inputs' trackers for one MPPT tick
+ *
+ * @details Takes the place of mppt_update_values(), mppt_calculate() and the
+ *  duty cycle writes of each input. The trackers always run, the duty cycles
+ *  or panel voltage references only follow them while charger_regulates():
+ *  in precharge, CC, CV or float. A full battery, or a charge fault, turns
+ *  both converters off.
+ *
+ * @param battery Updated with update_battery() in the same tick
+ *
+ *************************************************/
+void mppt_dual_step(MpptDual_t * dual, const Battery_t * battery) {
+    bool apply = charger_regulates(&battery->charger);
+
+    if(dual->mode == Mppt_Dual_Interleaved) {
+        dual_step_interleaved(dual, battery, apply);
+    }
+    else {
+        dual_step_independent(dual, battery, apply);
+    }
+
+    if(apply == false) {
+        dual_release(dual, 0);
+        dual_release(dual, 1);
+    }
+    if((battery->charger.cc_cv == Battery_Full) || (battery->charger.cc_cv == Charge_Fault)) {
+        change_pwm_duty_cycle(dual->pwm_base[0], 0);
+        change_pwm_duty_cycle(dual->pwm_base[1], 0);
+    }
+}
@@ -0,0 +1,76 @@
+/*
+ * mppt_ic.c
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "mppt.h"
+
+
+static void ic_init(MPPT_t * mppt) {
+    mppt->state.inc_cond.step = mppt->delta_d;
+}
+
+/*************************************************
+ * ic_step
+ *
+ * @brief Incremental conductance with a variable step
+ *
+ * @details dP/dV = I + V * dI/dV is positive left of the maximum power point,
+ *  where dI/dV > -I/V, and negative right of it. Raising the duty cycle draws
+ *  more current and lowers the panel voltage, so the step is against the sign
+ *  of dP/dV and gains.ic * |dP/dV| big: large far from the maximum power
+ *  point, MPPT_IC_STEP_MIN on it, never more than delta_max.
+ *
+ *  A change in panel voltage under MPPT_IC_DV_MIN is too small to divide by.
+ *  The current then tells if the irradiance moved, and the MPP voltage with
+ *  it, which is answered with delta_d; otherwise the last direction is kept
+ *  at the minimum step so the next reading has a voltage change again. Until
+ *  the converter draws MPPT_IC_I_MIN from the panel there is nothing to
+ *  track, and the duty cycle rises by delta_max.
+ *
+ *  @return How much to change the duty cycle by
+ *
+ *************************************************/
+static float ic_step(MPPT_t * mppt) {
+    MpptIncCond_t * ic = &mppt->state.inc_cond;
+    float step;
+
+    if(mppt->i_result < CTL(MPPT_IC_I_MIN)) {
+        step = mppt->delta_max;
+    }
+    else if((mppt->delta_v < CTL(MPPT_IC_DV_MIN)) && (mppt->delta_v > CTL(-MPPT_IC_DV_MIN))) {
+        if(mppt->delta_i > CTL(MPPT_IC_DI_MIN)) {
+            step = -mppt->delta_d;
+        }
+        else if(mppt->delta_i < CTL(-MPPT_IC_DI_MIN)) {
+            step = mppt->delta_d;
+        }
+        else {
+            step = (ic->step > 0.0f) ? MPPT_IC_STEP_MIN : -MPPT_IC_STEP_MIN;
+        }
+    }
+    else {
+        // (I*dV + V*dI) / dV, one divide that saturates instead of I/V and dI/dV
+        ctl_t dp_dv = CTL_DIV(CTL_MPY(mppt->i_result, mppt->delta_v) + CTL_MPY(mppt->v_result, mppt->delta_i),
+                              mppt->delta_v);
+        float magnitude = mppt->gains.ic * CTL_TO_F(dp_dv);
+
+        magnitude = (magnitude < 0.0f) ? -magnitude : magnitude;
+        magnitude = (magnitude < MPPT_IC_STEP_MIN) ? MPPT_IC_STEP_MIN : magnitude;
+        magnitude = (magnitude > mppt->delta_max) ? mppt->delta_max : magnitude;
+        step = (dp_dv > 0) ? -magnitude : magnitude;
+    }
+
+    ic->step = step;
+    return step;
+}
+
+const MpptStrategy_t mppt_inc_cond = {
+    .name = "ic",
+    .paced = true,
+    .ripple = false,
+    .init = ic_init,
+    .update = mppt_measure,
+    .step = ic_step
+};
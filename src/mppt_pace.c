@@ -0,0 +1,223 @@
+/*
+ * mppt_pace.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Settling-aware step rate with a steady-state hold. A change in duty cycle
+ *  rings the buck's input filter for a couple of milliseconds, longer than
+ *  an MPPT step, so a strategy stepping on every tick judges some steps on a
+ *  panel voltage that is still moving. The DMA block average hides how far
+ *  the voltage moved within the block, adc_ring_drift() does not: until the
+ *  drift falls under MPPT_PACE_SETTLE_DV the strategy does not step, and
+ *  the step is then judged against the measurements from before it, however
+ *  many ticks later that is.
+ *
+ *  At the maximum power point a hill-climbing strategy keeps stepping
+ *  across it and loses a little power on every step away. When a window of
+ *  MPPT_PACE_WINDOW steps changes direction MPPT_PACE_REVERSALS times with
+ *  no net travel and no change in power, the steps stop for a hold of
+ *  MPPT_PACE_HOLD_MIN steps, doubled up to MPPT_PACE_HOLD_MAX each time the
+ *  tracker comes straight back to the hold. A change in power of
+ *  MPPT_PACE_RESUME of the held power, as a change in irradiance gives,
+ *  ends the hold early. The hold ends on a tick without a step that takes a
+ *  fresh reference; judged across the hold, a rise in irradiance would look
+ *  like the strategy's doing and send perturb and observe the wrong way.
+ *
+ *  A fast start and a global scan run ahead of the pace, mppt_calculate()
+ *  does not call it while they do. Strategies that are not paced, such as
+ *  ripple correlation, whose gradient does not wait for the panel to
+ *  settle, step on every call.
+ */
+
+#include "driverlib.h"
+
+#include "mppt.h"
+#include "src_adc.h"
+
+#define MPPT_PACE_NONE      UINT32_MAX  // pace.seen before the first call
+
+
+/**
+ * @brief Sets up the step rate of an MPPT instance
+ *
+ * @param enabled false to step on every call, as without the pace
+ */
+void mppt_pace_init(MPPT_t * mppt, bool enabled) {
+    MpptPace_t * pace = &mppt->pace;
+
+    pace->enabled = enabled;
+    pace->state = Mppt_Pace_Track;
+    pace->seen = MPPT_PACE_NONE;
+    pace->v_ref = 0;
+    pace->i_ref = 0;
+    pace->p_ref = 0;
+    pace->wait = 0;
+    pace->last_step = 0.0f;
+    pace->window = 0;
+    pace->reversals = 0;
+    pace->travel = 0.0f;
+    pace->step_max = 0.0f;
+    pace->p_window = 0;
+    pace->p_hold = 0;
+    pace->hold = 0;
+    pace->interval = MPPT_PACE_HOLD_MIN;
+    pace->steps = 0;
+    pace->waits = 0;
+    pace->timeouts = 0;
+    pace->holds = 0;
+    pace->resumes = 0;
+    pace->held = 0;
+}
+
+/**
+ * @brief Starts a new window of strategy steps at the latest measurements
+ */
+static void pace_window_reset(MpptPace_t * pace, const MPPT_t * mppt) {
+    pace->window = 0;
+    pace->reversals = 0;
+    pace->travel = 0.0f;
+    pace->step_max = 0.0f;
+    pace->p_window = mppt->power;
+}
+
+/**
+ * @brief True if the power moved MPPT_PACE_RESUME away from p, as a change in irradiance moves it
+ */
+static bool pace_power_moved(const MPPT_t * mppt, ctl_t p) {
+    ctl_t dp = mppt->power - p;
+
+    dp = (dp < 0) ? -dp : dp;
+    return (dp > CTL_MPY(p, CTL(MPPT_PACE_RESUME))) && (dp > CTL(MPPT_PACE_RESUME_MIN));
+}
+
+/**
+ * @brief The strategy's next step is judged against the latest measurements
+ */
+static void pace_reference(MpptPace_t * pace, const MPPT_t * mppt) {
+    pace->v_ref = mppt->v_result;
+    pace->i_ref = mppt->i_result;
+    pace->p_ref = mppt->power;
+}
+
+/**************************************************
+ * mppt_pace
+ *
+ * @brief Decides whether the strategy steps on this MPPT tick
+ *
+ * @details Call after the strategy's update(). While the pace holds or
+ *  waits for the panel to settle, no step is taken. When the strategy is to
+ *  step, delta_v, delta_i and delta_p are replaced by the changes since its
+ *  last step, so that a step is judged on everything it changed. Pass the
+ *  step through mppt_pace_stepped().
+ *
+ * @param delta Receives 0 while the strategy does not step
+ *
+ * @return true while the strategy does not step
+ *
+ **************************************************/
+bool mppt_pace(MPPT_t * mppt, float * delta) {
+    MpptPace_t * pace = &mppt->pace;
+    ctl_t drift;
+
+    if((pace->enabled == false) || (mppt->strategy->paced == false)) {
+        return false;
+    }
+
+    if((mppt->measurements - pace->seen) != 1U) {
+        // a start or a scan moved the duty cycle, the strategy starts over from there
+        pace->seen = mppt->measurements;
+        pace->state = Mppt_Pace_Track;
+        pace->wait = 0;
+        pace->last_step = 0.0f;
+        pace_window_reset(pace, mppt);
+        pace_reference(pace, mppt);
+        return false;
+    }
+    pace->seen = mppt->measurements;
+
+    if(pace->state == Mppt_Pace_Hold) {
+        pace->held++;
+        if(pace_power_moved(mppt, pace->p_hold) == true) {
+            pace->resumes++;
+            pace->interval = MPPT_PACE_HOLD_MIN;
+        }
+        else if(--pace->hold > 0U) {
+            *delta = 0.0f;
+            return true;
+        }
+        // what changed during the hold was not the strategy's doing, its next step starts afresh
+        pace->state = Mppt_Pace_Track;
+        pace->last_step = 0.0f;
+        pace_window_reset(pace, mppt);
+        pace_reference(pace, mppt);
+        *delta = 0.0f;
+        return true;
+    }
+
+    drift = get_mppt_v_drift_ctl(mppt->mppt_base);
+    if(drift > CTL(MPPT_PACE_SETTLE_DV)) {
+        if(pace->wait < MPPT_PACE_SETTLE_MAX) {
+            pace->wait++;
+            pace->waits++;
+            *delta = 0.0f;
+            return true;
+        }
+        pace->timeouts++;
+    }
+    pace->wait = 0;
+
+    mppt->delta_v = mppt->v_result - pace->v_ref;
+    mppt->delta_i = mppt->i_result - pace->i_ref;
+    mppt->delta_p = mppt->power - pace->p_ref;
+    pace_reference(pace, mppt);
+    return false;
+}
+
+/**************************************************
+ * mppt_pace_stepped
+ *
+ * @brief Looks for an oscillation about the MPP in the strategy's steps
+ *
+ * @param step Change in duty cycle the strategy returned
+ *
+ * @return The step, 0 when a hold starts
+ *
+ **************************************************/
+float mppt_pace_stepped(MPPT_t * mppt, float step) {
+    MpptPace_t * pace = &mppt->pace;
+    float magnitude = (step < 0.0f) ? -step : step;
+    bool oscillating;
+
+    if((pace->enabled == false) || (mppt->strategy->paced == false)) {
+        return step;
+    }
+
+    pace->steps++;
+    if(((step > 0.0f) && (pace->last_step < 0.0f)) || ((step < 0.0f) && (pace->last_step > 0.0f))) {
+        pace->reversals++;
+    }
+    pace->last_step = step;
+    pace->travel += step;
+    pace->step_max = (magnitude > pace->step_max) ? magnitude : pace->step_max;
+    if(++pace->window < MPPT_PACE_WINDOW) {
+        return step;
+    }
+
+    // on a ramp the tracker turns around too, but the power keeps moving
+    oscillating = (pace->reversals >= MPPT_PACE_REVERSALS)
+                  && (pace->travel <= pace->step_max) && (-pace->travel <= pace->step_max)
+                  && (pace_power_moved(mppt, pace->p_window) == false);
+    pace_window_reset(pace, mppt);
+    if(oscillating == false) {
+        // tracking somewhere, the next hold starts short
+        pace->interval = MPPT_PACE_HOLD_MIN;
+        return step;
+    }
+
+    pace->state = Mppt_Pace_Hold;
+    pace->hold = pace->interval;
+    pace->p_hold = mppt->power;
+    pace->holds++;
+    pace->interval = ((2U * pace->interval) < MPPT_PACE_HOLD_MAX) ? (2U * pace->interval) : MPPT_PACE_HOLD_MAX;
+    return 0.0f;
+}
@@ -0,0 +1,45 @@
+/*
+ * mppt_po.c
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "mppt.h"
+
+
+static void po_init(MPPT_t * mppt) {
+}
+
+/*************************************************
+ * po_step
+ *
+ * @brief Fixed step perturb and observe
+ *
+ * @details Keeps stepping the duty cycle by delta_d in whichever direction
+ *  last raised the power, so it never settles and takes the same small steps
+ *  however far from the maximum power point it is. Until the converter draws
+ *  MPPT_PO_I_MIN from the panel the power changes are noise, and the duty
+ *  cycle rises by delta_d.
+ *
+ *  @return How much to change the duty cycle by
+ *
+ *************************************************/
+static float po_step(MPPT_t * mppt) {
+    if(mppt->i_result < CTL(MPPT_PO_I_MIN)) {
+        return mppt->delta_d;
+    }
+    // sign of delta_p * delta_v, without the product underflowing in Q24
+    if(((mppt->delta_p > 0) && (mppt->delta_v > 0)) || ((mppt->delta_p < 0) && (mppt->delta_v < 0))) {
+        return -mppt->delta_d;
+    }
+    return mppt->delta_d;
+}
+
+const MpptStrategy_t mppt_perturb_observe = {
+    .name = "po",
+    .paced = true,
+    .ripple = false,
+    .init = po_init,
+    .update = mppt_measure,
+    .step = po_step
+};
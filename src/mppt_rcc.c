@@ -0,0 +1,92 @@
+/*
+ * mppt_rcc.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Ripple correlation control. The converter's own switching is the
+ *  perturbation: the input capacitor discharges through every on-time and
+ *  recharges through the off-time, so the panel voltage ripples about its
+ *  mean, and the panel current with it along the I-V curve. With v~ and p~
+ *  the ripple of the panel voltage and power, the sign of v~ * p~ is the
+ *  side of the maximum power point the panel is on, and
+ *      p~ = V * i~ + I * v~
+ *  to first order, so no product of samples is needed.
+ *
+ *  The DMA ring samples each input's V/I pair at the converter's turn-on,
+ *  where the ripple peaks, every ADC_RIPPLE_PRESCALE switching periods, and
+ *  takes the pair's mid on-time block mean off each sample (the high-pass
+ *  filter). The turn-on samples are all at the same point of the period,
+ *  so summing them is the multiply-accumulate against the switching, and
+ *  the correlation of a block is p~ = I * v~ + V * i~, dP/dV times the
+ *  voltage ripple at turn-on.
+ *
+ *  The ripple is under an LSB of either channel, so a block's p~ is mostly
+ *  ADC noise and is never divided by the block's own v~: the duty cycle
+ *  integrates p~ itself, gains.rcc per W/V of p~ over MPPT_RCC_V_RIPPLE, on
+ *  every MPPT step. The integrator is the averaging: far from the maximum
+ *  power point it walks in large steps, on it the noise cancels out. The
+ *  steps shrink with the irradiance, as the ripple does. The integration is
+ *  sampled at the MPPT step because mppt_dual_step() holds the charger's
+ *  limits on the duty cycle there; the correlation covers the switching
+ *  periods in between. The strategy is not paced and does not dither: the
+ *  ripple is there whether or not the panel has settled.
+ */
+
+#include "mppt.h"
+#include "src_adc.h"
+
+
+static void rcc_init(MPPT_t * mppt) {
+    MpptRcc_t * rcc = &mppt->state.rcc;
+
+    rcc->p_ripple = 0;
+    rcc->blocks = 0;
+}
+
+/**
+ * @brief Measures, and correlates the last block's turn-on ripple
+ */
+static void rcc_update(MPPT_t * mppt) {
+    MpptRcc_t * rcc = &mppt->state.rcc;
+
+    mppt_measure(mppt);
+    rcc->p_ripple = CTL_MPY(mppt->i_result, get_mppt_ripple_v_ctl(mppt->mppt_base))
+                    + CTL_MPY(mppt->v_result, get_mppt_ripple_i_ctl(mppt->mppt_base));
+    if(mppt->i_result >= CTL(MPPT_RCC_I_MIN)) {
+        rcc->blocks++;
+    }
+}
+
+/*************************************************
+ * rcc_step
+ *
+ * @brief Integrates the ripple correlation into the duty cycle
+ *
+ * @details Raising the duty cycle lowers the panel voltage, so the step is
+ *  against the sign of the correlation, never more than delta_max. Until
+ *  the converter draws MPPT_RCC_I_MIN from the panel there is no ripple to
+ *  correlate, and the duty cycle rises by delta_max.
+ *
+ *  @return How much to change the duty cycle by
+ *
+ *************************************************/
+static float rcc_step(MPPT_t * mppt) {
+    float step;
+
+    if(mppt->i_result < CTL(MPPT_RCC_I_MIN)) {
+        return mppt->delta_max;
+    }
+    step = -mppt->gains.rcc * (CTL_TO_F(mppt->state.rcc.p_ripple) / MPPT_RCC_V_RIPPLE);
+    step = (step > mppt->delta_max) ? mppt->delta_max : step;
+    step = (step < -mppt->delta_max) ? -mppt->delta_max : step;
+    return step;
+}
+
+const MpptStrategy_t mppt_ripple_corr = {
+    .name = "rcc",
+    .paced = false,
+    .ripple = true,
+    .init = rcc_init,
+    .update = rcc_update,
+    .step = rcc_step
+};
@@ -0,0 +1,179 @@
+/*
+ * mppt_scan.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Global maximum power point scan. Under partial shading a panel's P-V
+ *  curve has a local maximum for each group of bypassed cells, and a hill
+ *  climbing strategy stays on whichever it reached first. Every interval
+ *  MPPT steps the scan takes over mppt_calculate(): it slews to one end of
+ *  MPPT_SCAN_DUTY_MIN..MPPT_SCAN_DUTY_MAX, sweeps MPPT_SCAN_POINTS duty
+ *  cycles into scan.power, and slews to the best of them if it beats the
+ *  power the tracker had, or back to where it was. The strategy then
+ *  restarts from its init() and fine tracks the peak.
+ *
+ *  A scan lasts about MPPT_SCAN_POINTS * MPPT_SCAN_SETTLE MPPT steps plus
+ *  the slews, all off the maximum power point, so the interval trades the
+ *  time to find a new global peak against the energy spent looking.
+ */
+
+#include "driverlib.h"
+
+#include "mppt.h"
+#include "src_adc.h"
+#include "src_epwm.h"
+
+#define MPPT_SCAN_ARRIVED       0.001f  // [% duty]
+#define MPPT_SCAN_STEP          ((MPPT_SCAN_DUTY_MAX - MPPT_SCAN_DUTY_MIN) / (float)(MPPT_SCAN_POINTS - 1U))
+// a full-range slew and the settling, with a margin; CC/CV can hold the duty cycle back
+#define MPPT_SCAN_MAX_STEPS     ((uint32_t)(MPPT_SCAN_DUTY_MAX / MPPT_SCAN_SLEW) + MPPT_SCAN_SETTLE + 2U)
+
+
+/**
+ * @brief Duty cycle of a point on the coarse P-V curve [%]
+ */
+float mppt_scan_duty(uint32_t point) {
+    return MPPT_SCAN_DUTY_MIN + (MPPT_SCAN_STEP * (float)point);
+}
+
+/**
+ * @brief Sets up the global scan of an MPPT instance
+ *
+ * @param pwm_base ePWM of the converter, the scan moves its duty cycle directly
+ *
+ * @param interval MPPT steps between scans, 0 for none
+ */
+void mppt_scan_init(MPPT_t * mppt, uint32_t pwm_base, uint32_t interval) {
+    MpptScan_t * scan = &mppt->scan;
+    uint32_t n;
+
+    for(n = 0; n < MPPT_SCAN_POINTS; n++) {
+        scan->power[n] = 0;
+    }
+    scan->pwm_base = pwm_base;
+    scan->interval = interval;
+    scan->countdown = interval;
+    scan->state = Mppt_Scan_Idle;
+    scan->point = 0;
+    scan->settle = 0;
+    scan->descending = false;
+    scan->target = 0.0f;
+    scan->start_duty = 0.0f;
+    scan->start_power = 0;
+    scan->steps = 0;
+    scan->scans = 0;
+    scan->jumps = 0;
+    scan->aborts = 0;
+}
+
+static void scan_finish(MPPT_t * mppt) {
+    mppt->scan.state = Mppt_Scan_Idle;
+    mppt->scan.countdown = mppt->scan.interval;
+    mppt->strategy->init(mppt);
+}
+
+static ctl_t scan_power(const MPPT_t * mppt) {
+    return CTL_MPY(get_mppt_v_ctl(mppt->mppt_base), get_mppt_i_ctl(mppt->mppt_base));
+}
+
+static uint32_t scan_point(const MpptScan_t * scan) {
+    return scan->descending ? (MPPT_SCAN_POINTS - 1U - scan->point) : scan->point;
+}
+
+/**
+ * @brief Records the current point and picks the next, or the peak
+ */
+static void scan_record(MPPT_t * mppt) {
+    MpptScan_t * scan = &mppt->scan;
+    uint32_t best = 0;
+    uint32_t n;
+
+    scan->power[scan_point(scan)] = scan_power(mppt);
+    scan->point++;
+    scan->settle = 0;
+    scan->steps = 0;
+    if(scan->point < MPPT_SCAN_POINTS) {
+        scan->target = mppt_scan_duty(scan_point(scan));
+        return;
+    }
+
+    for(n = 1; n < MPPT_SCAN_POINTS; n++) {
+        best = (scan->power[n] > scan->power[best]) ? n : best;
+    }
+    if(scan->power[best] > scan->start_power) {
+        scan->target = mppt_scan_duty(best);
+        scan->jumps++;
+    }
+    else {
+        scan->target = scan->start_duty;
+    }
+    scan->state = Mppt_Scan_Return;
+}
+
+/**************************************************
+ * mppt_scan
+ *
+ * @brief Runs the global scan in place of the MPPT strategy when one is due
+ *
+ * @details The duty cycle moves at most MPPT_SCAN_SLEW per step. A point is
+ *  measured MPPT_SCAN_SETTLE steps after the duty cycle reached it, so the
+ *  averaged samples do not include the transient. If the CC/CV limits in
+ *  the main loop keep the duty cycle from a point for MPPT_SCAN_MAX_STEPS
+ *  the scan gives up and the strategy carries on from there.
+ *
+ * @param delta Receives the change in duty cycle while the scan runs
+ *
+ * @return true while the scan is running
+ *
+ **************************************************/
+bool mppt_scan(MPPT_t * mppt, float * delta) {
+    MpptScan_t * scan = &mppt->scan;
+    float duty;
+
+    if(scan->interval == 0) {
+        return false;
+    }
+
+    duty = get_duty_cycle(scan->pwm_base);
+    if(scan->state == Mppt_Scan_Idle) {
+        if(--scan->countdown != 0) {
+            return false;
+        }
+        // start from the end nearer the tracker
+        scan->start_duty = duty;
+        scan->start_power = scan_power(mppt);
+        scan->descending = (duty > (0.5f * (MPPT_SCAN_DUTY_MIN + MPPT_SCAN_DUTY_MAX)));
+        scan->point = 0;
+        scan->settle = 0;
+        scan->steps = 0;
+        scan->target = mppt_scan_duty(scan_point(scan));
+        scan->state = Mppt_Scan_Approach;
+    }
+    else if(++scan->steps > MPPT_SCAN_MAX_STEPS) {
+        scan->aborts++;
+        scan_finish(mppt);
+        return false;
+    }
+    else if(((scan->target - duty) < MPPT_SCAN_ARRIVED) && ((duty - scan->target) < MPPT_SCAN_ARRIVED)) {
+        switch(scan->state) {
+        case(Mppt_Scan_Approach):
+            scan->state = Mppt_Scan_Sweep;
+            /* fall through */
+        case(Mppt_Scan_Sweep):
+            if(++scan->settle >= MPPT_SCAN_SETTLE) {
+                scan_record(mppt);
+            }
+            break;
+        case(Mppt_Scan_Return):
+        default:
+            scan->scans++;
+            scan_finish(mppt);
+            return false;
+        }
+    }
+
+    *delta = scan->target - duty;
+    *delta = (*delta > MPPT_SCAN_SLEW) ? MPPT_SCAN_SLEW : *delta;
+    *delta = (*delta < -MPPT_SCAN_SLEW) ? -MPPT_SCAN_SLEW : *delta;
+    return true;
+}
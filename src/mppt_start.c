@@ -0,0 +1,147 @@
+/*
+ * mppt_start.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Fast start from an open-circuit voltage snapshot. At power-up, and when
+ *  the panel comes back after a night or a deep shade, a tracker would
+ *  otherwise climb from 0% duty cycle in its own small steps. Instead the
+ *  converter is held off for MPPT_START_SETTLE MPPT steps so the panel
+ *  sits at its open-circuit voltage, and the averaged panel voltage of the
+ *  last step is taken as Voc. The maximum power point is close to
+ *  MPPT_START_K_VOC * Voc, and a buck in continuous conduction has
+ *  V_battery = D * V_panel, so the start moves the duty cycle to
+ *      D = V_battery / (MPPT_START_K_VOC * Voc)
+ *  and the strategy fine tracks from there.
+ *
+ *  A panel that does not reach MPPT_START_V_MARGIN above the battery cannot
+ *  charge it, and the start waits with the converter off. A dark panel can
+ *  leave the input capacitor charged well above the battery, so a start
+ *  that arrives without panel current waits too; each approach drains the
+ *  capacitor to the conduction edge until the reading falls under the
+ *  margin. Settling and approaching have the MPPT ticks to themselves
+ *  (src/mppt_dual.c), waiting all night does not. Once the panel current
+ *  has stayed under MPPT_START_I_DARK for MPPT_START_DARK_STEPS the next
+ *  start is due.
+ */
+
+#include "driverlib.h"
+
+#include "mppt.h"
+#include "src_adc.h"
+#include "src_epwm.h"
+
+#define MPPT_START_ARRIVED      0.001f  // [% duty]
+
+
+/**
+ * @brief Sets up the fast start of an MPPT instance
+ *
+ * @param pwm_base ePWM of the converter, the start moves its duty cycle directly
+ *
+ * @param enabled false to leave the tracker to climb from where it is
+ */
+void mppt_start_init(MPPT_t * mppt, uint32_t pwm_base, bool enabled) {
+    MpptStart_t * start = &mppt->start;
+
+    start->pwm_base = pwm_base;
+    start->enabled = enabled;
+    start->state = enabled ? Mppt_Start_Open : Mppt_Start_Done;
+    // the converter has been off since power-up, the first reading is Voc
+    start->settle = MPPT_START_SETTLE;
+    start->dark = 0;
+    start->voc = 0;
+    start->duty = 0.0f;
+    start->steps = 0;
+    start->starts = 0;
+}
+
+/**
+ * @brief Operating point for the open-circuit voltage just read [%]
+ *
+ * @return 0 while the panel cannot charge the battery
+ */
+static float start_duty(const MpptStart_t * start) {
+    float v_mpp = MPPT_START_K_VOC * CTL_TO_F(start->voc);
+    float v_battery = get_battery_v();
+
+    if(CTL_TO_F(start->voc) < (v_battery + MPPT_START_V_MARGIN)) {
+        return 0.0f;
+    }
+    v_mpp = 100.0f * (v_battery / v_mpp);
+    return (v_mpp > MPPT_SCAN_DUTY_MAX) ? MPPT_SCAN_DUTY_MAX : v_mpp;
+}
+
+/**************************************************
+ * mppt_start
+ *
+ * @brief Runs the fast start in place of the MPPT strategy when one is due
+ *
+ * @details Open: the converter is off for MPPT_START_SETTLE steps. Wait:
+ *  it stays off until the panel can charge the battery. Approach: the duty
+ *  cycle moves to the operating point, in one step unless the CC/CV limits
+ *  hold it back, which ends the start after MPPT_START_APPROACH_STEPS.
+ *  Without panel current at the end it waits again.
+ *
+ * @param delta Receives the change in duty cycle while the start runs
+ *
+ * @return true while the start is running
+ *
+ **************************************************/
+bool mppt_start(MPPT_t * mppt, float * delta) {
+    MpptStart_t * start = &mppt->start;
+    float duty;
+
+    if(start->enabled == false) {
+        return false;
+    }
+
+    duty = get_duty_cycle(start->pwm_base);
+    switch(start->state) {
+    case(Mppt_Start_Done):
+    default:
+        start->dark = (mppt->i_result < CTL(MPPT_START_I_DARK)) ? (start->dark + 1U) : 0U;
+        if(start->dark < MPPT_START_DARK_STEPS) {
+            return false;
+        }
+        start->state = Mppt_Start_Open;
+        start->settle = 0;
+        /* fall through */
+    case(Mppt_Start_Open):
+        if(++start->settle < MPPT_START_SETTLE) {
+            *delta = -duty;
+            return true;
+        }
+        /* fall through */
+    case(Mppt_Start_Wait):
+        start->voc = mppt->v_result;
+        start->duty = start_duty(start);
+        if(start->duty == 0.0f) {
+            start->state = Mppt_Start_Wait;
+            *delta = -duty;
+            return true;
+        }
+        start->state = Mppt_Start_Approach;
+        start->steps = 0;
+        break;
+    case(Mppt_Start_Approach):
+        if((((start->duty - duty) < MPPT_START_ARRIVED) && ((duty - start->duty) < MPPT_START_ARRIVED))
+           || (++start->steps >= MPPT_START_APPROACH_STEPS)) {
+            if(mppt->i_result < CTL(MPPT_START_I_DARK)) {
+                // the snapshot was the input capacitor's charge, not the panel's Voc
+                start->state = Mppt_Start_Wait;
+                *delta = -duty;
+                return true;
+            }
+            start->state = Mppt_Start_Done;
+            start->dark = 0;
+            start->starts++;
+            mppt->strategy->init(mppt);
+            return false;
+        }
+        break;
+    }
+
+    *delta = start->duty - duty;
+    return true;
+}
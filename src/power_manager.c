@@ -0,0 +1,159 @@
+/*
+ * power_manager.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Discharge protection. Once per MPPT tick, after the battery, the power
+ *  manager decides how many output bucks to shed, in power_shed_order:
+ *
+ *      All on      while the PV charges the battery by POWER_PV_SURPLUS_I
+ *                  with the outputs on, or the battery has charge to spare
+ *      Shed        the 5V output is off once the battery discharges under
+ *                  POWER_SHED_SOC (src/soc.c), or within POWER_SHED_MARGIN
+ *                  of V_BATTERY_MIN_LIMIT. Back on at POWER_SHED_SOC_HYST
+ *                  and POWER_V_HYST above, or once the PV charges it
+ *      Cutoff      every output is off under V_BATTERY_MIN_LIMIT, PV or
+ *                  not, until the battery is V_BATTERY_CUTOFF_HYST above it
+ *                  and the PV charges it or its charge is over
+ *                  POWER_SHED_SOC + POWER_SHED_SOC_HYST. A rested pack's
+ *                  voltage recovers with no charge in it
+ *
+ *  Shedding has to be asked for POWER_SHED_DEBOUNCE_S in a row, restoring
+ *  POWER_RESTORE_S, so a PV input that cannot carry the loads does not
+ *  toggle them. A level change writes every output's enable at once, and
+ *  the buck loops act on it at their next sample: a shed output is held at
+ *  BUCK_DUTY_MIN, a restored one soft starts (set_buck_output()). The
+ *  outputs that stay on never see the change.
+ */
+
+#include "config.h"
+#include "power_manager.h"
+#include "src_adc.h"
+
+/** Indexed by ePowerLevel */
+const char * const power_level_names[Power_Level_Count] = {
+    "all_on",
+    "shed",
+    "cutoff"
+};
+
+/** Outputs in the order they are shed, the last one is only cut off */
+static const uint32_t power_shed_order[] = {
+    BUCK_5V_ID,
+    BUCK_3V3_ID
+};
+
+#define POWER_OUTPUTS   (sizeof(power_shed_order) / sizeof(power_shed_order[0]))
+
+/** Outputs off at each level */
+static const uint32_t power_level_shed[Power_Level_Count] = {
+    0U,
+    1U,
+    POWER_OUTPUTS
+};
+
+
+/**
+ * @brief Turns on the outputs the level keeps, and off the ones it sheds
+ */
+static void power_apply(ePowerLevel level) {
+    uint32_t n;
+
+    for(n = 0; n < POWER_OUTPUTS; n++) {
+        set_buck_output(power_shed_order[n], n >= power_level_shed[level]);
+    }
+}
+
+/**
+ * @param enabled false leaves every output on whatever the battery
+ */
+void init_power_manager(PowerManager_t * power, bool enabled) {
+    uint32_t n;
+
+    power->enabled = enabled;
+    power->level = Power_All_On;
+    power->pending = Power_All_On;
+    power->held = 0;
+    for(n = 0; n < Power_Level_Count; n++) {
+        power->level_ticks[n] = 0;
+    }
+    power->transitions = 0;
+    power_apply(Power_All_On);
+}
+
+/**
+ * @brief The level the battery asks for, or the current one
+ */
+static ePowerLevel power_next(const PowerManager_t * power, const Battery_t * battery) {
+    float v = battery->voltage;
+    float soc = battery->soc.fraction;
+    bool pv_supplies = (battery->state == Charge) && (battery->current > POWER_PV_SURPLUS_I);
+
+    switch(power->level) {
+    case(Power_All_On):
+        if(v < V_BATTERY_MIN_LIMIT) {
+            return Power_Cutoff;
+        }
+        if((pv_supplies == false)
+           && ((soc < POWER_SHED_SOC) || (v < (V_BATTERY_MIN_LIMIT + POWER_SHED_MARGIN)))) {
+            return Power_Shed;
+        }
+        break;
+    case(Power_Shed):
+        if(v < V_BATTERY_MIN_LIMIT) {
+            return Power_Cutoff;
+        }
+        if((v > (V_BATTERY_MIN_LIMIT + POWER_SHED_MARGIN + POWER_V_HYST))
+           && ((pv_supplies == true) || (soc > (POWER_SHED_SOC + POWER_SHED_SOC_HYST)))) {
+            return Power_All_On;
+        }
+        break;
+    case(Power_Cutoff):
+        if((v > (V_BATTERY_MIN_LIMIT + V_BATTERY_CUTOFF_HYST))
+           && ((pv_supplies == true) || (soc > (POWER_SHED_SOC + POWER_SHED_SOC_HYST)))) {
+            return Power_Shed;
+        }
+        break;
+    default:
+        break;
+    }
+    return power->level;
+}
+
+/**************************************************
+ * update_power_manager
+ *
+ * @brief Sheds or restores the outputs for one MPPT tick
+ *
+ * @details Call after update_battery(), with the battery's voltage, current,
+ *  state and state of charge of this tick.
+ *
+ **************************************************/
+void update_power_manager(PowerManager_t * power, const Battery_t * battery) {
+    ePowerLevel next;
+    uint32_t ticks;
+
+    power->level_ticks[power->level]++;
+    // nothing to go by before the ADC has averaged a battery block
+    if((power->enabled == false) || (battery->soc.seeded == false)) {
+        return;
+    }
+
+    next = power_next(power, battery);
+    if(next == power->level) {
+        power->pending = next;
+        power->held = 0;
+        return;
+    }
+    if(next != power->pending) {
+        power->pending = next;
+        power->held = 0;
+    }
+    ticks = (next > power->level) ? CHARGE_TICKS(POWER_SHED_DEBOUNCE_S) : CHARGE_TICKS(POWER_RESTORE_S);
+    if(++power->held >= ticks) {
+        power->level = next;
+        power->held = 0;
+        power->transitions++;
+        power_apply(next);
+    }
+}
@@ -0,0 +1,184 @@
+/*
+ * pv_loop.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  Panel voltage loops. Stepping a PV converter's duty cycle directly, the
+ *  panel voltage a step gives depends on the battery voltage and on where on
+ *  the I-V curve the panel is, and every step rings the input filter. Here
+ *  the MPPT moves a panel voltage reference instead (src/mppt_dual.c), and a
+ *  cascade running PV_LOOP_RATE times per MPPT tick from CPU timer 0 holds
+ *  the panel at it.
+ *
+ *  The board senses the panel current, not the inductor's. What the
+ *  converter draws from the input capacitor follows from it and the change
+ *  in panel voltage since the last run,
+ *      i_in = i_pv - C_in * dv/dt
+ *  and the inner loop regulates that average current with its own PI. The
+ *  outer loop asks for the panel current plus PV_LOOP_V_KP per volt above
+ *  the reference, which with C_in gives a first-order panel voltage
+ *  response; the inner loop's integrator takes up the offset, so the outer
+ *  one is proportional only. Both are compensators like the output bucks'.
+ *
+ *  A fast start or a global scan moves the duty cycle itself and releases
+ *  the loop, as does a dark panel the start holds off; the next MPPT step
+ *  takes over again from the duty cycle and panel voltage where they are.
+ */
+
+#include <stddef.h>
+#include "driverlib.h"
+
+#include "config.h"
+#include "pv_loop.h"
+#include "src_adc.h"
+#include "src_epwm.h"
+#include "trace.h"
+
+/** Both loops, run from pv_loop_irq() */
+static PvLoop_t * pv_loops[2];
+
+
+/**************************************************
+ * pv_loop_init
+ *
+ * @brief Sets up the panel voltage loop of one PV converter
+ *
+ * @param mppt_id MPPT_ONE_ID or MPPT_TWO_ID, the panel's V/I pair
+ *
+ * @param pwm_base ePWM of the converter
+ *
+ * @param enabled false to leave the MPPT stepping the duty cycle directly
+ *
+ **************************************************/
+void pv_loop_init(PvLoop_t * loop, uint32_t mppt_id, uint32_t pwm_base, bool enabled) {
+    loop->mppt_id = mppt_id;
+    loop->pwm_base = pwm_base;
+    loop->enabled = enabled;
+    loop->engaged = false;
+
+    compensator_init_pid(&loop->v_cntl, PV_LOOP_V_KP, 0.0f, 0.0f, 0.0f, PV_LOOP_PERIOD_S,
+                         0.0f, -PV_LOOP_I_TRIM, PV_LOOP_I_TRIM);
+    compensator_init_pid(&loop->i_cntl, PV_LOOP_I_KP, PV_LOOP_I_KI, 0.0f, 0.0f, PV_LOOP_PERIOD_S,
+                         0.0f, -PV_LOOP_D_TRIM, PV_LOOP_D_TRIM);
+    loop->v_ref = 0;
+    loop->duty_ff = 0;
+    loop->v_last = 0;
+    loop->i_in = 0;
+    loop->runs = 0;
+    loop->engages = 0;
+}
+
+/**
+ * @brief Hands both loops to pv_loop_irq()
+ *
+ * @details Set up with pv_loop_init() first, before PV_LOOP_TIMER_INT is enabled.
+ */
+void init_pv_loops(PvLoop_t * one, PvLoop_t * two) {
+    pv_loops[0] = one;
+    pv_loops[1] = two;
+}
+
+/**
+ * @brief Duty cycle of a buck in continuous conduction at v_ref [%]
+ *
+ * @details V_battery = D * V_panel. Recomputed with each MPPT step, the
+ *      battery voltage moves slowly.
+ */
+static ctl_t pv_loop_feedforward(ctl_t v_ref) {
+    float v = CTL_TO_F(v_ref);
+    float duty = (v > 0.0f) ? ((100.0f * get_battery_v()) / v) : 0.0f;
+
+    return CTL_FROM_F((duty > MPPT_SCAN_DUTY_MAX) ? MPPT_SCAN_DUTY_MAX : duty);
+}
+
+/**
+ * @brief Takes the duty cycle over from the MPPT, bumpless
+ *
+ * @param v_ref Panel voltage to hold [V], where the panel is
+ */
+void pv_loop_engage(PvLoop_t * loop, ctl_t v_ref) {
+    loop->v_ref = v_ref;
+    loop->v_last = get_mppt_v_sample_ctl(loop->mppt_id);
+    compensator_set_ref(&loop->v_cntl, -v_ref);
+    compensator_reset(&loop->v_cntl, 0);
+    loop->duty_ff = pv_loop_feedforward(v_ref);
+    compensator_reset(&loop->i_cntl, CTL_FROM_F(get_duty_cycle(loop->pwm_base)) - loop->duty_ff);
+    loop->engages++;
+    // last, the interrupt may run in between
+    loop->engaged = true;
+}
+
+/**
+ * @brief Leaves the duty cycle where it is to whoever writes it next
+ */
+void pv_loop_release(PvLoop_t * loop) {
+    loop->engaged = false;
+}
+
+/**
+ * @brief Moves the panel voltage reference by dv [V]
+ *
+ * @details The reference stays within PV_LOOP_V_LEAD of the panel voltage,
+ *      so it does not run away while the duty cycle is at a limit. The
+ *      reference and its feed-forward go out together with interrupts held
+ *      off, so pv_loop_irq() never runs a sample with one new and one old.
+ */
+void pv_loop_move_ref(PvLoop_t * loop, float dv) {
+    ctl_t v_ref = loop->v_ref + CTL_FROM_F(dv);
+    ctl_t v = loop->v_last;
+    ctl_t duty_ff;
+    bool was_disabled;
+
+    v_ref = (v_ref > (v + CTL(PV_LOOP_V_LEAD))) ? (v + CTL(PV_LOOP_V_LEAD)) : v_ref;
+    v_ref = (v_ref < (v - CTL(PV_LOOP_V_LEAD))) ? (v - CTL(PV_LOOP_V_LEAD)) : v_ref;
+    duty_ff = pv_loop_feedforward(v_ref);
+
+    was_disabled = Interrupt_disableGlobal();
+    loop->v_ref = v_ref;
+    compensator_set_ref(&loop->v_cntl, -v_ref);
+    loop->duty_ff = duty_ff;
+    if(!was_disabled) {
+        Interrupt_enableGlobal();
+    }
+}
+
+/**************************************************
+ * pv_loop_run
+ *
+ * @brief Runs one sample of the cascade on the latest V/I pair
+ *
+ * @details The outer compensator runs on the negated panel voltage: above
+ *  the reference the converter has to draw more than the panel gives.
+ *
+ **************************************************/
+void pv_loop_run(PvLoop_t * loop) {
+    ctl_t v = get_mppt_v_sample_ctl(loop->mppt_id);
+    ctl_t i_pv = get_mppt_i_sample_ctl(loop->mppt_id);
+    ctl_t duty;
+
+    loop->i_in = i_pv - CTL_MPY(CTL(PV_LOOP_C_IN / PV_LOOP_PERIOD_S), v - loop->v_last);
+    loop->v_last = v;
+    compensator_set_ref(&loop->i_cntl, i_pv + compensator_run_2p2z(&loop->v_cntl, -v));
+    duty = loop->duty_ff + compensator_run_2p2z(&loop->i_cntl, loop->i_in);
+    change_pwm_duty_cycle(loop->pwm_base, CTL_TO_F(duty));
+    loop->runs++;
+}
+
+
+/**********************************************************
+ *                  I N T E R R U P T S
+ **********************************************************/
+
+/** PV_LOOP_TIMER, PV_LOOP_RATE times per MPPT tick */
+__interrupt void pv_loop_irq(void) {
+    uint32_t n;
+
+    TRACE_START(Trace_PV_Loop);
+    for(n = 0; n < 2U; n++) {
+        if((pv_loops[n] != NULL) && (pv_loops[n]->engaged == true)) {
+            pv_loop_run(pv_loops[n]);
+        }
+    }
+    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP1);
+    TRACE_END(Trace_PV_Loop);
+}
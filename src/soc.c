@@ -0,0 +1,186 @@
+/*
+ * soc.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  State of charge. Once per MPPT tick the battery current, in Q24 amps,
+ *  adds to a 64 bit count of the charge in the battery. The count is an
+ *  integer: a tick's few microamp-hours never round away against a large
+ *  total, as they would in a float, and the count does not drift from the
+ *  current it is given. What it does drift from is the charge itself, by the
+ *  current sensor's offset and gain error, so while the battery rests, its
+ *  current filtered under SOC_REST_I for SOC_REST_S, the open-circuit
+ *  voltage corrects it. The pack's open-circuit voltage is the terminal
+ *  voltage less SOC_R_INT times the current, and soc_ocv_table gives the
+ *  state of charge it stands for. Each tick at rest takes 1/2^SOC_OCV_SHIFT
+ *  of the difference off the count, so the ADC noise on a single reading
+ *  moves it little.
+ *
+ *  The count starts from the open-circuit voltage at the first tick with a
+ *  battery reading, and the charger sets it full when it terminates a
+ *  charge (src/battery.c).
+ */
+
+#include "config.h"
+#include "soc.h"
+
+/** 2S Li-ion open-circuit voltage at 0%, 10% .. 100% of a charge to 8.30V [V] */
+static const float soc_ocv_curve[11] = {
+    6.00f, 6.90f, 7.10f, 7.24f, 7.36f, 7.48f, 7.62f, 7.78f, 7.92f, 8.10f, 8.30f
+};
+
+/** soc_ocv_curve up to V_BATTERY_CHG_LIMIT, at 0%, 10% .. 100% of the charge it holds there [V] */
+static float soc_ocv_table[11];
+
+#define SOC_OCV_STEPS   (sizeof(soc_ocv_table) / sizeof(soc_ocv_table[0]) - 1U)
+
+
+/**
+ * @brief Resamples soc_ocv_curve so that 100% is V_BATTERY_CHG_LIMIT
+ *
+ * @details Full is what the charger terminates at, not the top of the
+ *      curve: a pack charged to 8.20V holds 95% of the charge it would at
+ *      8.30V, and reads 100%.
+ *
+ * @return Fraction of the curve's charge held at V_BATTERY_CHG_LIMIT
+ */
+static float soc_ocv_table_init(void) {
+    float full = (float)SOC_OCV_STEPS;
+    float x;
+    uint32_t k;
+    uint32_t n;
+
+    for(n = 0; n < SOC_OCV_STEPS; n++) {
+        if(V_BATTERY_CHG_LIMIT < soc_ocv_curve[n + 1U]) {
+            full = (float)n + ((V_BATTERY_CHG_LIMIT - soc_ocv_curve[n]) / (soc_ocv_curve[n + 1U] - soc_ocv_curve[n]));
+            break;
+        }
+    }
+    for(k = 0; k <= SOC_OCV_STEPS; k++) {
+        x = full * (float)k / (float)SOC_OCV_STEPS;
+        n = (uint32_t)x;
+        n = (n < SOC_OCV_STEPS) ? n : (SOC_OCV_STEPS - 1U);
+        soc_ocv_table[k] = soc_ocv_curve[n] + ((x - (float)n) * (soc_ocv_curve[n + 1U] - soc_ocv_curve[n]));
+    }
+    return full / (float)SOC_OCV_STEPS;
+}
+
+/**
+ * @brief Empties the count, the first soc_update() starts it from the open-circuit voltage
+ *
+ * @param capacity_ah Of the pack charged to 8.30V [Ah], the count's 100% is
+ *      the part of it held at V_BATTERY_CHG_LIMIT
+ */
+void soc_init(Soc_t * soc, float capacity_ah) {
+    float held = soc_ocv_table_init();
+
+    soc->capacity = (int64_t)(capacity_ah * held * (3600.0f / CHARGE_TICK_S)) << Q24_SHIFT;
+    soc->charge = 0;
+    soc->fraction = 0.0f;
+    soc->i_avg = 0;
+    soc->rest_ticks = 0;
+    soc->corrections = 0;
+    soc->seeded = false;
+}
+
+/**
+ * @brief State of charge the open-circuit voltage stands for, 0.0 - 1.0
+ *
+ * @param v Battery terminal voltage [V]
+ *
+ * @param i Into the battery [A]
+ */
+float soc_ocv_fraction(ctl_t v, ctl_t i) {
+    float ocv = CTL_TO_F(v) - (SOC_R_INT * CTL_TO_F(i));
+    uint32_t n;
+
+    if(ocv <= soc_ocv_table[0]) {
+        return 0.0f;
+    }
+    for(n = 0; n < SOC_OCV_STEPS; n++) {
+        if(ocv < soc_ocv_table[n + 1U]) {
+            return ((float)n + ((ocv - soc_ocv_table[n]) / (soc_ocv_table[n + 1U] - soc_ocv_table[n])))
+                   / (float)SOC_OCV_STEPS;
+        }
+    }
+    return 1.0f;
+}
+
+static int64_t soc_charge_at(const Soc_t * soc, float fraction) {
+    return (int64_t)(fraction * (float)(soc->capacity >> Q24_SHIFT)) << Q24_SHIFT;
+}
+
+/**************************************************
+ * soc_update
+ *
+ * @brief Counts one MPPT tick of battery current
+ *
+ * @param v Battery voltage [V], 0 before the ADC has averaged a block
+ *
+ * @param i Into the battery [A], charging is positive
+ *
+ **************************************************/
+void soc_update(Soc_t * soc, ctl_t v, ctl_t i) {
+    int64_t error;
+
+    if(soc->seeded == false) {
+        if(v <= 0) {
+            return;
+        }
+        soc->charge = soc_charge_at(soc, soc_ocv_fraction(v, i));
+        soc->i_avg = i;
+        soc->seeded = true;
+    }
+
+    soc->charge += CTL_TO_Q24(i);
+    soc->i_avg += CTL_MPY(CTL(SOC_REST_FILTER), i - soc->i_avg);
+
+    if((soc->i_avg < CTL(SOC_REST_I)) && (soc->i_avg > -CTL(SOC_REST_I))) {
+        if(soc->rest_ticks < CHARGE_TICKS(SOC_REST_S)) {
+            soc->rest_ticks++;
+        }
+        else {
+            error = soc_charge_at(soc, soc_ocv_fraction(v, i)) - soc->charge;
+            soc->charge += error >> SOC_OCV_SHIFT;
+            soc->corrections++;
+        }
+    }
+    else {
+        soc->rest_ticks = 0;
+    }
+
+    soc->charge = (soc->charge < 0) ? 0 : soc->charge;
+    soc->charge = (soc->charge > soc->capacity) ? soc->capacity : soc->charge;
+    soc->fraction = (float)soc->charge / (float)soc->capacity;
+}
+
+/**
+ * @brief The charger terminated a charge, the battery is full whatever the count says
+ */
+void soc_set_full(Soc_t * soc) {
+    soc->charge = soc->capacity;
+    soc->fraction = 1.0f;
+    soc->seeded = true;
+}
+
+/**
+ * @brief Energy left in the battery down to empty [Wh]
+ *
+ * @details The charge under each step of soc_ocv_table at the step's mean
+ *      open-circuit voltage.
+ */
+float soc_energy(const Soc_t * soc) {
+    float capacity_ah = (float)(soc->capacity >> Q24_SHIFT) * (CHARGE_TICK_S / 3600.0f);
+    float steps = soc->fraction * (float)SOC_OCV_STEPS;
+    float energy = 0.0f;
+    float part;
+    uint32_t n;
+
+    for(n = 0; (n < SOC_OCV_STEPS) && (steps > 0.0f); n++) {
+        part = (steps < 1.0f) ? steps : 1.0f;
+        energy += part * (soc_ocv_table[n]
+                          + (0.5f * part * (soc_ocv_table[n + 1U] - soc_ocv_table[n])));
+        steps -= 1.0f;
+    }
+    return energy * capacity_ah / (float)SOC_OCV_STEPS;
+}
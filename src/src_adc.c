@@ -5,8 +5,14 @@
  *      Author: jack
  */
 
+#include <stddef.h>
 #include "src_adc.h"
 #include "config.h"
+#include "compensator.h"
+#include "cla_shared.h"
+#include "src_dma.h"
+#include "src_epwm.h"
+#include "trace.h"
 
 
 #define MPPT_LIST_SIZE                  4
@@ -35,164 +41,436 @@ typedef enum {
 typedef struct {
     uint32_t            base;
     uint32_t            resultBase;
-    uint16_t            adcResult;
-    uint32_t            millivolts;
-    float               stepped_down_volts;
-    float               volts;
-    float               current;
+    uint16_t            adcResult;  // raw, or a DMA ring average in 1/ADC_RING_COUNTS_PER_LSB LSB
+    ctl_t               value;      // [V] or [A]
     ADC_SOCNumber       socNumber;
     eAdcComponentType   component_type;
-    uint32_t            r_one;
-    uint32_t            r_two;
+    ctl_t               scale;      // [V/LSB] or [A/LSB]
+    ctl_t               offset;     // [V] or [A]
 } adcListComponent_t;
 
 static adcListComponent_t mppt_one_voltage = {
-                                              ADCA_BASE, ADCARESULT_BASE,
-                                              0, 0, 0.0, 0.0, 0.0,
-                                              ADC_SOC_NUMBER0, Voltage_Component,
-                                              V_PV_SENSE_R1, V_PV_SENSE_R2
+                                              ADC_PAIR_V_ADC, ADC_PAIR_V_RESULT,
+                                              0, 0.0,
+                                              MPPT_1_ADC_SOC, Voltage_Component,
+                                              ADC_VOLTAGE_SCALE(V_PV_SENSE_R1, V_PV_SENSE_R2), 0
                                              };
 
 static adcListComponent_t mppt_one_current = {
-                                              ADCA_BASE, ADCARESULT_BASE,
-                                              0, 0, 0.0, 0.0, 0.0,
-                                              ADC_SOC_NUMBER1, Current_Component,
-                                              0, 0
+                                              ADC_PAIR_I_ADC, ADC_PAIR_I_RESULT,
+                                              0, 0.0,
+                                              MPPT_1_ADC_SOC, Current_Component,
+                                              ADC_CURRENT_SCALE, ADC_CURRENT_OFFSET
                                              };
 
 
 static adcListComponent_t mppt_two_voltage = {
-                                              ADCA_BASE, ADCARESULT_BASE,
-                                              0, 0, 0.0, 0.0, 0.0,
-                                              ADC_SOC_NUMBER2, Voltage_Component,
-                                              V_PV_SENSE_R1, V_PV_SENSE_R2
+                                              ADC_PAIR_V_ADC, ADC_PAIR_V_RESULT,
+                                              0, 0.0,
+                                              MPPT_2_ADC_SOC, Voltage_Component,
+                                              ADC_VOLTAGE_SCALE(V_PV_SENSE_R1, V_PV_SENSE_R2), 0
                                              };
 
 static adcListComponent_t mppt_two_current = {
-                                              ADCA_BASE, ADCARESULT_BASE,
-                                              0, 0, 0.0, 0.0, 0.0,
-                                              ADC_SOC_NUMBER3, Current_Component,
-                                              0, 0
+                                              ADC_PAIR_I_ADC, ADC_PAIR_I_RESULT,
+                                              0, 0.0,
+                                              MPPT_2_ADC_SOC, Current_Component,
+                                              ADC_CURRENT_SCALE, ADC_CURRENT_OFFSET
                                              };
 
 
 static adcListComponent_t buck_5V_voltage  = {
-                                              ADCA_BASE, ADCARESULT_BASE,
-                                              0, 0, 0.0, 0.0, 0.0,
-                                              ADC_SOC_NUMBER4, Voltage_Component,
-                                              BUCK_5V_OUTPUT_R1, BUCK_5V_OUTPUT_R2
+                                              BUCK_ADC, BUCK_ADC_RESULT,
+                                              0, 0.0,
+                                              BUCK_5V_ADC_SOC, Voltage_Component,
+                                              ADC_VOLTAGE_SCALE(BUCK_5V_OUTPUT_R1, BUCK_5V_OUTPUT_R2), 0
                                              };
 
 static adcListComponent_t buck_3V3_voltage = {
-                                              ADCA_BASE, ADCARESULT_BASE,
-                                              0, 0, 0.0, 0.0, 0.0,
-                                              ADC_SOC_NUMBER5, Voltage_Component,
-                                              BUCK_3V3_OUTPUT_R1, BUCK_3V3_OUTPUT_R2
+                                              BUCK_ADC, BUCK_ADC_RESULT,
+                                              0, 0.0,
+                                              BUCK_3V3_ADC_SOC, Voltage_Component,
+                                              ADC_VOLTAGE_SCALE(BUCK_3V3_OUTPUT_R1, BUCK_3V3_OUTPUT_R2), 0
                                              };
 
 static adcListComponent_t battery_voltage = {
-                                             ADCA_BASE, ADCARESULT_BASE,
-                                             0, 0, 0.0, 0.0, 0.0,
-                                             ADC_SOC_NUMBER6, Voltage_Component,
-                                             V_BATT_SENSE_R1, V_BATT_SENSE_R2
+                                             ADC_PAIR_V_ADC, ADC_PAIR_V_RESULT,
+                                             0, 0.0,
+                                             BATT_ADC_SOC, Voltage_Component,
+                                             ADC_VOLTAGE_SCALE(V_BATT_SENSE_R1, V_BATT_SENSE_R2), 0
                                             };
 
 static adcListComponent_t battery_current = {
-                                             ADCA_BASE, ADCARESULT_BASE,
-                                             0, 0, 0.0, 0.0, 0.0,
-                                             ADC_SOC_NUMBER7, Current_Component,
-                                             0, 0
+                                             ADC_PAIR_I_ADC, ADC_PAIR_I_RESULT,
+                                             0, 0.0,
+                                             BATT_ADC_SOC, Current_Component,
+                                             ADC_CURRENT_SCALE, ADC_CURRENT_OFFSET
                                             };
 
+/** Output buck compensators, run from the ADC end-of-conversion interrupts */
+static Compensator_t * buck_5V_cntl;
+static Compensator_t * buck_3V3_cntl;
+static volatile bool buck_5V_enabled = true;
+static volatile bool buck_3V3_enabled = true;
+
 
 void init_adc(void) {
     // Setup VREF
     ADC_setVREF(ADCA_BASE, ADC_REFERENCE_INTERNAL, ADC_REFERENCE_3_3V);
     ADC_setVREF(ADCB_BASE, ADC_REFERENCE_INTERNAL, ADC_REFERENCE_3_3V);
+    ADC_setVREF(ADCC_BASE, ADC_REFERENCE_INTERNAL, ADC_REFERENCE_3_3V);
 
     // Set ADCCLK Divider to /4
     ADC_setPrescaler(ADCA_BASE, ADC_CLK_DIV_4_0);
     ADC_setPrescaler(ADCB_BASE, ADC_CLK_DIV_4_0);
+    ADC_setPrescaler(ADCC_BASE, ADC_CLK_DIV_4_0);
 
     // set pulse positions to late
     ADC_setInterruptPulseMode(ADCA_BASE, ADC_PULSE_END_OF_CONV);
     ADC_setInterruptPulseMode(ADCB_BASE, ADC_PULSE_END_OF_CONV);
+    ADC_setInterruptPulseMode(ADCC_BASE, ADC_PULSE_END_OF_CONV);
 
-    // enable ADCA
+    // enable ADCs
     ADC_enableConverter(ADCA_BASE);
     ADC_enableConverter(ADCB_BASE);
+    ADC_enableConverter(ADCC_BASE);
     DEVICE_DELAY_US(1000);
 
-    // Configure SOCs of ADCA
-    ADC_setupSOC(ADCA_BASE, ADC_SOC_NUMBER0, ADC_TRIGGER_SW_ONLY, ADC_CH_ADCIN0, 15);
-    ADC_setupSOC(ADCA_BASE, ADC_SOC_NUMBER1, ADC_TRIGGER_SW_ONLY, ADC_CH_ADCIN1, 15);
-    ADC_setupSOC(ADCA_BASE, ADC_SOC_NUMBER2, ADC_TRIGGER_SW_ONLY, ADC_CH_ADCIN4, 15);
-    ADC_setupSOC(ADCA_BASE, ADC_SOC_NUMBER3, ADC_TRIGGER_SW_ONLY, ADC_CH_ADCIN3, 15);
+    // V/I pairs: same SOC and trigger on both ADCs, so both are sampled at once
+    // MPPT 1
+    ADC_setupSOC(ADC_PAIR_V_ADC, mppt_one_voltage.socNumber, MPPT_1_ADC_TRIGGER, ADC_CH_ADCIN0, 15);
+    ADC_setupSOC(ADC_PAIR_I_ADC, mppt_one_current.socNumber, MPPT_1_ADC_TRIGGER, ADC_CH_ADCIN10, 15);
 
-    // Configure SOCs of ADCB
-    ADC_setupSOC(ADCB_BASE, ADC_SOC_NUMBER0, ADC_TRIGGER_SW_ONLY, ADC_CH_ADCIN0, 15);
-    ADC_setupSOC(ADCB_BASE, ADC_SOC_NUMBER1, ADC_TRIGGER_SW_ONLY, ADC_CH_ADCIN1, 15);
-    ADC_setupSOC(ADCB_BASE, ADC_SOC_NUMBER2, ADC_TRIGGER_SW_ONLY, ADC_CH_ADCIN4, 15);
-    ADC_setupSOC(ADCB_BASE, ADC_SOC_NUMBER3, ADC_TRIGGER_SW_ONLY, ADC_CH_ADCIN3, 15);
+    // MPPT 2
+    ADC_setupSOC(ADC_PAIR_V_ADC, mppt_two_voltage.socNumber, MPPT_2_ADC_TRIGGER, ADC_CH_ADCIN4, 15);
+    ADC_setupSOC(ADC_PAIR_I_ADC, mppt_two_current.socNumber, MPPT_2_ADC_TRIGGER, ADC_CH_ADCIN3, 15);
+
+    // MPPT pairs again at their converters' turn-on, for ripple correlation
+    ADC_setupSOC(ADC_PAIR_V_ADC, MPPT_1_RIPPLE_SOC, MPPT_1_RIPPLE_TRIGGER, ADC_CH_ADCIN0, 15);
+    ADC_setupSOC(ADC_PAIR_I_ADC, MPPT_1_RIPPLE_SOC, MPPT_1_RIPPLE_TRIGGER, ADC_CH_ADCIN10, 15);
+    ADC_setupSOC(ADC_PAIR_V_ADC, MPPT_2_RIPPLE_SOC, MPPT_2_RIPPLE_TRIGGER, ADC_CH_ADCIN4, 15);
+    ADC_setupSOC(ADC_PAIR_I_ADC, MPPT_2_RIPPLE_SOC, MPPT_2_RIPPLE_TRIGGER, ADC_CH_ADCIN3, 15);
+
+    // Battery, mid on-time of each MPPT
+    ADC_setupSOC(ADC_PAIR_V_ADC, battery_voltage.socNumber, BATT_ADC_TRIGGER, ADC_CH_ADCIN6, 15);
+    ADC_setupSOC(ADC_PAIR_I_ADC, battery_current.socNumber, BATT_ADC_TRIGGER, ADC_CH_ADCIN8, 15);
+    ADC_setupSOC(ADC_PAIR_V_ADC, BATT_2_ADC_SOC, BATT_2_ADC_TRIGGER, ADC_CH_ADCIN6, 15);
+    ADC_setupSOC(ADC_PAIR_I_ADC, BATT_2_ADC_SOC, BATT_2_ADC_TRIGGER, ADC_CH_ADCIN8, 15);
+
+    // Output bucks
+    ADC_setupSOC(BUCK_ADC, buck_5V_voltage.socNumber, BUCK_5V_ADC_TRIGGER, ADC_CH_ADCIN14, 15);
+    ADC_setupSOC(BUCK_ADC, buck_3V3_voltage.socNumber, BUCK_3V3_ADC_TRIGGER, ADC_CH_ADCIN4, 15);
+
+    // Buck EOCs interrupt the CPU, or start the CLA tasks with USE_CLA
+    ADC_setInterruptSource(BUCK_ADC, ADC_INT_NUMBER1, buck_5V_voltage.socNumber);
+    ADC_setInterruptSource(BUCK_ADC, ADC_INT_NUMBER2, buck_3V3_voltage.socNumber);
+    ADC_clearInterruptStatus(BUCK_ADC, ADC_INT_NUMBER1);
+    ADC_clearInterruptStatus(BUCK_ADC, ADC_INT_NUMBER2);
+    ADC_enableInterrupt(BUCK_ADC, ADC_INT_NUMBER1);
+    ADC_enableInterrupt(BUCK_ADC, ADC_INT_NUMBER2);
+
+    // The last pair of each group triggers both DMA channels, which never clear the flags
+    ADC_setInterruptSource(ADC_PAIR_I_ADC, ADC_RING_ADC_INT, MPPT_1_ADC_SOC);
+    ADC_setInterruptSource(ADC_PAIR_V_ADC, ADC_RING_ADC_INT, MPPT_1_ADC_SOC);
+    ADC_enableContinuousMode(ADC_PAIR_I_ADC, ADC_RING_ADC_INT);
+    ADC_enableContinuousMode(ADC_PAIR_V_ADC, ADC_RING_ADC_INT);
+    ADC_clearInterruptStatus(ADC_PAIR_I_ADC, ADC_RING_ADC_INT);
+    ADC_clearInterruptStatus(ADC_PAIR_V_ADC, ADC_RING_ADC_INT);
+    ADC_enableInterrupt(ADC_PAIR_I_ADC, ADC_RING_ADC_INT);
+    ADC_enableInterrupt(ADC_PAIR_V_ADC, ADC_RING_ADC_INT);
+
+    // and the last turn-on pair of each group the ripple DMA channels
+    ADC_setInterruptSource(ADC_PAIR_I_ADC, ADC_RIPPLE_ADC_INT, MPPT_2_RIPPLE_SOC);
+    ADC_setInterruptSource(ADC_PAIR_V_ADC, ADC_RIPPLE_ADC_INT, MPPT_2_RIPPLE_SOC);
+    ADC_enableContinuousMode(ADC_PAIR_I_ADC, ADC_RIPPLE_ADC_INT);
+    ADC_enableContinuousMode(ADC_PAIR_V_ADC, ADC_RIPPLE_ADC_INT);
+    ADC_clearInterruptStatus(ADC_PAIR_I_ADC, ADC_RIPPLE_ADC_INT);
+    ADC_clearInterruptStatus(ADC_PAIR_V_ADC, ADC_RIPPLE_ADC_INT);
+    ADC_enableInterrupt(ADC_PAIR_I_ADC, ADC_RIPPLE_ADC_INT);
+    ADC_enableInterrupt(ADC_PAIR_V_ADC, ADC_RIPPLE_ADC_INT);
 
     DEVICE_DELAY_US(1000);
 }
 
+/**
+ * @brief Attaches the buck compensators to the buck EOC interrupts
+ *
+ * @details The buck SOCs are started by BUCK_5V_PWM and BUCK_3V3_PWM, so each
+ *      compensator runs once per sample, as soon as its result is ready.
+ *      Register adc_buck_5V_irq() and adc_buck_3V3_irq() with
+ *      BUCK_5V_ADC_INT and BUCK_3V3_ADC_INT before enabling them.
+ */
+void init_buck_control(Compensator_t * five_volt_cntl, Compensator_t * three_volt_cntl) {
+    buck_5V_cntl = five_volt_cntl;
+    buck_3V3_cntl = three_volt_cntl;
+}
+
+/**
+ * @brief Turns an output buck on or off from its next sample
+ *
+ * @details Off holds its compensator at rest and its duty cycle at
+ *      BUCK_DUTY_MIN. On, the reference ramps up from 0V over
+ *      BUCK_SOFT_START_S, so the output restarts without overshoot.
+ *
+ * @param buck_id BUCK_5V_ID or BUCK_3V3_ID
+ */
+void set_buck_output(uint32_t buck_id, bool on) {
+#ifdef USE_CLA
+    if(buck_id < CLA_BUCK_COUNT) {
+        cla_buck_command[buck_id].enable = (on == true) ? 1U : 0U;
+    }
+#else
+    switch(buck_id) {
+    case(BUCK_5V_ID): buck_5V_enabled = on; break;
+    case(BUCK_3V3_ID): buck_3V3_enabled = on; break;
+    }
+#endif
+}
+
+/**
+ * @brief Duty cycle of an output buck for one sample, soft starting or held off [%]
+ */
+static inline ctl_t buck_loop(Compensator_t * cntl, ctl_t volts, bool enabled, float v_out) {
+    if(enabled == false) {
+        compensator_hold(cntl);
+        return CTL(BUCK_DUTY_MIN);
+    }
+    compensator_ramp_ref(cntl, CTL(v_out), BUCK_SOFT_START_STEP(v_out));
+    return compensator_run_2p2z(cntl, volts);
+}
+
+/**
+ * @brief Trims one current sensor's offset so its zero-current output reads 0A
+ */
+static void calibrate_current_offset(adcListComponent_t * adcComponent) {
+    uint32_t sum = 0;
+    uint16_t n;
+    float error;
+
+    for(n = 0; n < I_SENSE_CAL_SAMPLES; n++) {
+        // convert the whole V/I pair, as its trigger would
+        ADC_forceSOC(ADC_PAIR_V_ADC, adcComponent->socNumber);
+        ADC_forceSOC(adcComponent->base, adcComponent->socNumber);
+        while(ADC_isBusy(ADC_PAIR_V_ADC) || ADC_isBusy(adcComponent->base)) {
+        }
+        sum += ADC_readResult(adcComponent->resultBase, adcComponent->socNumber);
+    }
+
+    // reading at 0A with the compile-time offset
+    error = (((float)sum / (float)I_SENSE_CAL_SAMPLES) * CTL_TO_F(adcComponent->scale))
+            + CTL_TO_F(adcComponent->offset);
+
+    // further out than the sensor's tolerance, current was flowing
+    if((error <= I_SENSE_ZERO_TOL) && (error >= -I_SENSE_ZERO_TOL)) {
+        adcComponent->offset -= CTL_FROM_F(error);
+    }
+}
+
+/**
+ * @brief Boot-time trim of the current sensor zero offsets
+ *
+ * @details Call after init_adc() and before the converters switch or the DMA
+ *      ring is started: every current SOC is forced I_SENSE_CAL_SAMPLES times
+ *      and the average is taken as 0A. The voltage scales come from the
+ *      divider resistors alone and are not trimmed.
+ */
+void adc_calibrate_current_offsets(void) {
+    calibrate_current_offset(&mppt_one_current);
+    calibrate_current_offset(&mppt_two_current);
+    calibrate_current_offset(&battery_current);
+
+    // the forced conversions of the ring SOC set its flags
+    ADC_clearInterruptStatus(ADC_PAIR_I_ADC, ADC_RING_ADC_INT);
+    ADC_clearInterruptStatus(ADC_PAIR_V_ADC, ADC_RING_ADC_INT);
+}
+
 
 /**********************************************************
  *                      G E T S
  **********************************************************/
 
+/*
+ * With USE_CLA the buck samples are taken by the CLA tasks and reported
+ * through cla_buck_status.
+ */
 float get_buck_v(uint32_t buck_id) {
+#ifdef USE_CLA
+    if(buck_id < CLA_BUCK_COUNT) {
+        return cla_buck_status[buck_id].volts;
+    }
+#else
     switch(buck_id) {
-    case(BUCK_5V_ID): return buck_5V_voltage.volts;
-    case(BUCK_3V3_ID): return buck_3V3_voltage.volts;
+    case(BUCK_5V_ID): return CTL_TO_F(buck_5V_voltage.value);
+    case(BUCK_3V3_ID): return CTL_TO_F(buck_3V3_voltage.value);
     }
+#endif
     return -1.0;
 }
 
 float get_buck_stepped_down_v(uint32_t buck_id) {
+#ifdef USE_CLA
+    if(buck_id < CLA_BUCK_COUNT) {
+        return adc_convert_to_v(cla_buck_status[buck_id].adc_result);
+    }
+#else
     switch(buck_id) {
-    case(BUCK_5V_ID): return buck_5V_voltage.stepped_down_volts;
-    case(BUCK_3V3_ID): return buck_3V3_voltage.stepped_down_volts;
+    case(BUCK_5V_ID): return adc_convert_to_v(buck_5V_voltage.adcResult);
+    case(BUCK_3V3_ID): return adc_convert_to_v(buck_3V3_voltage.adcResult);
     }
+#endif
     return -1.0;
 }
 
 float get_mppt_v(uint32_t mppt_id) {
+    return CTL_TO_F(get_mppt_v_ctl(mppt_id));
+}
+
+ctl_t get_mppt_v_ctl(uint32_t mppt_id) {
     switch(mppt_id) {
-    case(MPPT_ONE_ID): return mppt_one_voltage.volts;
-    case(MPPT_TWO_ID): return mppt_two_voltage.volts;
+    case(MPPT_ONE_ID): return mppt_one_voltage.value;
+    case(MPPT_TWO_ID): return mppt_two_voltage.value;
+    }
+    return CTL(-1.0);
+}
+
+/**
+ * @brief How far the panel voltage moved across the last block [V], unsigned
+ *
+ * @details See adc_ring_drift(). Near zero once the converter has settled
+ *      after a change in duty cycle.
+ */
+ctl_t get_mppt_v_drift_ctl(uint32_t mppt_id) {
+    const adcListComponent_t * voltage;
+    int16_t drift;
+
+    switch(mppt_id) {
+    case(MPPT_ONE_ID): voltage = &mppt_one_voltage; break;
+    case(MPPT_TWO_ID): voltage = &mppt_two_voltage; break;
+    default: return CTL(-1.0);
+    }
+    drift = adc_ring_drift(voltage->resultBase, voltage->socNumber);
+    return adc_scale_ring((uint16_t)((drift < 0) ? -drift : drift), voltage->scale, 0);
+}
+
+/**
+ * @brief The panel's V/I pair converted last, not averaged [V] and [A]
+ *
+ * @details For loops running faster than the DMA ring's blocks. The pair is
+ *      sampled every ADC_PAIR_PRESCALE switching periods.
+ */
+static const adcListComponent_t * mppt_component(uint32_t mppt_id, eAdcComponentType type) {
+    switch(mppt_id) {
+    case(MPPT_ONE_ID): return (type == Voltage_Component) ? &mppt_one_voltage : &mppt_one_current;
+    case(MPPT_TWO_ID): return (type == Voltage_Component) ? &mppt_two_voltage : &mppt_two_current;
+    }
+    return NULL;
+}
+
+ctl_t get_mppt_v_sample_ctl(uint32_t mppt_id) {
+    const adcListComponent_t * voltage = mppt_component(mppt_id, Voltage_Component);
+
+    if(voltage == NULL) {
+        return CTL(-1.0);
+    }
+    return adc_scale(ADC_readResult(voltage->resultBase, voltage->socNumber), voltage->scale, voltage->offset);
+}
+
+ctl_t get_mppt_i_sample_ctl(uint32_t mppt_id) {
+    const adcListComponent_t * current = mppt_component(mppt_id, Current_Component);
+
+    if(current == NULL) {
+        return CTL(-1.0);
+    }
+    return adc_scale(ADC_readResult(current->resultBase, current->socNumber), current->scale, current->offset);
+}
+
+/**
+ * @brief Turn-on switching ripple of a ring channel, about the block mean, per sample
+ */
+static ctl_t mppt_ripple(int32_t sum, const adcListComponent_t * component) {
+    return CTL_FROM_F(((float)sum / (float)(ADC_RIPPLE_BLOCK * ADC_RING_COUNTS_PER_LSB)) * CTL_TO_F(component->scale));
+}
+
+/**
+ * @brief Panel voltage ripple at turn-on, about the mean, across the last block [V]
+ *
+ * @details The input capacitor discharges through the on-time, so this is
+ *      half its peak-to-peak ripple, positive while the converter switches.
+ */
+ctl_t get_mppt_ripple_v_ctl(uint32_t mppt_id) {
+    const adcListComponent_t * voltage = mppt_component(mppt_id, Voltage_Component);
+
+    if(voltage == NULL) {
+        return 0;
+    }
+    return mppt_ripple(adc_ring_ripple(voltage->socNumber)->v, voltage);
+}
+
+/**
+ * @brief Panel current ripple at turn-on, about the mean, across the last block [A]
+ *
+ * @details The panel current follows the input capacitor voltage along the
+ *      I-V curve, so this is dI/dV times get_mppt_ripple_v_ctl().
+ */
+ctl_t get_mppt_ripple_i_ctl(uint32_t mppt_id) {
+    const adcListComponent_t * voltage = mppt_component(mppt_id, Voltage_Component);
+    const adcListComponent_t * current = mppt_component(mppt_id, Current_Component);
+
+    if((voltage == NULL) || (current == NULL)) {
+        return 0;
+    }
+    return mppt_ripple(adc_ring_ripple(voltage->socNumber)->i, current);
+}
+
+/**
+ * @brief Has the DMA ring correlate an input's turn-on samples, for get_mppt_ripple_*()
+ */
+void set_mppt_ripple(uint32_t mppt_id, bool on) {
+    const adcListComponent_t * voltage = mppt_component(mppt_id, Voltage_Component);
+
+    if(voltage != NULL) {
+        adc_ring_set_ripple(voltage->socNumber, on);
     }
-    return -1.0;
 }
 
 float get_mppt_stepped_down_v(uint32_t mppt_id) {
     switch(mppt_id) {
-    case(MPPT_ONE_ID): return mppt_one_voltage.stepped_down_volts;
-    case(MPPT_TWO_ID): return mppt_two_voltage.stepped_down_volts;
+    case(MPPT_ONE_ID): return (float)mppt_one_voltage.adcResult * ADC_RING_V_PER_LSB;
+    case(MPPT_TWO_ID): return (float)mppt_two_voltage.adcResult * ADC_RING_V_PER_LSB;
     }
     return -1.0;
 }
 
 float get_mppt_i(uint32_t mppt_id) {
+    return CTL_TO_F(get_mppt_i_ctl(mppt_id));
+}
+
+ctl_t get_mppt_i_ctl(uint32_t mppt_id) {
     switch(mppt_id) {
-    case(MPPT_ONE_ID): return mppt_one_current.current;
-    case(MPPT_TWO_ID): return mppt_two_current.current;
+    case(MPPT_ONE_ID): return mppt_one_current.value;
+    case(MPPT_TWO_ID): return mppt_two_current.value;
     }
-    return -1.0;
+    return CTL(-1.0);
 }
 
 float get_battery_v(void) {
-    return battery_voltage.volts;
+    return CTL_TO_F(battery_voltage.value);
 }
 
 float get_battery_stepped_down_v(void) {
-    return battery_voltage.stepped_down_volts;
+    return (float)battery_voltage.adcResult * ADC_RING_V_PER_LSB;
 }
 
 float get_battery_i(void) {
-    return battery_current.current;
+    return CTL_TO_F(battery_current.value);
+}
+
+ctl_t get_battery_v_ctl(void) {
+    return battery_voltage.value;
+}
+
+ctl_t get_battery_i_ctl(void) {
+    return battery_current.value;
 }
 
 
@@ -215,47 +493,52 @@ uint32_t adc_convert_to_mv(uint32_t adc_result) {
 /**
  * @brief Converts the ADC result to volts
  *
- * @details Multiplies the ADC results by the value of VREF
- *      and then divides by the maximum value of the ADC.
+ * @details Multiplies the ADC results by the volts per LSB, a
+ *      compile-time constant.
  *
  * @return Value in Volts
  */
 float adc_convert_to_v(uint32_t adc_result) {
-    return (((float)adc_result * VREF_MV_F) / ADC_MAX_VALUE_F);
+    return ((float)adc_result * ADC_V_PER_LSB);
 }
 
 
 /*
- * @brief Updates the ADC component
+ * @brief Scales the ADC component's adcResult
+ *
+ * @details One multiply-add with the component's scale and offset, which
+ *      hold the divider or sensor transfer function folded in at compile
+ *      time and any trim from adc_calibrate_current_offsets().
  */
-void update_conversion(adcListComponent_t * adcComponent) {
-    ADC_forceSOC(adcComponent->base, adcComponent->socNumber);
-    while(ADC_isBusy(adcComponent->base));
-    adcComponent->adcResult = ADC_readResult(adcComponent->resultBase, adcComponent->socNumber);
-    adcComponent->millivolts = adc_convert_to_mv(adcComponent->adcResult);
-    adcComponent->stepped_down_volts = adc_convert_to_v(adcComponent->adcResult);
-
-    if(adcComponent->component_type == Voltage_Component) {
-        adcComponent->volts = VOLTAGE_UNDIVIDER(adcComponent->stepped_down_volts, adcComponent->r_one, adcComponent->r_two);
-    }
-    else if(adcComponent->component_type == Current_Component) {
-        adcComponent->current = I_SENSED(adcComponent->stepped_down_volts);
-    }
+static void convert_result(adcListComponent_t * adcComponent) {
+    adcComponent->value = adc_scale(adcComponent->adcResult, adcComponent->scale, adcComponent->offset);
 }
 
+/*
+ * @brief Converts the latest result of the ADC component
+ */
+void read_conversion(adcListComponent_t * adcComponent) {
+    adcComponent->adcResult = ADC_readResult(adcComponent->resultBase, adcComponent->socNumber);
+    convert_result(adcComponent);
+}
 
-/**
- * @brief Updates the buck ADC list based on the latest ADC results available
+/*
+ * @brief Converts the ADC component's average over the newest DMA block
+ *
+ * @details The average has ADC_OVERSAMPLE_BITS more bits than a sample,
+ *      see adc_scale_ring().
  */
-void update_output_buck_conversions(void) {
-    update_conversion(&buck_5V_voltage);
-    update_conversion(&buck_3V3_voltage);
+void update_conversion(adcListComponent_t * adcComponent) {
+    adcComponent->adcResult = adc_ring_result(adcComponent->resultBase, adcComponent->socNumber);
+    adcComponent->value = adc_scale_ring(adcComponent->adcResult, adcComponent->scale, adcComponent->offset);
 }
 
 /**
  * @brief Updates the MPPT ADC list based on the latest ADC results available
  */
 void update_mppt_conversions(void) {
+    adc_ring_update();
+
     // MPPT 1
     update_conversion(&mppt_one_voltage);
     update_conversion(&mppt_one_current);
@@ -265,12 +548,37 @@ void update_mppt_conversions(void) {
     update_conversion(&mppt_two_current);
 }
 
+/*
+ * @brief Converts the average of the battery's two ring channels, one from
+ *      each MPPT's mid on-time, see BATT_2_ADC_SOC
+ *
+ * @details A converter held off has no ripple to cancel the other's, its
+ *      channel sits half a period into the other's ripple and is left out.
+ */
+static void update_battery_conversion(adcListComponent_t * adcComponent) {
+    uint16_t one = adc_ring_result(adcComponent->resultBase, adcComponent->socNumber);
+    uint16_t two = adc_ring_result(adcComponent->resultBase, BATT_2_ADC_SOC);
+
+    if(get_duty_cycle(MPPT_2_PWM) == 0.0f) {
+        adcComponent->adcResult = one;
+    }
+    else if(get_duty_cycle(MPPT_1_PWM) == 0.0f) {
+        adcComponent->adcResult = two;
+    }
+    else {
+        adcComponent->adcResult = (uint16_t)(((uint32_t)one + two + 1U) >> 1);
+    }
+    adcComponent->value = adc_scale_ring(adcComponent->adcResult, adcComponent->scale, adcComponent->offset);
+}
+
 /**
  * @brief Updates the Battery ADC list based on the latest ADC results available
  */
 void update_battery_conversions(void) {
-    update_conversion(&battery_voltage);
-    update_conversion(&battery_current);
+    adc_ring_update();
+
+    update_battery_conversion(&battery_voltage);
+    update_battery_conversion(&battery_current);
 }
 
 
@@ -279,24 +587,28 @@ void update_battery_conversions(void) {
  **********************************************************/
 
 
-///** 5V Buck **/
-//__interrupt void adc_buck_5V_irq(void) {
-//    buck_5V_mv = ADC_readResult(ADCARESULT_BASE, ADC_SOC_NUMBER0);
-//    buck_5V_stepped_down_v = adc_convert_to_v(buck_5V_mv);
-//    buck_5V_v = VOLTAGE_UNDIVIDER(buck_5V_stepped_down_v, BUCK_5V_OUTPUT_R1, BUCK_5V_OUTPUT_R2);
-//    ADC_clearInterruptStatus(ADCA_BASE, ADC_INT_NUMBER1);
-//    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP1);
-//}
-//
-///** 3.3V Buck **/
-//__interrupt void adc_buck_3V3_irq(void) {
-//    buck_3V3_mv = ADC_readResult(ADCARESULT_BASE, ADC_SOC_NUMBER1);
-//    buck_3V3_stepped_down_v = adc_convert_to_v(buck_3V3_mv);
-//    buck_3V3_v = VOLTAGE_UNDIVIDER(buck_3V3_stepped_down_v, BUCK_3V3_OUTPUT_R1, BUCK_3V3_OUTPUT_R2);
-//    ADC_clearInterruptStatus(ADCA_BASE, ADC_INT_NUMBER2);
-//    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP10);
-//}
-//
+/** 5V Buck **/
+__interrupt void adc_buck_5V_irq(void) {
+    TRACE_START(Trace_Buck_5V);
+    read_conversion(&buck_5V_voltage);
+    change_pwm_duty_cycle(BUCK_5V_PWM, CTL_TO_F(buck_loop(buck_5V_cntl, buck_5V_voltage.value,
+                                                          buck_5V_enabled, V_BUCK_5V_OUT)));
+    ADC_clearInterruptStatus(BUCK_ADC, ADC_INT_NUMBER1);
+    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP1);
+    TRACE_END(Trace_Buck_5V);
+}
+
+/** 3.3V Buck **/
+__interrupt void adc_buck_3V3_irq(void) {
+    TRACE_START(Trace_Buck_3V3);
+    read_conversion(&buck_3V3_voltage);
+    change_pwm_duty_cycle(BUCK_3V3_PWM, CTL_TO_F(buck_loop(buck_3V3_cntl, buck_3V3_voltage.value,
+                                                           buck_3V3_enabled, V_BUCK_3V3_OUT)));
+    ADC_clearInterruptStatus(BUCK_ADC, ADC_INT_NUMBER2);
+    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP10);
+    TRACE_END(Trace_Buck_3V3);
+}
+
 ///** MPPT 1 **/
 //__interrupt void adc_mppt_one_v_irq(void) {
 //    mppt_one_mv = ADC_readResult(ADCARESULT_BASE, ADC_SOC_NUMBER2);
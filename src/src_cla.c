@@ -0,0 +1,98 @@
+/*
+ * src_cla.c
+ *
+ *  Created on: Oct 17, 2026
+ *
+ *  CPU side of the CLA: memory setup, task vectors and triggers. The task
+ *  code is in cla_tasks.cla.
+ *
+ *  Memory map (see the 280049C linker command files):
+ *      LS4     CLA program (Cla1Prog)
+ *      LS6     data shared with the CPU (CLADataLS6)
+ *      LS7     CLA-only data (.scratchpad, .bss_cla, .const_cla)
+ *      CLA1_MSGRAMLOW  CLA to CPU messages (Cla1ToCpuMsgRAM)
+ *      CLA1_MSGRAMHIGH CPU to CLA messages (CpuToCla1MsgRAM)
+ */
+
+#include <string.h>
+
+#include "src_cla.h"
+#include "cla_shared.h"
+#include "config.h"
+
+#ifdef USE_CLA
+
+#pragma DATA_SECTION(cla_buck_cntl, "CLADataLS6")
+Compensator_t cla_buck_cntl[CLA_BUCK_COUNT];
+
+#pragma DATA_SECTION(cla_buck_status, "Cla1ToCpuMsgRAM")
+ClaBuckStatus_t cla_buck_status[CLA_BUCK_COUNT];
+
+#pragma DATA_SECTION(cla_buck_command, "CpuToCla1MsgRAM")
+ClaBuckCommand_t cla_buck_command[CLA_BUCK_COUNT];
+
+#ifdef _FLASH
+// Created by the linker, see 280049C_FLASH_lnk.cmd
+extern uint16_t Cla1ProgLoadStart;
+extern uint16_t Cla1ProgLoadSize;
+extern uint16_t Cla1ProgRunStart;
+extern uint16_t Cla1ConstLoadStart;
+extern uint16_t Cla1ConstLoadSize;
+extern uint16_t Cla1ConstRunStart;
+#endif
+
+
+/**
+ * @brief Gives the CLA its memory and maps the task vectors
+ *
+ * @details Tasks stay disabled until init_cla_buck_control() has loaded
+ *      their data. Call once, before the peripherals that trigger them are
+ *      started.
+ */
+void init_cla(void) {
+    SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_CLA1);
+
+#ifdef _FLASH
+    // the CPU cannot write LS RAM once it is CLA program memory, copy first
+    memcpy(&Cla1ProgRunStart, &Cla1ProgLoadStart, (size_t)&Cla1ProgLoadSize);
+    memcpy(&Cla1ConstRunStart, &Cla1ConstLoadStart, (size_t)&Cla1ConstLoadSize);
+#endif
+
+    MemCfg_setLSRAMMasterSel(MEMCFG_SECT_LS4, MEMCFG_LSRAMMASTER_CPU_CLA1);
+    MemCfg_setCLAMemType(MEMCFG_SECT_LS4, MEMCFG_CLA_MEM_PROGRAM);
+    MemCfg_setLSRAMMasterSel(MEMCFG_SECT_LS6, MEMCFG_LSRAMMASTER_CPU_CLA1);
+    MemCfg_setCLAMemType(MEMCFG_SECT_LS6, MEMCFG_CLA_MEM_DATA);
+    MemCfg_setLSRAMMasterSel(MEMCFG_SECT_LS7, MEMCFG_LSRAMMASTER_CPU_CLA1);
+    MemCfg_setCLAMemType(MEMCFG_SECT_LS7, MEMCFG_CLA_MEM_DATA);
+
+    CLA_mapTaskVector(CLA1_BASE, CLA_MVECT_1, (uint16_t)&Cla1Task1);
+    CLA_mapTaskVector(CLA1_BASE, CLA_MVECT_2, (uint16_t)&Cla1Task2);
+
+    // the CPU cannot write the CLA to CPU message RAM, clear it in hardware
+    MemCfg_initSections(MEMCFG_SECT_MSGX_ALL);
+    while(!MemCfg_getInitStatus(MEMCFG_SECT_MSGX_ALL));
+
+    // allow the CPU to force tasks, e.g. from the debugger
+    CLA_enableIACK(CLA1_BASE);
+}
+
+/**
+ * @brief Hands the buck compensators to the CLA and starts the buck tasks
+ *
+ * @details The compensators are copied into CLA data RAM; after this call
+ *      the CPU copies are no longer run. The tasks are started by the same
+ *      buck ADC EOCs that adc_buck_5V_irq() / adc_buck_3V3_irq() use without
+ *      USE_CLA, so BUCK_5V_ADC_INT and BUCK_3V3_ADC_INT stay disabled.
+ */
+void init_cla_buck_control(const Compensator_t * five_volt_cntl, const Compensator_t * three_volt_cntl) {
+    cla_buck_cntl[BUCK_5V_ID] = *five_volt_cntl;
+    cla_buck_cntl[BUCK_3V3_ID] = *three_volt_cntl;
+    cla_buck_command[BUCK_5V_ID].enable = 1U;
+    cla_buck_command[BUCK_3V3_ID].enable = 1U;
+
+    CLA_setTriggerSource(BUCK_5V_CLA_TASK, BUCK_5V_CLA_TRIGGER);
+    CLA_setTriggerSource(BUCK_3V3_CLA_TASK, BUCK_3V3_CLA_TRIGGER);
+    CLA_enableTasks(CLA1_BASE, CLA_TASKFLAG_1 | CLA_TASKFLAG_2);
+}
+
+#endif /* USE_CLA */
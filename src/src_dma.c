@@ -0,0 +1,314 @@
+/*
+ * src_dma.c
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "src_dma.h"
+#include "config.h"
+#include "trace.h"
+
+#define ADC_RING_I      0U
+#define ADC_RING_V      1U
+
+/* First result register of a group, the DMA sources */
+#define ADC_RING_SRC(RESULT_BASE)   ((const void *)(uintptr_t)((RESULT_BASE) + ADC_O_RESULT0 + ADC_RING_FIRST_SOC))
+#define ADC_RIPPLE_SRC(RESULT_BASE) ((const void *)(uintptr_t)((RESULT_BASE) + ADC_O_RESULT0 + ADC_RIPPLE_FIRST_SOC))
+
+/*
+ * One row per channel. The DMA writes a burst down a column (burst step
+ * ADC_RING_DEPTH), then moves to the next column (transfer step), so each
+ * channel's samples end up contiguous.
+ */
+#pragma DATA_SECTION(adc_ring, "ramgs0")
+static uint16_t adc_ring[ADC_RING_ADCS][ADC_RING_CHANNELS][ADC_RING_DEPTH];
+#pragma DATA_SECTION(adc_ripple_ring, "ramgs0")
+static uint16_t adc_ripple_ring[ADC_RING_ADCS][ADC_RIPPLE_CHANNELS][ADC_RIPPLE_DEPTH];
+
+static volatile AdcRingStats_t adc_ring_stats;
+static uint32_t adc_ring_read_block;    // blocks seen by the last adc_ring_update()
+static uint16_t adc_ring_mean[ADC_RING_ADCS][ADC_RING_CHANNELS];
+static int16_t adc_ring_drift_mean[ADC_RING_ADCS][ADC_RING_CHANNELS];
+static AdcRingRipple_t adc_ring_ripple_sums[ADC_RING_MPPT_CHANNELS];
+static bool adc_ring_ripple_enabled[ADC_RING_MPPT_CHANNELS];
+static const AdcRingRipple_t adc_ring_no_ripple;
+
+
+/**
+ * @brief Sets up one DMA channel to copy a group's results from an ADC
+ *
+ * @param ring First sample of the ring's first channel
+ * @param channels Results per group, one ring row each
+ * @param block Groups per transfer
+ * @param depth Samples per row, two blocks
+ */
+static void init_adc_ring_channel(uint32_t dma_base, DMA_Trigger trigger, uint16_t * ring,
+                                  const void * results, uint16_t channels, uint32_t block,
+                                  uint16_t depth) {
+    DMA_configAddresses(dma_base, ring, results);
+    DMA_configBurst(dma_base, channels, 1, depth);
+    DMA_configTransfer(dma_base, block, -(int16_t)(channels - 1U),
+                       1 - (int16_t)((channels - 1U) * depth));
+    DMA_configMode(dma_base, trigger,
+                   DMA_CFG_ONESHOT_DISABLE | DMA_CFG_CONTINUOUS_ENABLE | DMA_CFG_SIZE_16BIT);
+    DMA_enableTrigger(dma_base);
+}
+
+
+/**
+ * @brief Sets up ADC_RING_DMA_I and ADC_RING_DMA_V to copy every group of
+ *      MPPT/battery pairs into adc_ring, and ADC_RIPPLE_DMA_I and
+ *      ADC_RIPPLE_DMA_V every group of turn-on pairs into adc_ripple_ring
+ *
+ * @details One transfer fills one block; the channels run continuously and
+ *      dma_adc_ring_irq() and dma_adc_ripple_irq() point the next transfers
+ *      at the other block. The I and V channels of a ring are triggered by
+ *      the same pair of simultaneous EOCs, so only the I channel interrupts.
+ *      Call after init_adc(); register dma_adc_ring_irq() with
+ *      ADC_RING_DMA_INT and dma_adc_ripple_irq() with ADC_RIPPLE_DMA_INT,
+ *      sampling starts with the ePWM triggers.
+ */
+void init_adc_dma(void) {
+    SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_DMA);
+    DMA_initController();
+    DMA_setEmulationMode(DMA_EMULATION_FREE_RUN);
+
+    init_adc_ring_channel(ADC_RING_DMA_I, ADC_RING_DMA_I_TRIGGER, &adc_ring[ADC_RING_I][0][0],
+                          ADC_RING_SRC(ADC_PAIR_I_RESULT), ADC_RING_CHANNELS, ADC_RING_BLOCK, ADC_RING_DEPTH);
+    init_adc_ring_channel(ADC_RING_DMA_V, ADC_RING_DMA_V_TRIGGER, &adc_ring[ADC_RING_V][0][0],
+                          ADC_RING_SRC(ADC_PAIR_V_RESULT), ADC_RING_CHANNELS, ADC_RING_BLOCK, ADC_RING_DEPTH);
+    init_adc_ring_channel(ADC_RIPPLE_DMA_I, ADC_RIPPLE_DMA_I_TRIGGER, &adc_ripple_ring[ADC_RING_I][0][0],
+                          ADC_RIPPLE_SRC(ADC_PAIR_I_RESULT), ADC_RIPPLE_CHANNELS, ADC_RIPPLE_BLOCK, ADC_RIPPLE_DEPTH);
+    init_adc_ring_channel(ADC_RIPPLE_DMA_V, ADC_RIPPLE_DMA_V_TRIGGER, &adc_ripple_ring[ADC_RING_V][0][0],
+                          ADC_RIPPLE_SRC(ADC_PAIR_V_RESULT), ADC_RIPPLE_CHANNELS, ADC_RIPPLE_BLOCK, ADC_RIPPLE_DEPTH);
+
+    DMA_setInterruptMode(ADC_RING_DMA_I, DMA_INT_AT_END);
+    DMA_enableInterrupt(ADC_RING_DMA_I);
+    DMA_setInterruptMode(ADC_RIPPLE_DMA_I, DMA_INT_AT_END);
+    DMA_enableInterrupt(ADC_RIPPLE_DMA_I);
+
+    DMA_startChannel(ADC_RING_DMA_I);
+    DMA_startChannel(ADC_RING_DMA_V);
+    DMA_startChannel(ADC_RIPPLE_DMA_I);
+    DMA_startChannel(ADC_RIPPLE_DMA_V);
+}
+
+
+/**
+ * @brief Whether adc_ring_update() correlates the ripple of a V/I pair
+ *
+ * @details Off by default, set by mppt_set_strategy() for the inputs whose
+ *      algorithm reads adc_ring_ripple(). Only the MPPT pairs can be
+ *      correlated; the battery's is never needed. A pair switched off reads
+ *      as having no ripple.
+ *
+ * @param soc SOC number of the pair, the same on both ADCs
+ */
+void adc_ring_set_ripple(ADC_SOCNumber soc, bool enabled) {
+    uint32_t ch = soc - ADC_RING_FIRST_SOC;
+
+    if(ch >= ADC_RING_MPPT_CHANNELS) {
+        return;
+    }
+    adc_ring_ripple_enabled[ch] = enabled;
+    if(enabled == false) {
+        adc_ring_ripple_sums[ch] = adc_ring_no_ripple;
+    }
+}
+
+
+/**********************************************************
+ *                      G E T S
+ **********************************************************/
+
+/**
+ * @brief Correlates one V/I pair's turn-on samples with the switching
+ *
+ * @details One pass over a turn-on block, each sample less the pair's
+ *      block mean of the same switching periods. A deviation needs 17 bits,
+ *      the sums 24. Public for the kernel bench.
+ *
+ * @param v_mean Block means, in ring result counts
+ */
+void adc_ring_correlate(AdcRingRipple_t * ripple, const volatile uint16_t * v_samples,
+                        const volatile uint16_t * i_samples, uint16_t v_mean, uint16_t i_mean) {
+    int32_t v = 0;
+    int32_t i = 0;
+    uint32_t n;
+
+    for(n = 0; n < ADC_RIPPLE_BLOCK; n++) {
+        v += ((int32_t)v_samples[n] << ADC_OVERSAMPLE_BITS) - (int32_t)v_mean;
+        i += ((int32_t)i_samples[n] << ADC_OVERSAMPLE_BITS) - (int32_t)i_mean;
+    }
+    ripple->v = v;
+    ripple->i = i;
+}
+
+/**
+ * @brief Correlates the turn-on block of the same switching periods as a
+ *      pair block, for the pairs adc_ring_set_ripple() switched on
+ *
+ * @details Turn-on block n ends a few periods before pair block n, so it is
+ *      complete whenever the pair block is. Once the DMA has finished the
+ *      next one it is filling block n's half again, and the block is
+ *      missed: no ripple until the next.
+ */
+static void adc_ring_correlate_block(uint32_t block) {
+    uint32_t first = ((block - 1U) & 1U) * ADC_RIPPLE_BLOCK;
+    bool correlated = false;
+    uint32_t ch;
+
+    for(ch = 0; ch < ADC_RING_MPPT_CHANNELS; ch++) {
+        if(adc_ring_ripple_enabled[ch] == false) {
+            continue;
+        }
+        adc_ring_correlate(&adc_ring_ripple_sums[ch], &adc_ripple_ring[ADC_RING_V][ch][first],
+                           &adc_ripple_ring[ADC_RING_I][ch][first],
+                           adc_ring_mean[ADC_RING_V][ch], adc_ring_mean[ADC_RING_I][ch]);
+        correlated = true;
+    }
+    if((correlated == true) && ((adc_ring_stats.ripple_blocks - block) > 1U)) {
+        for(ch = 0; ch < ADC_RING_MPPT_CHANNELS; ch++) {
+            adc_ring_ripple_sums[ch] = adc_ring_no_ripple;
+        }
+        adc_ring_stats.ripple_misses++;
+    }
+}
+
+/**
+ * @brief Averages the newest complete block of every channel
+ *
+ * @details Cheap to call more than once per block: nothing changes until
+ *      the DMA completes another one. Blocks completed since the previous
+ *      call that were never averaged count as overruns, as does a block
+ *      the DMA came back to while it was being summed (which is retried).
+ *      The first and last ADC_RING_HALF samples are also summed apart, for
+ *      adc_ring_drift(). The turn-on samples of the pairs
+ *      adc_ring_set_ripple() switched on are correlated for adc_ring_ripple().
+ */
+void adc_ring_update(void) {
+    uint32_t block = adc_ring_stats.blocks;
+    uint32_t ring;
+    uint32_t ch;
+    uint32_t n;
+
+    if((block == 0) || (block == adc_ring_read_block)) {
+        return;
+    }
+
+    for(;;) {
+        uint32_t first = ((block - 1U) & 1U) * ADC_RING_BLOCK;
+
+        for(ring = 0; ring < ADC_RING_ADCS; ring++) {
+            for(ch = 0; ch < ADC_RING_CHANNELS; ch++) {
+                const volatile uint16_t * samples = &adc_ring[ring][ch][first];
+                uint32_t head = 0;
+                uint32_t tail = 0;
+                uint32_t sum;
+                int32_t drift;
+                for(n = 0; n < ADC_RING_HALF; n++) {
+                    head += samples[n];
+                }
+                sum = head;
+                for(; n < (ADC_RING_BLOCK - ADC_RING_HALF); n++) {
+                    sum += samples[n];
+                }
+                for(; n < ADC_RING_BLOCK; n++) {
+                    tail += samples[n];
+                }
+                sum += tail;
+                sum <<= ADC_OVERSAMPLE_BITS;
+                adc_ring_mean[ring][ch] = (uint16_t)((sum + (ADC_RING_BLOCK / 2U)) / ADC_RING_BLOCK);
+                drift = (((int32_t)tail - (int32_t)head) * (int32_t)ADC_RING_COUNTS_PER_LSB) / (int32_t)ADC_RING_HALF;
+                drift = (drift > INT16_MAX) ? INT16_MAX : ((drift < -INT16_MAX) ? -INT16_MAX : drift);
+                adc_ring_drift_mean[ring][ch] = (int16_t)drift;
+            }
+        }
+        adc_ring_correlate_block(block);
+
+        if(adc_ring_stats.blocks == block) {
+            break;
+        }
+        adc_ring_stats.overruns++;
+        block = adc_ring_stats.blocks;
+    }
+
+    if((adc_ring_read_block != 0) && ((block - adc_ring_read_block) > 1U)) {
+        adc_ring_stats.overruns += block - adc_ring_read_block - 1U;
+    }
+    adc_ring_read_block = block;
+}
+
+/**
+ * @brief Block average of a ring channel as of the last adc_ring_update()
+ *
+ * @return Mean ADC code in 1/2^ADC_OVERSAMPLE_BITS LSB, rounded
+ */
+uint16_t adc_ring_result(uint32_t result_base, ADC_SOCNumber soc) {
+    uint32_t ring = (result_base == ADC_PAIR_V_RESULT) ? ADC_RING_V : ADC_RING_I;
+    return adc_ring_mean[ring][soc - ADC_RING_FIRST_SOC];
+}
+
+/**
+ * @brief How far a ring channel moved across the block of adc_ring_result()
+ *
+ * @return Mean of the last ADC_RING_HALF samples less the mean of the first,
+ *      in 1/2^ADC_OVERSAMPLE_BITS LSB
+ */
+int16_t adc_ring_drift(uint32_t result_base, ADC_SOCNumber soc) {
+    uint32_t ring = (result_base == ADC_PAIR_V_RESULT) ? ADC_RING_V : ADC_RING_I;
+    return adc_ring_drift_mean[ring][soc - ADC_RING_FIRST_SOC];
+}
+
+/**
+ * @brief Turn-on ripple of a V/I pair across the block of adc_ring_result()
+ *
+ * @param soc SOC number of the pair, the same on both ADCs
+ */
+const AdcRingRipple_t * adc_ring_ripple(ADC_SOCNumber soc) {
+    uint32_t ch = soc - ADC_RING_FIRST_SOC;
+
+    return (ch < ADC_RING_MPPT_CHANNELS) ? &adc_ring_ripple_sums[ch] : &adc_ring_no_ripple;
+}
+
+const AdcRingStats_t * get_adc_ring_stats(void) {
+    return (const AdcRingStats_t *)&adc_ring_stats;
+}
+
+
+/**********************************************************
+ *                  I N T E R R U P T S
+ **********************************************************/
+
+/**
+ * @brief End of a block: aim the next transfers at the other block
+ *
+ * @details The new addresses are only shadowed here; the DMA loads them at
+ *      the start of the next transfer, one group of pairs away.
+ */
+__interrupt void dma_adc_ring_irq(void) {
+    uint32_t first;
+
+    TRACE_START(Trace_ADC_Ring);
+    adc_ring_stats.blocks++;
+    first = (adc_ring_stats.blocks & 1U) * ADC_RING_BLOCK;
+    DMA_configAddresses(ADC_RING_DMA_I, &adc_ring[ADC_RING_I][0][first], ADC_RING_SRC(ADC_PAIR_I_RESULT));
+    DMA_configAddresses(ADC_RING_DMA_V, &adc_ring[ADC_RING_V][0][first], ADC_RING_SRC(ADC_PAIR_V_RESULT));
+    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP7);
+    TRACE_END(Trace_ADC_Ring);
+}
+
+/**
+ * @brief End of a turn-on block: aim the next transfers at the other block
+ */
+__interrupt void dma_adc_ripple_irq(void) {
+    uint32_t first;
+
+    TRACE_START(Trace_ADC_Ripple);
+    adc_ring_stats.ripple_blocks++;
+    first = (adc_ring_stats.ripple_blocks & 1U) * ADC_RIPPLE_BLOCK;
+    DMA_configAddresses(ADC_RIPPLE_DMA_I, &adc_ripple_ring[ADC_RING_I][0][first], ADC_RIPPLE_SRC(ADC_PAIR_I_RESULT));
+    DMA_configAddresses(ADC_RIPPLE_DMA_V, &adc_ripple_ring[ADC_RING_V][0][first], ADC_RIPPLE_SRC(ADC_PAIR_V_RESULT));
+    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP7);
+    TRACE_END(Trace_ADC_Ripple);
+}
@@ -29,215 +29,279 @@ static float epwm7_duty_cycle;
 static float epwm8_duty_cycle;
 
 
-// initEPWMGPIO - Configure ePWM GPIO
-void initEPWMGPIO(void) {
-//     Disable pull up on GPIO 0 and GPIO 2 and configure them as PWM1A and PWM2A output respectively.
-
-//    /* 5V Buck */
-    GPIO_setPadConfig(BUCK_5V_HI_PWM, GPIO_PIN_TYPE_STD);
-    GPIO_setPadConfig(BUCK_5V_LI_PWM, GPIO_PIN_TYPE_STD);
-    GPIO_setPinConfig(GPIO_14_EPWM8A);
-    GPIO_setPinConfig(GPIO_15_EPWM8B);
-
-    /* 3V3 Buck */
-    GPIO_setPadConfig(BUCK_3V3_HI_PWM, GPIO_PIN_TYPE_STD);
-    GPIO_setPadConfig(BUCK_3V3_LI_PWM, GPIO_PIN_TYPE_STD);
-    GPIO_setPinConfig(GPIO_0_EPWM1A);
-    GPIO_setPinConfig(GPIO_1_EPWM1B);
-
-    /* MPPT1 */
-    GPIO_setPadConfig(MPPT_1_HI_PWM, GPIO_PIN_TYPE_STD);
-    GPIO_setPadConfig(MPPT_1_LI_PWM, GPIO_PIN_TYPE_STD);
-    GPIO_setPinConfig(GPIO_0_EPWM1A);
-    GPIO_setPinConfig(GPIO_1_EPWM1B);
-
-    /* MPPT2 */
-    GPIO_setPadConfig(MPPT_2_HI_PWM, GPIO_PIN_TYPE_STD);
-    GPIO_setPadConfig(MPPT_2_LI_PWM, GPIO_PIN_TYPE_STD);
-    GPIO_setPinConfig(GPIO_2_EPWM2A);
-    GPIO_setPinConfig(GPIO_3_EPWM2B);
-}
+/**
+ * The converters' ePWM modules. MPPT_1_PWM is the sync master: its SYNCOUT
+ * at counter zero reaches EPWM2 (MPPT_2_PWM) on the device, and EPWM7
+ * (BUCK_3V3_PWM) through SYNCSELECT, which passes it on to EPWM8
+ * (BUCK_5V_PWM). At every sync pulse the others load their phase, so the
+ * four turn on a quarter period apart and their input and battery current
+ * pulses interleave instead of adding up.
+ */
+static const EpwmConfig_t epwm_configs[] = {
+    {
+        .base = MPPT_1_PWM,
+        .clock = SYSCTL_PERIPH_CLK_EPWM1,
+        .pin_hi = MPPT_1_HI_PWM,
+        .pin_lo = MPPT_1_LI_PWM,
+        .pin_hi_config = GPIO_0_EPWM1A,
+        .pin_lo_config = GPIO_1_EPWM1B,
+        .frequency = SWITCHING_FREQUENCY,
+        .phase = MPPT_1_PWM_PHASE,
+        .sync_master = true,
+        .sync_out = EPWM_SYNC_OUT_PULSE_ON_COUNTER_ZERO,
+        .dead_band_rising = 0x2000,
+        .dead_band_falling = 0x2000,
+        .hr_mep_step = 55,
+        .hr_period = 0x6D
+    },
+    {
+        .base = MPPT_2_PWM,
+        .clock = SYSCTL_PERIPH_CLK_EPWM2,
+        .pin_hi = MPPT_2_HI_PWM,
+        .pin_lo = MPPT_2_LI_PWM,
+        .pin_hi_config = GPIO_2_EPWM2A,
+        .pin_lo_config = GPIO_3_EPWM2B,
+        .frequency = SWITCHING_FREQUENCY,
+        .phase = MPPT_2_PWM_PHASE,
+        .sync_master = false,
+        .sync_out = EPWM_SYNC_OUT_PULSE_DISABLED,
+        .dead_band_rising = 0x2000,
+        .dead_band_falling = 0x2000,
+        .hr_mep_step = 55,
+        .hr_period = 0x6D
+    },
+    {
+        .base = BUCK_3V3_PWM,
+        .clock = SYSCTL_PERIPH_CLK_EPWM7,
+        .pin_hi = BUCK_3V3_HI_PWM,
+        .pin_lo = BUCK_3V3_LI_PWM,
+        .pin_hi_config = GPIO_12_EPWM7A,
+        .pin_lo_config = GPIO_13_EPWM7B,
+        .frequency = SWITCHING_FREQUENCY,
+        .phase = BUCK_3V3_PWM_PHASE,
+        .sync_master = false,
+        .sync_out = EPWM_SYNC_OUT_PULSE_ON_EPWMxSYNCIN,     // on to EPWM8
+        .dead_band_rising = 0x2000,
+        .dead_band_falling = 0x2000,
+        .hr_mep_step = 55,
+        .hr_period = 0x6D
+    },
+    {
+        .base = BUCK_5V_PWM,
+        .clock = SYSCTL_PERIPH_CLK_EPWM8,
+        .pin_hi = BUCK_5V_HI_PWM,
+        .pin_lo = BUCK_5V_LI_PWM,
+        .pin_hi_config = GPIO_14_EPWM8A,
+        .pin_lo_config = GPIO_15_EPWM8B,
+        .frequency = SWITCHING_FREQUENCY,
+        .phase = BUCK_5V_PWM_PHASE,
+        .sync_master = false,
+        .sync_out = EPWM_SYNC_OUT_PULSE_DISABLED,
+        .dead_band_rising = 0x2000,
+        .dead_band_falling = 0x2000,
+        .hr_mep_step = 55,
+        .hr_period = 0x6D
+    }
+};
 
-// initEPWM1 - Configure ePWM1
-void initEPWM1(void) {
-    EALLOW;
+#define EPWM_CONFIG_COUNT   (sizeof(epwm_configs) / sizeof(epwm_configs[0]))
 
-    SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_EPWM1);
-    SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_HRPWM);
-    SysCtl_disablePeripheral(SYSCTL_PERIPH_CLK_TBCLKSYNC);  // Disable sync(Freeze clock to PWM as well)
 
-    EPWM_setActionQualifierContSWForceShadowMode(EPWM1_BASE, EPWM_AQ_SW_IMMEDIATE_LOAD);
-    EPWM_setPhaseShift(EPWM1_BASE, 0);
+/**
+ * @brief Counter value a module loads at the sync pulse, so that it turns on
+ *      phase degrees after the master
+ *
+ * @details The master is at zero when it sends the pulse, and the module
+ *      loads it EPWM_SYNC_DELAY TBCLKs later.
+ */
+static uint16_t epwm_phase_count(uint16_t period, uint16_t phase) {
+    uint32_t counts = (uint32_t)period + 1U;
+    uint32_t lag = (counts * (uint32_t)(phase % 360U)) / 360U;
+
+    return (uint16_t)((counts - lag + EPWM_SYNC_DELAY) % counts);
+}
 
-    EPWM_setTimeBaseCounterMode(EPWM1_BASE, EPWM_COUNTER_MODE_UP);
-    EPWM_disablePhaseShiftLoad(EPWM1_BASE);
-    EPWM_setSyncOutPulseMode(EPWM1_BASE, EPWM_SYNC_OUT_PULSE_DISABLED);
-    EPWM_setClockPrescaler(EPWM1_BASE, EPWM_CLOCK_DIVIDER_1, EPWM_HSCLOCK_DIVIDER_1);
-    EPWM_setEmulationMode(EPWM1_BASE, EPWM_EMULATION_FREE_RUN);
+/**
+ * @brief Configures one ePWM module and its pins, with TBCLKSYNC off
+ */
+static void init_epwm(const EpwmConfig_t * config) {
+    uint32_t base = config->base;
+    uint16_t period = (uint16_t)(CLOCK_FREQUENCY / config->frequency);
+    uint16_t phase = epwm_phase_count(period, config->phase);
+
+    GPIO_setPadConfig(config->pin_hi, GPIO_PIN_TYPE_STD);
+    GPIO_setPadConfig(config->pin_lo, GPIO_PIN_TYPE_STD);
+    GPIO_setPinConfig(config->pin_hi_config);
+    GPIO_setPinConfig(config->pin_lo_config);
+
+    SysCtl_enablePeripheral(config->clock);
+
+    EPWM_setActionQualifierContSWForceShadowMode(base, EPWM_AQ_SW_IMMEDIATE_LOAD);
+
+    // Time-base, and its place in the sync chain
+    EPWM_setTimeBaseCounterMode(base, EPWM_COUNTER_MODE_UP);
+    if(config->sync_master == true) {
+        EPWM_disablePhaseShiftLoad(base);
+        EPWM_setPhaseShift(base, 0);
+        phase = 0;
+    }
+    else {
+        EPWM_setCountModeAfterSync(base, EPWM_COUNT_MODE_UP_AFTER_SYNC);
+        EPWM_setPhaseShift(base, phase);
+        EPWM_enablePhaseShiftLoad(base);
+    }
+    EPWM_setSyncOutPulseMode(base, config->sync_out);
+    EPWM_setClockPrescaler(base, EPWM_CLOCK_DIVIDER_1, EPWM_HSCLOCK_DIVIDER_1);
+    EPWM_setEmulationMode(base, EPWM_EMULATION_FREE_RUN);
 
-    EPWM_setCounterCompareShadowLoadMode(EPWM1_BASE, EPWM_COUNTER_COMPARE_A, EPWM_COMP_LOAD_ON_CNTR_ZERO);
+    EPWM_setCounterCompareShadowLoadMode(base, EPWM_COUNTER_COMPARE_A, EPWM_COMP_LOAD_ON_CNTR_ZERO);
+    EPWM_setCounterCompareShadowLoadMode(base, EPWM_COUNTER_COMPARE_C, EPWM_COMP_LOAD_ON_CNTR_ZERO);
+    EPWM_setCounterCompareShadowLoadMode(base, EPWM_COUNTER_COMPARE_D, EPWM_COMP_LOAD_ON_CNTR_ZERO);
 
-    EPWM_setActionQualifierAction(EPWM1_BASE, EPWM_AQ_OUTPUT_A, EPWM_AQ_OUTPUT_HIGH, EPWM_AQ_OUTPUT_ON_TIMEBASE_PERIOD);
-    EPWM_setActionQualifierAction(EPWM1_BASE, EPWM_AQ_OUTPUT_A, EPWM_AQ_OUTPUT_LOW, EPWM_AQ_OUTPUT_ON_TIMEBASE_UP_CMPA);
+    EPWM_setActionQualifierAction(base, EPWM_AQ_OUTPUT_A, EPWM_AQ_OUTPUT_HIGH, EPWM_AQ_OUTPUT_ON_TIMEBASE_PERIOD);
+    EPWM_setActionQualifierAction(base, EPWM_AQ_OUTPUT_A, EPWM_AQ_OUTPUT_LOW, EPWM_AQ_OUTPUT_ON_TIMEBASE_UP_CMPA);
 
-    HRPWM_setMEPEdgeSelect(EPWM1_BASE, HRPWM_CHANNEL_A, HRPWM_MEP_CTRL_FALLING_EDGE);
-    HRPWM_setMEPControlMode(EPWM1_BASE, HRPWM_CHANNEL_A, HRPWM_MEP_DUTY_PERIOD_CTRL);
-    HRPWM_setCounterCompareShadowLoadEvent(EPWM1_BASE, HRPWM_CHANNEL_A, HRPWM_LOAD_ON_CNTR_ZERO);
-    HRPWM_disableAutoConversion(EPWM1_BASE);
-    HRPWM_disablePeriodControl(EPWM1_BASE);
+    HRPWM_setMEPEdgeSelect(base, HRPWM_CHANNEL_A, HRPWM_MEP_CTRL_FALLING_EDGE);
+    HRPWM_setMEPControlMode(base, HRPWM_CHANNEL_A, HRPWM_MEP_DUTY_PERIOD_CTRL);
+    HRPWM_setCounterCompareShadowLoadEvent(base, HRPWM_CHANNEL_A, HRPWM_LOAD_ON_CNTR_ZERO);
+    HRPWM_disableAutoConversion(base);
+    HRPWM_disablePeriodControl(base);
 
     // Dead Band
-    EPWM_setDeadBandCounterClock(EPWM1_BASE, EPWM_DB_COUNTER_CLOCK_FULL_CYCLE);
-    EPWM_setRisingEdgeDeadBandDelayInput(EPWM1_BASE, EPWM_DB_INPUT_EPWMA);
+    EPWM_setRisingEdgeDeadBandDelayInput(base, EPWM_DB_INPUT_EPWMA);
 
-    HRPWM_setDeadbandMEPEdgeSelect(EPWM1_BASE, HRPWM_DB_MEP_CTRL_RED_FED);
-    HRPWM_setRisingEdgeDelayLoadMode(EPWM1_BASE, HRPWM_LOAD_ON_CNTR_ZERO_PERIOD);
-    HRPWM_setFallingEdgeDelayLoadMode(EPWM1_BASE, HRPWM_LOAD_ON_CNTR_ZERO_PERIOD);
+    HRPWM_setDeadbandMEPEdgeSelect(base, HRPWM_DB_MEP_CTRL_RED_FED);
+    HRPWM_setRisingEdgeDelayLoadMode(base, HRPWM_LOAD_ON_CNTR_ZERO_PERIOD);
+    HRPWM_setFallingEdgeDelayLoadMode(base, HRPWM_LOAD_ON_CNTR_ZERO_PERIOD);
 
-    EPWM_setDeadBandOutputSwapMode(EPWM1_BASE, EPWM_DB_OUTPUT_A, true);
-    EPWM_setDeadBandDelayMode(EPWM1_BASE, EPWM_DB_FED, true);
+    EPWM_setDeadBandOutputSwapMode(base, EPWM_DB_OUTPUT_A, true);
+    EPWM_setDeadBandDelayMode(base, EPWM_DB_FED, true);
 
-    EPWM_setDeadBandDelayPolarity(EPWM1_BASE, EPWM_DB_FED, EPWM_DB_POLARITY_ACTIVE_HIGH);
+    EPWM_setDeadBandDelayPolarity(base, EPWM_DB_FED, EPWM_DB_POLARITY_ACTIVE_HIGH);
 
-    EPWM_setDeadBandCounterClock(EPWM1_BASE, EPWM_DB_COUNTER_CLOCK_HALF_CYCLE);
-    EPWM_setRisingEdgeDelayCount(EPWM1_BASE, 0x2000);
-    EPWM_setFallingEdgeDelayCount(EPWM1_BASE, 0x2000);
+    EPWM_setDeadBandCounterClock(base, EPWM_DB_COUNTER_CLOCK_HALF_CYCLE);
+    EPWM_setRisingEdgeDelayCount(base, config->dead_band_rising);
+    EPWM_setFallingEdgeDelayCount(base, config->dead_band_falling);
 
     // Invert ePWMxA signal
-    HRPWM_setChannelBOutputPath(EPWM1_BASE, HRPWM_OUTPUT_ON_B_INV_A);    // ePWMxB is inverse of ePWMxA
+    HRPWM_setChannelBOutputPath(base, HRPWM_OUTPUT_ON_B_INV_A);    // ePWMxB is inverse of ePWMxA
 
     // initialize PWM period
-    HRPWM_setMEPStep(EPWM1_BASE, 55);
-    HRPWM_setCounterCompareValue(EPWM1_BASE, HRPWM_COUNTER_COMPARE_A, 0);
-    HRPWM_setTimeBasePeriod(EPWM1_BASE, 0x6D);
+    HRPWM_setMEPStep(base, config->hr_mep_step);
+    HRPWM_setCounterCompareValue(base, HRPWM_COUNTER_COMPARE_A, 0);
+    HRPWM_setTimeBasePeriod(base, config->hr_period);
 
+    EPWM_setTimeBasePeriod(base, period);
+    EPWM_setCounterCompareValue(base, EPWM_COUNTER_COMPARE_A, 0);
 
-    EPWM_setTimeBasePeriod(EPWM1_BASE, PERIOD);
-    EPWM_setCounterCompareValue(EPWM1_BASE, EPWM_COUNTER_COMPARE_A, 0);
-    EDIS;
-
-    SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_TBCLKSYNC);   // Enable sync and clock to PWM
-    EPWM_setTimeBaseCounter(EPWM1_BASE, 0);
+    // start where the first sync pulse will put it
+    EPWM_setTimeBaseCounter(base, phase);
 }
 
+/**************************************************
+ * init_epwms
+ *
+ * @brief Configures every converter's ePWM from epwm_configs[]
+ *
+ * @details The time-base clocks are stopped while the modules are set up,
+ *      so the counters start together, already at their phases.
+ *      Every converter starts at 0% duty cycle.
+ *
+ **************************************************/
+void init_epwms(void) {
+    uint32_t n;
 
-void initEPWM3(void) {
     EALLOW;
-
-    SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_EPWM3);
     SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_HRPWM);
     SysCtl_disablePeripheral(SYSCTL_PERIPH_CLK_TBCLKSYNC);  // Disable sync(Freeze clock to PWM as well)
 
-    EPWM_setActionQualifierContSWForceShadowMode(EPWM3_BASE, EPWM_AQ_SW_IMMEDIATE_LOAD);
-    EPWM_setPhaseShift(EPWM3_BASE, 0);
-
-    EPWM_setTimeBaseCounterMode(EPWM3_BASE, EPWM_COUNTER_MODE_UP);
-    EPWM_disablePhaseShiftLoad(EPWM3_BASE);
-    EPWM_setSyncOutPulseMode(EPWM3_BASE, EPWM_SYNC_OUT_PULSE_DISABLED);
-    EPWM_setClockPrescaler(EPWM3_BASE, EPWM_CLOCK_DIVIDER_1, EPWM_HSCLOCK_DIVIDER_1);
-    EPWM_setEmulationMode(EPWM3_BASE, EPWM_EMULATION_FREE_RUN);
-
-    EPWM_setCounterCompareShadowLoadMode(EPWM3_BASE, EPWM_COUNTER_COMPARE_A, EPWM_COMP_LOAD_ON_CNTR_ZERO);
-
-    EPWM_setActionQualifierAction(EPWM3_BASE, EPWM_AQ_OUTPUT_A, EPWM_AQ_OUTPUT_HIGH, EPWM_AQ_OUTPUT_ON_TIMEBASE_PERIOD);
-    EPWM_setActionQualifierAction(EPWM3_BASE, EPWM_AQ_OUTPUT_A, EPWM_AQ_OUTPUT_LOW, EPWM_AQ_OUTPUT_ON_TIMEBASE_UP_CMPA);
-
-    HRPWM_setMEPEdgeSelect(EPWM3_BASE, HRPWM_CHANNEL_A, HRPWM_MEP_CTRL_FALLING_EDGE);
-    HRPWM_setMEPControlMode(EPWM3_BASE, HRPWM_CHANNEL_A, HRPWM_MEP_DUTY_PERIOD_CTRL);
-    HRPWM_setCounterCompareShadowLoadEvent(EPWM3_BASE, HRPWM_CHANNEL_A, HRPWM_LOAD_ON_CNTR_ZERO);
-    HRPWM_disableAutoConversion(EPWM3_BASE);
-    HRPWM_disablePeriodControl(EPWM3_BASE);
-
-
-    HRPWM_setMEPStep(EPWM3_BASE, 55);
-    HRPWM_setCounterCompareValue(EPWM3_BASE, HRPWM_COUNTER_COMPARE_A, 0);
-    HRPWM_setTimeBasePeriod(EPWM3_BASE, 0x6D);
-
-
-    EPWM_setTimeBasePeriod(EPWM3_BASE, PERIOD);
-    EPWM_setCounterCompareValue(EPWM3_BASE, EPWM_COUNTER_COMPARE_A, 0);
+    for(n = 0; n < EPWM_CONFIG_COUNT; n++) {
+        init_epwm(&epwm_configs[n]);
+    }
+    // EPWM2 takes EPWM1's SYNCOUT and EPWM8 EPWM7's on the device, EPWM7 is selected
+    SysCtl_setSyncInputConfig(SYSCTL_SYNC_IN_EPWM7, SYSCTL_SYNC_IN_SRC_EPWM1SYNCOUT);
     EDIS;
 
     SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_TBCLKSYNC);   // Enable sync and clock to PWM
-    EPWM_setTimeBaseCounter(EPWM3_BASE, 0);
-}
-
-void initEPWM(uint32_t epwm_base) {
-    EALLOW;
 
-    // enable correct clock
-    switch(epwm_base) {
-        case(EPWM1_BASE): SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_EPWM1); break;
-        case(EPWM2_BASE): SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_EPWM2); break;
-        case(EPWM3_BASE): SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_EPWM3); break;
-        case(EPWM4_BASE): SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_EPWM4); break;
-        case(EPWM5_BASE): SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_EPWM5); break;
-        case(EPWM6_BASE): SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_EPWM6); break;
-        case(EPWM7_BASE): SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_EPWM7); break;
-        case(EPWM8_BASE): SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_EPWM8); break;
+    for(n = 0; n < EPWM_CONFIG_COUNT; n++) {
+        change_pwm_duty_cycle(epwm_configs[n].base, 0.0);
     }
+}
 
-    EALLOW;
-
-    SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_EPWM1);
-    SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_HRPWM);
-    SysCtl_disablePeripheral(SYSCTL_PERIPH_CLK_TBCLKSYNC);  // Disable sync(Freeze clock to PWM as well)
-
-    EPWM_setActionQualifierContSWForceShadowMode(epwm_base, EPWM_AQ_SW_IMMEDIATE_LOAD);
-    EPWM_setPhaseShift(epwm_base, 0);
-
-    EPWM_setTimeBaseCounterMode(epwm_base, EPWM_COUNTER_MODE_UP);
-    EPWM_disablePhaseShiftLoad(epwm_base);
-    EPWM_setSyncOutPulseMode(epwm_base, EPWM_SYNC_OUT_PULSE_DISABLED);
-    EPWM_setClockPrescaler(epwm_base, EPWM_CLOCK_DIVIDER_1, EPWM_HSCLOCK_DIVIDER_1);
-    EPWM_setEmulationMode(epwm_base, EPWM_EMULATION_FREE_RUN);
-
-    EPWM_setCounterCompareShadowLoadMode(epwm_base, EPWM_COUNTER_COMPARE_A, EPWM_COMP_LOAD_ON_CNTR_ZERO);
-
-    EPWM_setActionQualifierAction(epwm_base, EPWM_AQ_OUTPUT_A, EPWM_AQ_OUTPUT_HIGH, EPWM_AQ_OUTPUT_ON_TIMEBASE_PERIOD);
-    EPWM_setActionQualifierAction(epwm_base, EPWM_AQ_OUTPUT_A, EPWM_AQ_OUTPUT_LOW, EPWM_AQ_OUTPUT_ON_TIMEBASE_UP_CMPA);
-
-    HRPWM_setMEPEdgeSelect(epwm_base, HRPWM_CHANNEL_A, HRPWM_MEP_CTRL_FALLING_EDGE);
-    HRPWM_setMEPControlMode(epwm_base, HRPWM_CHANNEL_A, HRPWM_MEP_DUTY_PERIOD_CTRL);
-    HRPWM_setCounterCompareShadowLoadEvent(epwm_base, HRPWM_CHANNEL_A, HRPWM_LOAD_ON_CNTR_ZERO);
-    HRPWM_disableAutoConversion(epwm_base);
-    HRPWM_disablePeriodControl(epwm_base);
-
-    // Dead Band
-    EPWM_setDeadBandCounterClock(epwm_base, EPWM_DB_COUNTER_CLOCK_FULL_CYCLE);
-    EPWM_setRisingEdgeDeadBandDelayInput(epwm_base, EPWM_DB_INPUT_EPWMA);
-
-    HRPWM_setDeadbandMEPEdgeSelect(epwm_base, HRPWM_DB_MEP_CTRL_RED_FED);
-    HRPWM_setRisingEdgeDelayLoadMode(epwm_base, HRPWM_LOAD_ON_CNTR_ZERO_PERIOD);
-    HRPWM_setFallingEdgeDelayLoadMode(epwm_base, HRPWM_LOAD_ON_CNTR_ZERO_PERIOD);
-
-    EPWM_setDeadBandOutputSwapMode(epwm_base, EPWM_DB_OUTPUT_A, true);
-    EPWM_setDeadBandDelayMode(epwm_base, EPWM_DB_FED, true);
-
-    EPWM_setDeadBandDelayPolarity(epwm_base, EPWM_DB_FED, EPWM_DB_POLARITY_ACTIVE_HIGH);
-
-    EPWM_setDeadBandCounterClock(epwm_base, EPWM_DB_COUNTER_CLOCK_HALF_CYCLE);
-    EPWM_setRisingEdgeDelayCount(epwm_base, 0x2000);
-    EPWM_setFallingEdgeDelayCount(epwm_base, 0x2000);
-
-    // Invert ePWMxA signal
-    HRPWM_setChannelBOutputPath(epwm_base, HRPWM_OUTPUT_ON_B_INV_A);    // ePWMxB is inverse of ePWMxA
-
-    // initialize PWM period
-    HRPWM_setMEPStep(epwm_base, 55);
-    HRPWM_setCounterCompareValue(epwm_base, HRPWM_COUNTER_COMPARE_A, 0);
-    HRPWM_setTimeBasePeriod(epwm_base, 0x6D);
-
-
-    EPWM_setTimeBasePeriod(epwm_base, PERIOD);
-    EPWM_setCounterCompareValue(epwm_base, EPWM_COUNTER_COMPARE_A, 0);
-    EDIS;
+/**
+ * @brief Starts ADC conversions from an ePWM's time-base
+ *
+ * @details SOCA is generated when the counter reaches zero, once every
+ *      SWITCHING_FREQUENCY / frequency switching periods.
+ *
+ * @param epwm_base The base address of an ePWM module
+ * @param frequency Sample rate in Hz, SWITCHING_FREQUENCY / 15 up to SWITCHING_FREQUENCY
+ */
+void init_epwm_adc_trigger(uint32_t epwm_base, uint32_t frequency) {
+    EPWM_disableADCTrigger(epwm_base, EPWM_SOC_A);
+    EPWM_setADCTriggerSource(epwm_base, EPWM_SOC_A, EPWM_SOC_TBCTR_ZERO);
+    EPWM_setADCTriggerEventPrescale(epwm_base, EPWM_SOC_A, (SWITCHING_FREQUENCY / frequency));
+    EPWM_enableADCTrigger(epwm_base, EPWM_SOC_A);
+}
 
-    SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_TBCLKSYNC);   // Enable sync and clock to PWM
-    EPWM_setTimeBaseCounter(epwm_base, 0);
+/**
+ * @brief Starts ADC conversions in the middle of the on- or off-time
+ *
+ * @details In up-count mode the high side is on from counter zero to CMPA,
+ *      so the inductor current ramp crosses its average at CMPA / 2 (CMPC)
+ *      and (CMPA + PERIOD) / 2 (CMPD); change_pwm_duty_cycle() keeps both
+ *      in step with the duty cycle. The SOC fires on every prescale'th
+ *      switching period, starting with the event'th.
+ *
+ *      Triggers meant to land in different periods must be set up with
+ *      TBCLKSYNC disabled so their event counters start together.
+ *
+ * @param epwm_base The base address of an ePWM module
+ * @param soc_type EPWM_SOC_A or EPWM_SOC_B
+ * @param point Sample_Mid_On_Time or Sample_Mid_Off_Time
+ * @param prescale Switching periods per SOC, 1 - 15
+ * @param event Switching period of the first SOC, 1 - prescale
+ */
+void init_epwm_sample_trigger(uint32_t epwm_base, EPWM_ADCStartOfConversionType soc_type,
+                              eEpwmSamplePoint point, uint16_t prescale, uint16_t event) {
+    EPWM_disableADCTrigger(epwm_base, soc_type);
+    EPWM_setADCTriggerSource(epwm_base, soc_type,
+                             (point == Sample_Mid_On_Time) ? EPWM_SOC_TBCTR_U_CMPC : EPWM_SOC_TBCTR_U_CMPD);
+    EPWM_setADCTriggerEventPrescale(epwm_base, soc_type, prescale);
+    EPWM_enableADCTriggerEventCountInit(epwm_base, soc_type);
+    EPWM_setADCTriggerEventCountInitValue(epwm_base, soc_type, prescale - event);
+    EPWM_forceADCTriggerEventCountInit(epwm_base, soc_type);
+    EPWM_enableADCTrigger(epwm_base, soc_type);
+}
 
-    // initialize to 0% Duty-Cycle
-    change_pwm_duty_cycle(epwm_base, 0.0);
+/**
+ * @brief Starts ADC conversions at another converter's turn-on
+ *
+ * @details For a module switching lag degrees behind that converter, whose
+ *      turn-on is then (360 - lag) degrees into this module's period. SOCB
+ *      fires there, from CMPB, which no converter's duty cycle moves; SOCA
+ *      is left to the module's own samples. Prescale and event as for
+ *      init_epwm_sample_trigger(), and likewise with TBCLKSYNC disabled.
+ *
+ * @param epwm_base The base address of an ePWM module
+ * @param lag [deg] this module's turn-on after the converter's, 1 - 359
+ * @param prescale Switching periods per SOC, 1 - 15
+ * @param event Switching period of the first SOC, 1 - prescale
+ */
+void init_epwm_turn_on_trigger(uint32_t epwm_base, uint16_t lag, uint16_t prescale, uint16_t event) {
+    uint32_t counts = (uint32_t)PERIOD + 1U;
+
+    // the counts epwm_phase_count() shifted the module by
+    EPWM_disableADCTrigger(epwm_base, EPWM_SOC_B);
+    EPWM_setCounterCompareValue(epwm_base, EPWM_COUNTER_COMPARE_B,
+                                (uint16_t)(counts - ((counts * (uint32_t)lag) / 360U)));
+    EPWM_setADCTriggerSource(epwm_base, EPWM_SOC_B, EPWM_SOC_TBCTR_U_CMPB);
+    EPWM_setADCTriggerEventPrescale(epwm_base, EPWM_SOC_B, prescale);
+    EPWM_enableADCTriggerEventCountInit(epwm_base, EPWM_SOC_B);
+    EPWM_setADCTriggerEventCountInitValue(epwm_base, EPWM_SOC_B, prescale - event);
+    EPWM_forceADCTriggerEventCountInit(epwm_base, EPWM_SOC_B);
+    EPWM_enableADCTrigger(epwm_base, EPWM_SOC_B);
 }
 
 void change_pwm_duty_cycle(uint32_t epwm_base, float dc) {
@@ -273,6 +337,10 @@ void change_pwm_duty_cycle(uint32_t epwm_base, float dc) {
 
     new_dc = (uint32_t)(((dc * PERIOD)/ 100.0) * 256.0);
     HRPWM_setCounterCompareValue(epwm_base, HRPWM_COUNTER_COMPARE_A, new_dc);
+
+    // mid on-time and mid off-time sample points, rounded to the nearest count, see init_epwm_sample_trigger()
+    EPWM_setCounterCompareValue(epwm_base, EPWM_COUNTER_COMPARE_C, (uint16_t)((new_dc + 256U) >> 9));
+    EPWM_setCounterCompareValue(epwm_base, EPWM_COUNTER_COMPARE_D, (uint16_t)((new_dc + ((uint32_t)PERIOD << 8) + 256U) >> 9));
 //    HRPWM_setCounterCompareValue(epwm_base, HRPWM_COUNTER_COMPARE_A, ((303 << 8) | 5700));
     //    EPWM_setCounterCompareValue(EPWM1_BASE, EPWM_COUNTER_COMPARE_A, (dc_integer*PERIOD) / 100);
 //    EALLOW;
@@ -10,6 +10,7 @@
 
 #include "src_timers.h"
 #include "src_epwm.h"
+#include "trace.h"
 #include "driverlib.h"
 #include "device.h"
 
@@ -18,7 +19,6 @@
 //static bool system_active = false;
 
 /** control loop active variables */
-static bool pid_active = false;
 static bool mppt_active = false;
 
 
@@ -48,14 +48,6 @@ void init_timer(uint32_t timer_base, uint32_t period) {
  *                  S E T S / G E T S
  **********************************************************/
 
-bool get_pid_active(void) {
-    return pid_active;
-}
-
-void set_pid_active(bool state) {
-    pid_active = state;
-}
-
 bool get_mppt_active(void) {
     return mppt_active;
 }
@@ -72,27 +64,16 @@ __interrupt void cpuTimer0ISR(void) {
     CPUTimer_startTimer(CPUTIMER0_BASE);
 }
 
-/**
- *  Sets off PID control loops
- */
-__interrupt void PID_Timer_ISR(void) {
-#ifdef LED_BRIGHTNESS
-    // change light brightness
-    if(direction) {
-        change_pwm_duty_cycle(get_duty_cycle() + 0.5);
-        if(get_duty_cycle() == 20.0) direction = 0;
-    }
-    else {
-        change_pwm_duty_cycle(get_duty_cycle() - 0.5);
-        if(get_duty_cycle() == 0.0) direction = 1;
-    }
-#endif
-    pid_active = true;
-}
-
 /**
  *  Sets off MPPT control loops
  */
 __interrupt void MPPT_Timer_ISR(void) {
+    TRACE_START(Trace_MPPT_Timer);
+
+    // still set: the main loop missed the previous period
+    if(mppt_active) {
+        TRACE_OVERRUN(Trace_Main_Loop);
+    }
     mppt_active = true;
+    TRACE_END(Trace_MPPT_Timer);
 }
@@ -0,0 +1,50 @@
+/*
+ * trace.c
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "trace.h"
+
+#ifdef USE_TRACE
+
+#pragma DATA_SECTION(trace_buffer, "ramgs1")
+TraceBuffer_t trace_buffer;
+
+/**
+ * @brief Clears trace_buffer and starts TRACE_TIMER free-running
+ *
+ * @details TRACE_TIMER counts down from 0xFFFFFFFF at SYSCLK with its
+ *      interrupt off; trace_now() inverts it, and the modulo-2^32 differences
+ *      stay correct across the 43s wrap.
+ */
+void trace_init(void) {
+    uint32_t n;
+
+    trace_buffer.magic = TRACE_MAGIC;
+    trace_buffer.version = TRACE_VERSION;
+    trace_buffer.sysclk_hz = DEVICE_SYSCLK_FREQ;
+    trace_buffer.task_count = Trace_Task_Count;
+    trace_buffer.ring_size = TRACE_RING_SIZE;
+    trace_buffer.written = 0;
+    for(n = 0; n < Trace_Task_Count; n++) {
+        trace_buffer.stats[n].count = 0;
+        trace_buffer.stats[n].overruns = 0;
+        trace_buffer.stats[n].min = UINT32_MAX;
+        trace_buffer.stats[n].max = 0;
+        trace_buffer.stats[n].total_lo = 0;
+        trace_buffer.stats[n].total_hi = 0;
+        trace_buffer.stats[n].start = 0;
+        trace_buffer.stats[n].reserved = 0;
+    }
+
+    SysCtl_enablePeripheral(TRACE_TIMER_CLK);
+    CPUTimer_setPeriod(TRACE_TIMER, UINT32_MAX);
+    CPUTimer_setPreScaler(TRACE_TIMER, 0);
+    CPUTimer_stopTimer(TRACE_TIMER);
+    CPUTimer_reloadTimerCounter(TRACE_TIMER);
+    CPUTimer_setEmulationMode(TRACE_TIMER, CPUTIMER_EMULATIONMODE_RUNFREE);
+    CPUTimer_startTimer(TRACE_TIMER);
+}
+
+#endif /* USE_TRACE */